@@ -19,6 +19,13 @@ typedef enum
   DMDUtil_LogLevel_ERROR = 2
 } DMDUtil_LogLevel;
 
+typedef enum
+{
+  DMDUtil_QueueOverflowPolicy_DropOldest = 0,
+  DMDUtil_QueueOverflowPolicy_Block = 1,
+  DMDUtil_QueueOverflowPolicy_Coalesce = 2
+} DMDUtil_QueueOverflowPolicy;
+
 typedef void(DMDUTILCALLBACK* DMDUtil_LogCallback)(DMDUtil_LogLevel logLevel, const char* format, va_list args);
 
 typedef void(DMDUTILCALLBACK* DMDUtil_PUPTriggerCallback)(uint16_t id, void* userData);
@@ -86,6 +93,12 @@ class DMDUTILAPI Config
   const char* GetDumpPath() const { return m_dumpPath.c_str(); }
   bool IsDumpZip() const { return m_dumpZip; }
   void SetDumpZip(bool dumpZip) { m_dumpZip = dumpZip; }
+  // Deflate level of zipped dumps, 0 (store) to 9 (best).
+  int GetDumpZipLevel() const { return m_dumpZipLevel; }
+  void SetDumpZipLevel(int dumpZipLevel) { m_dumpZipLevel = dumpZipLevel; }
+  // Flush dumps to the disk after every write.
+  bool IsDumpSync() const { return m_dumpSync; }
+  void SetDumpSync(bool dumpSync) { m_dumpSync = dumpSync; }
   bool IsFilterTransitionalFrames() const { return m_filterTransitionalFrames; }
   void SetFilterTransitionalFrames(bool filterTransitionalFrames)
   {
@@ -132,8 +145,25 @@ class DMDUTILAPI Config
   const char* GetDMDServerAddr() const { return m_dmdServerAddr.c_str(); }
   void SetDMDServerPort(int port) { m_dmdServerPort = port; }
   int GetDMDServerPort() const { return m_dmdServerPort; }
+  void SetDMDServerUnixSocket(const char* path) { m_dmdServerUnixSocket = path; }
+  const char* GetDMDServerUnixSocket() const { return m_dmdServerUnixSocket.c_str(); }
+  void SetDMDServerCompression(bool dmdServerCompression) { m_dmdServerCompression = dmdServerCompression; }
+  bool IsDMDServerCompression() const { return m_dmdServerCompression; }
+  void SetDMDServerDelta(bool dmdServerDelta) { m_dmdServerDelta = dmdServerDelta; }
+  bool IsDMDServerDelta() const { return m_dmdServerDelta; }
+  // 1 is understood by every dmdserver. 2 needs a dmdserver that supports it, compression and delta require it.
+  void SetDMDServerProtocolVersion(int dmdServerProtocolVersion)
+  {
+    m_dmdServerProtocolVersion = dmdServerProtocolVersion;
+  }
+  int GetDMDServerProtocolVersion() const { return m_dmdServerProtocolVersion; }
   void SetLocalDisplaysActive(bool localDisplaysActive) { m_localDisplaysActive = localDisplaysActive; }
   bool IsLocalDisplaysActive() { return m_localDisplaysActive; }
+  DMDUtil_QueueOverflowPolicy GetQueueOverflowPolicy() const { return m_queueOverflowPolicy; }
+  void SetQueueOverflowPolicy(DMDUtil_QueueOverflowPolicy queueOverflowPolicy)
+  {
+    m_queueOverflowPolicy = queueOverflowPolicy;
+  }
   DMDUtil_LogLevel GetLogLevel() const { return m_logLevel; }
   void SetLogLevel(DMDUtil_LogLevel logLevel) { m_logLevel = logLevel; }
   DMDUtil_LogCallback GetLogCallback() const { return m_logCallback; }
@@ -169,6 +199,8 @@ class DMDUTILAPI Config
   bool m_dumpFrames;
   std::string m_dumpPath;
   bool m_dumpZip;
+  bool m_dumpSync;
+  int m_dumpZipLevel;
   bool m_filterTransitionalFrames;
   int m_roundedCorners;
   bool m_zedmd;
@@ -186,6 +218,11 @@ class DMDUTILAPI Config
   bool m_localDisplaysActive;
   std::string m_dmdServerAddr;
   int m_dmdServerPort;
+  std::string m_dmdServerUnixSocket;
+  bool m_dmdServerCompression;
+  bool m_dmdServerDelta;
+  int m_dmdServerProtocolVersion;
+  DMDUtil_QueueOverflowPolicy m_queueOverflowPolicy;
   bool m_pixelcade;
   std::string m_pixelcadeDevice;
   bool m_PIN2DMD;
@@ -14,6 +14,16 @@
 #define DMDUTIL_MAX_NAME_SIZE 16
 #define DMDUTIL_MAX_PATH_SIZE 256
 #define DMDUTIL_MAX_TRANSITIONAL_FRAME_DURATION 25
+#define DMDUTIL_INGEST_QUEUE_SIZE 32  // Must be a power of 2!
+
+#define DMDUTIL_FRAME_FLAG_HAS_DATA 0x01
+#define DMDUTIL_FRAME_FLAG_HAS_SEG_DATA 0x02
+#define DMDUTIL_FRAME_FLAG_HAS_SEG_DATA2 0x04
+#define DMDUTIL_FRAME_FLAG_PATHS 0x08       // A PathsHeader follows the FrameHeader
+#define DMDUTIL_FRAME_FLAG_COMPRESSED 0x10  // The payload is deflate compressed
+#define DMDUTIL_FRAME_FLAG_DELTA 0x20       // The payload is XORed with the previous frame of the connection
+#define DMDUTIL_MIN_COMPRESSION_SIZE 256
+#define DMDUTIL_DELTA_KEYFRAME_INTERVAL 60
 
 #include <atomic>
 #include <condition_variable>
@@ -24,6 +34,7 @@
 #include <shared_mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #if defined(__APPLE__)
 #include <TargetConditionals.h>
@@ -71,6 +82,13 @@ class LevelDMD;
 class RGB24DMD;
 class ConsoleDMD;
 class DMDServerConnector;
+class IngestQueue;
+struct IngestItem;
+class FrameSlot;
+class FrameSlotPool;
+class FramePacer;
+class FrameRing;
+class DumpWriter;
 
 class DMDUTILAPI DMD
 {
@@ -141,6 +159,31 @@ class DMDUTILAPI DMD
     uint32_t inputDurationMs = 0;
   };
 
+  struct IngestStats
+  {
+    uint64_t enqueued = 0;
+    uint64_t dropped = 0;
+    // Queued frames that were equal to the frame before.
+    uint64_t duplicates = 0;
+  };
+
+  struct DMDServerStats
+  {
+    uint64_t frames = 0;
+    uint64_t compressedFrames = 0;
+    uint64_t deltaFrames = 0;
+    uint64_t payloadBytes = 0;  // Before compression
+    uint64_t sentBytes = 0;     // After compression
+    uint64_t encodeTimeUs = 0;
+  };
+
+  struct DumpStats
+  {
+    // Frames the dumpers missed because the frame buffer wrapped before they got to them.
+    uint64_t lostFrames = 0;
+    uint64_t writtenBytes = 0;
+  };
+
   struct SerumCapture
   {
     bool valid = false;
@@ -190,6 +233,28 @@ class DMDUTILAPI DMD
     void convertToHostByteOrder() {}
     void convertToNetworkByteOrder() {}
   };
+
+  // Protocol version 2: StreamHeader, FrameHeader, optional PathsHeader, then dataLength bytes of data followed by
+  // segDataLength and segData2Length uint16_t values.
+  struct FrameHeader
+  {
+    char header[6] = "Frame";
+    uint8_t flags = 0;                                         // DMDUTIL_FRAME_FLAG_*
+    Mode mode = Mode::Data;                                    // int
+    AlphaNumericLayout layout = AlphaNumericLayout::NoLayout;  // int
+    int depth = 2;
+    uint8_t r = 255;
+    uint8_t g = 255;
+    uint8_t b = 255;
+    uint16_t width = 128;
+    uint16_t height = 32;
+    uint32_t dataLength = 0;
+    uint32_t segDataLength = 0;
+    uint32_t segData2Length = 0;
+
+    DMDUTILAPI void convertToHostByteOrder();
+    DMDUTILAPI void convertToNetworkByteOrder();
+  };
 #pragma pack(pop)  // Reset to default packing
 
   void FindDisplays();
@@ -205,7 +270,9 @@ class DMDUTILAPI DMD
   void DumpDMDRgb565();
   void DumpDMDRgb888();
   uint16_t GetUpdateQueuePosition() const;
-  bool WaitForDumpers(uint16_t targetPosition, uint32_t timeoutMs);
+  // Returns true once the active dumpers processed the frames up to targetPosition. With flush they also hand over
+  // their buffers and everything is written to the files.
+  bool WaitForDumpers(uint16_t targetPosition, uint32_t timeoutMs, bool flush = false);
   LevelDMD* CreateLevelDMD(uint16_t width, uint16_t height, bool sam);
   bool DestroyLevelDMD(LevelDMD* pLevelDMD);
   void AddRGB24DMD(RGB24DMD* pRGB24DMD);
@@ -242,13 +309,15 @@ class DMDUTILAPI DMD
   void QueueUpdate(const std::shared_ptr<Update> dmdUpdate, bool buffered, bool hasTimestamp = false,
                    uint32_t timestampMs = 0, const FrameContext* frameContext = nullptr);
   bool QueueBuffer();
+  IngestStats GetIngestStats() const;
+  DMDServerStats GetDMDServerStats() const;
+  DumpStats GetDumpStats() const;
 
  private:
-  Update* m_pUpdateBufferQueue[DMDUTIL_FRAME_BUFFER_SIZE];
-  std::shared_ptr<Update> m_updateBuffered;
-  uint32_t m_updateBufferQueueTimestamp[DMDUTIL_FRAME_BUFFER_SIZE] = {0};
-  bool m_updateBufferQueueHasTimestamp[DMDUTIL_FRAME_BUFFER_SIZE] = {false};
-  FrameContext m_updateBufferQueueFrameContext[DMDUTIL_FRAME_BUFFER_SIZE];
+  FrameSlotPool* m_pFrameSlotPool;
+  FrameRing* m_pFrameRing;
+  std::shared_ptr<FrameSlot> m_updateBuffered;
+  std::mutex m_updateBufferedMutex;
   uint32_t m_serumLastTimestampMs = 0;
   bool m_serumHasTimestamp = false;
   std::mutex m_serumCaptureMutex;
@@ -266,27 +335,54 @@ class DMDUTILAPI DMD
   std::atomic<bool> m_dumpRawActive{false};
   std::atomic<bool> m_dump565Active{false};
   std::atomic<bool> m_dump888Active{false};
-
+  // Raised by WaitForDumpers() with flush, each dumper answers with the position it handed over everything for.
+  std::atomic<uint32_t> m_dumpFlushRequest{0};
+  std::atomic<uint16_t> m_dumpTxtFlushed{0};
+  std::atomic<uint16_t> m_dumpRawFlushed{0};
+  std::atomic<uint16_t> m_dump565Flushed{0};
+  std::atomic<uint16_t> m_dump888Flushed{0};
+  DumpWriter* m_pDumpWriter;
+  std::atomic<uint64_t> m_dumpLostFrames{0};
+
+  void QueueFrame(std::shared_ptr<FrameSlot> frame, bool buffered, bool hasTimestamp = false,
+                  uint32_t timestampMs = 0, const FrameContext* frameContext = nullptr);
+  std::shared_ptr<FrameSlot> GetQueuedFrame(uint8_t bufferPositionMod);
+  void SkipLostDumpFrames(uint16_t& bufferPosition, uint16_t queuePosition, const char* dumper);
+  void PublishUpdate(IngestItem& item);
+  void WriteDMDServerUpdate(const FrameSlot& frame, bool buffered);
+  void WriteDMDServerFrame(const FrameSlot& frame, bool buffered);
   uint16_t GetNextBufferQueuePosition(uint16_t bufferPosition, const uint16_t updateBufferQueuePosition);
+  uint16_t GetNextBufferQueuePosition(FramePacer& pacer, uint16_t bufferPosition,
+                                      const uint16_t updateBufferQueuePosition);
+  bool PaceFrame(FramePacer& pacer, uint16_t bufferPosition, const uint16_t updateBufferQueuePosition, Mode mode);
   bool ConnectDMDServer();
   bool GetQueueFrameContext(uint8_t bufferPositionMod, FrameContext& frameContext) const;
   bool UpdatePalette(uint8_t* pPalette, uint8_t depth, uint8_t r, uint8_t g, uint8_t b);
+  bool UpdatePalette(uint32_t& paletteGeneration, uint8_t depth, uint8_t r, uint8_t g, uint8_t b);
   void UpdateData(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r, uint8_t g, uint8_t b,
                   Mode mode, bool buffered = false);
   void UpdateDataWithTimestampInternal(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r,
                                        uint8_t g, uint8_t b, Mode mode, uint32_t timestampMs, bool buffered = false);
   void AdjustRGB24Depth(uint8_t* pData, uint8_t* pDstData, int length, uint8_t* palette, uint8_t depth);
+  bool RenderIndexed(FrameSlot& frame, const uint8_t*& pIndexed, const uint8_t*& pPalette);
+  const uint8_t* RenderRgb888(FrameSlot& frame);
+  bool RenderIndexedLocked(FrameSlot& frame);
+  bool RenderRgb888Locked(FrameSlot& frame);
   void HandleTrigger(uint16_t id);
-  void QueueSerumFrames(Update* dmdUpdate, bool render32 = true, bool render64 = true, bool hasTimestamp = false,
-                        uint32_t timestampMs = 0, std::shared_ptr<Update>* primaryOutput = nullptr);
-  void RecordSerumColorizeCapture(const FrameContext& frameContext, const std::shared_ptr<Update>& primaryOutput,
+  void QueueSerumFrames(const FrameSlot* dmdUpdate, bool render32 = true, bool render64 = true,
+                        bool hasTimestamp = false, uint32_t timestampMs = 0,
+                        std::shared_ptr<FrameSlot>* primaryOutput = nullptr);
+  void RecordSerumColorizeCapture(const FrameContext& frameContext, const std::shared_ptr<FrameSlot>& primaryOutput,
                                   bool hasTimestamp, uint32_t outputTimestampMs, bool isRotation, uint32_t serumResult,
                                   uint32_t serumVersion, uint32_t serumFrameId, uint32_t serumTriggerId,
                                   uint32_t serumRotationTimer, uint32_t serumFeatureFlags, uint32_t colorizeTimeUs,
                                   uint32_t averageColorizeTimeUs);
   void GenerateRandomSuffix(char* buffer, size_t length);
-  bool DumpersReached(uint16_t targetPosition) const;
+  bool DumpersReached(uint16_t targetPosition, bool flushed) const;
+  bool TakeDumpFlushRequest(uint32_t& flushRequest) const;
+  void SetDumpFlushed(std::atomic<uint16_t>& flushedPosition, uint16_t position);
 
+  void IngestThread();
   void DmdFrameThread();
   void LevelDMDThread();
   void RGB24DMDThread();
@@ -316,7 +412,33 @@ class DMDUTILAPI DMD
   std::vector<ConsoleDMD*> m_consoleDMDs;
   DMDServerConnector* m_pDMDServerConnector;
   bool m_dmdServerDisconnectOthers = false;
-
+  PathsHeader m_dmdServerPaths;
+  bool m_dmdServerPathsSent = false;
+  std::vector<uint8_t> m_dmdServerBuffer;
+  std::vector<uint8_t> m_dmdServerPayload;
+  std::vector<uint8_t> m_dmdServerReference;
+  FrameHeader m_dmdServerReferenceHeader;
+  uint16_t m_dmdServerFramesSinceKeyframe = 0;
+  std::atomic<uint64_t> m_dmdServerFrames{0};
+  std::atomic<uint64_t> m_dmdServerCompressedFrames{0};
+  std::atomic<uint64_t> m_dmdServerDeltaFrames{0};
+  std::atomic<uint64_t> m_dmdServerPayloadBytes{0};
+  std::atomic<uint64_t> m_dmdServerSentBytes{0};
+  std::atomic<uint64_t> m_dmdServerEncodeTimeUs{0};
+
+  IngestQueue* m_pIngestQueue;
+  IngestItem* m_pIngestCoalesced;
+  std::atomic<bool> m_ingestHasCoalesced{false};
+  std::atomic<bool> m_ingestWaiting{false};
+  std::atomic<uint32_t> m_ingestBlockedProducers{0};
+  std::atomic<uint64_t> m_ingestEnqueued{0};
+  std::atomic<uint64_t> m_ingestDropped{0};
+  std::atomic<uint64_t> m_ingestDuplicates{0};
+  std::mutex m_ingestMutex;
+  std::condition_variable m_ingestCV;
+  std::condition_variable m_ingestSpaceCV;
+
+  std::thread* m_pIngestThread;
   std::thread* m_pLevelDMDThread;
   std::thread* m_pRGB24DMDThread;
   std::thread* m_pConsoleDMDThread;
@@ -329,10 +451,7 @@ class DMDUTILAPI DMD
   std::thread* m_pPupDMDThread;
   std::thread* m_pSerumThread;
   std::thread* m_pVniThread;
-  std::shared_mutex m_dmdSharedMutex;
-  std::condition_variable_any m_dmdCV;
   std::atomic<bool> m_stopFlag;
-  std::atomic<uint16_t> m_updateBufferQueuePosition;
   std::mutex m_dumpSuffixMutex;
   char m_dumpSuffixRom[DMDUTIL_MAX_NAME_SIZE] = {0};
   char m_dumpSuffix[9] = {0};
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <atomic>
-#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "DMDUtil/DMD.h"
 #include "sockpp/tcp_acceptor.h"
+#if !defined(_WIN32) && !defined(_WIN64)
+#include "sockpp/unix_acceptor.h"
+#endif
 
 #define DMDSERVER_MAX_WIDTH 256
 #define DMDSERVER_MAX_HEIGHT 64
@@ -20,25 +23,39 @@ class DMDUTILAPI DMDServer
   DMDServer(DMD* dmd, bool fixedAltColorPath = false, bool fixedPupPath = false);
   ~DMDServer();
 
-  bool Start(const char* addr, in_port_t port);
+  // Additionally listens on a Unix domain socket if unixSocketPath is set (not supported on Windows).
+  bool Start(const char* addr, in_port_t port, const char* unixSocketPath = nullptr);
   void Stop();
   bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
 
  private:
-  void AcceptLoop();
-  void ClientThread(sockpp::tcp_socket sock, uint32_t threadId);
+  struct Client;
+
+  void Run();
+  void AcceptClients();
+  void AddClient(sockpp::stream_socket sock);
+  bool ReadClient(Client* pClient);
+  bool ProcessMessages(Client* pClient);
+  void HandleMessage(Client* pClient, const DMD::StreamHeader& streamHeader, uint8_t* pData, size_t length);
+  void HandleFrame(Client* pClient, const DMD::StreamHeader& streamHeader, const uint8_t* pData, size_t length);
+  void CloseClient(Client* pClient);
 
   DMD* m_dmd;
   bool m_fixedAltColorPath;
   bool m_fixedPupPath;
   std::atomic<bool> m_running{false};
   sockpp::tcp_acceptor m_acceptor;
-
-  uint32_t m_currentThreadId{0};
-  std::mutex m_threadMutex;
+#if !defined(_WIN32) && !defined(_WIN64)
+  sockpp::unix_acceptor m_unixAcceptor;
+  std::string m_unixSocketPath;
+#endif
+
+  // Only accessed by the server thread.
+  uint32_t m_lastClientId{0};
+  uint32_t m_currentClientId{0};
   uint32_t m_disconnectOtherClients{0};
-  std::vector<uint32_t> m_threads;
-  std::thread* m_acceptThread{nullptr};
+  std::vector<Client*> m_clients;
+  std::thread* m_pServerThread{nullptr};
 };
 
 }  // namespace DMDUtil
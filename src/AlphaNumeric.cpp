@@ -8,6 +8,8 @@
 #include "AlphaNumeric.h"
 
 #include <cstring>
+#include <iterator>
+#include <utility>
 
 namespace DMDUtil
 {
@@ -180,497 +182,429 @@ const uint8_t AlphaNumeric::Segs[8][17][5][2] = {
 };
 // clang-format on
 
-AlphaNumeric::AlphaNumeric() {}
+namespace
+{
+constexpr uint8_t kGlyphWidths[8] = {8, 8, 8, 0, 0, 8, 0, 6};
+constexpr uint8_t kGlyphHeights[8] = {11, 11, 11, 0, 0, 7, 0, 11};
+}  // namespace
+
+// clang-format off
+// firstSegment, digits, x, pitch, gapAfter, gap, y, type, smoothing[, extra]
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x16Alpha>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 16, 0, 8, 0, 0,  2, 0, Smoothing::Corners},
+    {16, 16, 0, 8, 0, 0, 19, 0, Smoothing::Corners},
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x20Alpha>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 20, 4, 6, 0, 0,  2, 7, Smoothing::Corners6Px},
+    {20, 20, 4, 6, 0, 0, 19, 7, Smoothing::Corners6Px},
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Alpha_2x7Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14, 0, 8, 7, 16,  2, 0, Smoothing::Corners},  // 2x7 alphanumeric
+    {14, 14, 0, 8, 7, 16, 19, 1, Smoothing::Corners},  // 2x7 numeric
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Alpha_2x7Num_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14, 0, 8, 7, 16,  0, 0, Smoothing::Corners},  // 2x7 alphanumeric
+    {14, 14, 0, 8, 7, 16, 21, 1, Smoothing::Corners},  // 2x7 numeric
+    {28,  4, 8, 8, 2,  8, 12, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x6Num_2x6Num_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 12, 0, 8, 6, 32,  0, 1, Smoothing::Corners},  // 2x6 numeric
+    {12, 12, 0, 8, 6, 32, 12, 1, Smoothing::Corners},  // 2x6 numeric
+    {24,  4, 8, 8, 2,  8, 24, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x6Num10_2x6Num10_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 12, 0, 8, 6, 32,  0, 2, Smoothing::Corners},  // 2x6 numeric
+    {12, 12, 0, 8, 6, 32, 20, 2, Smoothing::Corners},  // 2x6 numeric
+    {24,  4, 8, 8, 2,  8, 12, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Num_2x7Num_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14,  0, 8, 7, 16,  0, 1, Smoothing::Corners},  // 2x7 numeric
+    {14, 14,  0, 8, 7, 16, 12, 1, Smoothing::Corners},  // 2x7 numeric
+    {28,  4, 16, 8, 2,  8, 24, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Num_2x7Num_10x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14,   0, 8, 7, 16,  0, 1, Smoothing::Corners},        // 2x7 numeric
+    {14, 14,   0, 8, 7, 16, 12, 1, Smoothing::Corners},        // 2x7 numeric
+    {28,  4,  16, 8, 2,  8, 24, 5, Smoothing::None},           // 10x1 numeric small
+    { 0,  2,  64, 8, 0,  0, 24, 5, Smoothing::None, true},
+    { 2,  2,  88, 8, 0,  0, 24, 5, Smoothing::None, true},
+    { 4,  2, 112, 8, 0,  0, 24, 5, Smoothing::None, true},
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Num_2x7Num_4x1Num_gen7>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14, 0, 8, 7, 16, 21, 1, Smoothing::Corners},  // 2x7 numeric
+    {14, 14, 0, 8, 7, 16,  1, 1, Smoothing::Corners},  // 2x7 numeric
+    {28,  4, 8, 8, 2,  8, 13, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Num10_2x7Num10_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14, 0, 8, 7, 16,  0, 2, Smoothing::Corners},  // 2x7 numeric
+    {14, 14, 0, 8, 7, 16, 20, 2, Smoothing::Corners},  // 2x7 numeric
+    {28,  4, 8, 8, 2,  8, 12, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__4x7Num10>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14, 0, 8, 7, 16,  1, 2, Smoothing::Corners},  // 2x7 numeric10
+    {14, 14, 0, 8, 7, 16, 13, 2, Smoothing::Corners},  // 2x7 numeric10
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__6x4Num_4x1Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 8,  0, 8, 4, 16,  1, 5, Smoothing::Corners},  // 2x4 numeric
+    { 8, 8,  0, 8, 4, 16,  9, 5, Smoothing::Corners},  // 2x4 numeric
+    {16, 8,  0, 8, 4, 16, 17, 5, Smoothing::Corners},  // 2x4 numeric
+    {24, 4, 16, 8, 2, 16, 25, 5, Smoothing::None},     // 4x1 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__2x7Num_4x1Num_1x16Alpha>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 14,  0, 8, 7, 16,  0, 1, Smoothing::Corners},  // 2x7 numeric
+    {14,  4, 16, 8, 2,  8, 12, 5, Smoothing::None},     // 4x1 numeric small
+    {18, 12, 16, 8, 0,  0, 21, 0, Smoothing::Corners},  // 1x16 alphanumeric
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 0, 16,  0, 8, 0, 0,  9, 0, Smoothing::Corners},  // 1x16 alphanumeric
+    {16, 16,  0, 8, 0, 0, 21, 1, Smoothing::Corners},  // 1x16 numeric
+    {32,  7, 68, 8, 0, 0,  1, 5, Smoothing::None},     // 1x7 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__1x7Num_1x16Alpha_1x16Num>
+{
+  static constexpr DigitRow rows[] = {
+    { 8, 16,  0, 8, 0, 0,  9, 0, Smoothing::Corners},  // 1x16 alphanumeric
+    {24, 16,  0, 8, 0, 0, 21, 1, Smoothing::Corners},  // 1x16 numeric
+    { 1,  7, 68, 8, 0, 0,  1, 5, Smoothing::None},     // 1x7 numeric small
+  };
+};
+
+template <>
+struct AlphaNumeric::LayoutTable<AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num_1x4Num>
+{
+  static constexpr DigitRow rows[] = {
+    {11, 16,  0, 8, 0, 0,  9, 0, Smoothing::Corners},  // 1x16 alphanumeric
+    {27, 16,  0, 8, 0, 0, 21, 1, Smoothing::Corners},  // 1x16 numeric
+    { 7,  4,  4, 8, 0, 0,  1, 5, Smoothing::None},     // 1x4 numeric small
+    { 0,  7, 68, 8, 0, 0,  1, 5, Smoothing::None},     // 1x7 numeric small
+  };
+};
+// clang-format on
+
+template <size_t N>
+constexpr bool AlphaNumeric::IsValidLayout(const DigitRow (&rows)[N])
+{
+  for (const DigitRow& row : rows)
+  {
+    if (row.digits == 0 || row.type >= 8 || kGlyphWidths[row.type] == 0) return false;
+    if (row.firstSegment + row.digits > (row.extra ? kExtraSegDataSize : kSegDataSize)) return false;
+
+    // DrawDigit() always writes 8 pixels per glyph row.
+    const int lastX = row.x + (row.digits - 1) * row.pitch + ((row.digits > row.gapAfter) ? row.gap : 0);
+    if (lastX + 8 > 128 || row.y + kGlyphHeights[row.type] > 32) return false;
+  }
+  return true;
+}
+
+template <AlphaNumericLayout Layout, size_t Row>
+void AlphaNumeric::RenderRow(uint8_t* pFrame, const uint16_t* const seg_data, const uint16_t* const extra_seg_data,
+                             const bool hd)
+{
+  constexpr DigitRow row = LayoutTable<Layout>::rows[Row];
+  // Without extra segment data the frame is drawn without the extra digits.
+  if (row.extra && !extra_seg_data) return;
+  const uint16_t* const pSegments = (row.extra ? extra_seg_data : seg_data) + row.firstSegment;
+  for (int i = 0; i < row.digits; i++)
+    DrawDigit(pFrame, row.x + i * row.pitch + ((i >= row.gapAfter) ? row.gap : 0), row.y, row.type, pSegments[i],
+              row.smoothing, hd);
+}
+
+template <AlphaNumericLayout Layout>
+void AlphaNumeric::RenderLayout(uint8_t* pFrame, const uint16_t* const seg_data, const uint16_t* const extra_seg_data,
+                                const bool hd)
+{
+  static_assert(IsValidLayout(LayoutTable<Layout>::rows), "Digits must fit into 128x32 and the segment data");
+
+  [&]<size_t... Rows>(std::index_sequence<Rows...>)
+  { (RenderRow<Layout, Rows>(pFrame, seg_data, extra_seg_data, hd), ...); }(
+      std::make_index_sequence<std::size(LayoutTable<Layout>::rows)>());
+}
+
+AlphaNumeric::AlphaNumeric() { BuildGlyphs(); }
 
 void AlphaNumeric::Render(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data)
 {
   if (layout != AlphaNumericLayout::__2x7Num_2x7Num_10x1Num)
-    Render(pFrame, layout, seg_data, nullptr);
+    RenderFrame(pFrame, layout, seg_data, nullptr, false);
   else
-    Render(pFrame, layout, seg_data, seg_data + 32);
+    RenderFrame(pFrame, layout, seg_data, seg_data + 32, false);
 }
 
 void AlphaNumeric::Render(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
                           const uint16_t* const seg_data2)
 {
-  Clear(pFrame);
+  RenderFrame(pFrame, layout, seg_data, seg_data2, false);
+}
+
+void AlphaNumeric::RenderHD(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data)
+{
+  if (layout != AlphaNumericLayout::__2x7Num_2x7Num_10x1Num)
+    RenderFrame(pFrame, layout, seg_data, nullptr, true);
+  else
+    RenderFrame(pFrame, layout, seg_data, seg_data + 32, true);
+}
+
+void AlphaNumeric::RenderHD(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
+                            const uint16_t* const seg_data2)
+{
+  RenderFrame(pFrame, layout, seg_data, seg_data2, true);
+}
+
+void AlphaNumeric::RenderFrame(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
+                               const uint16_t* const seg_data2, const bool hd)
+{
+  const uint16_t* const extra_seg_data = (layout == AlphaNumericLayout::__2x7Num_2x7Num_10x1Num) ? seg_data2 : nullptr;
+  const size_t frameSize = hd ? 256 * 64 : 128 * 32;
+
+  // PinMAME sends the same segments again and again, most frames look like the one before.
+  std::lock_guard<std::mutex> lock(m_lastFrameMutex);
+  if (layout == m_lastLayout && hd == m_lastHD && (extra_seg_data != nullptr) == m_lastHasExtra &&
+      memcmp(m_lastSegData, seg_data, sizeof(m_lastSegData)) == 0 &&
+      (!extra_seg_data || memcmp(m_lastExtraSegData, extra_seg_data, sizeof(m_lastExtraSegData)) == 0))
+  {
+    memcpy(pFrame, m_lastFrame, frameSize);
+    return;
+  }
+
+  memset(pFrame, 0, frameSize);
 
   switch (layout)
   {
     case AlphaNumericLayout::__2x16Alpha:
-      Render2x16Alpha(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x16Alpha>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x20Alpha:
-      Render2x20Alpha(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x20Alpha>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Alpha_2x7Num:
-      Render2x7Alpha_2x7Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Alpha_2x7Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Alpha_2x7Num_4x1Num:
-      Render2x7Alpha_2x7Num_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Alpha_2x7Num_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Num_2x7Num_4x1Num:
-      Render2x7Num_2x7Num_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Num_2x7Num_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Num_2x7Num_10x1Num:
-      Render2x7Num_2x7Num_10x1Num(pFrame, seg_data, seg_data2);
+      RenderLayout<AlphaNumericLayout::__2x7Num_2x7Num_10x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Num_2x7Num_4x1Num_gen7:
-      Render2x7Num_2x7Num_4x1Num_gen7(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Num_2x7Num_4x1Num_gen7>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Num10_2x7Num10_4x1Num:
-      Render2x7Num10_2x7Num10_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Num10_2x7Num10_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x6Num_2x6Num_4x1Num:
-      Render2x6Num_2x6Num_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x6Num_2x6Num_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x6Num10_2x6Num10_4x1Num:
-      Render2x6Num10_2x6Num10_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x6Num10_2x6Num10_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__4x7Num10:
-      Render4x7Num10(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__4x7Num10>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__6x4Num_4x1Num:
-      Render6x4Num_4x1Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__6x4Num_4x1Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__2x7Num_4x1Num_1x16Alpha:
-      Render2x7Num_4x1Num_1x16Alpha(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__2x7Num_4x1Num_1x16Alpha>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num:
-      Render1x16Alpha_1x16Num_1x7Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__1x7Num_1x16Alpha_1x16Num:
-      Render1x7Num_1x16Alpha_1x16Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__1x7Num_1x16Alpha_1x16Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     case AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num_1x4Num:
-      Render1x16Alpha_1x16Num_1x7Num_1x4Num(pFrame, seg_data);
+      RenderLayout<AlphaNumericLayout::__1x16Alpha_1x16Num_1x7Num_1x4Num>(pFrame, seg_data, extra_seg_data, hd);
       break;
     default:
       break;
   }
-}
-
-void AlphaNumeric::SmoothDigitCorners(uint8_t* pFrame, const int x, const int y)
-{
-  if (GetPixel(pFrame, x, 1 + y) && GetPixel(pFrame, 1 + x, y)) DrawPixel(pFrame, 0 + x, y, 0);
-  if (GetPixel(pFrame, x + 6, 1 + y) && GetPixel(pFrame, 5 + x, y)) DrawPixel(pFrame, 6 + x, y, 0);
-  if (GetPixel(pFrame, x, 9 + y) && GetPixel(pFrame, 1 + x, 10 + y)) DrawPixel(pFrame, 0 + x, 10 + y, 0);
-  if (GetPixel(pFrame, x + 6, 9 + y) && GetPixel(pFrame, 5 + x, 10 + y)) DrawPixel(pFrame, 6 + x, 10 + y, 0);
-}
-
-void AlphaNumeric::SmoothDigitCorners6Px(uint8_t* pFrame, const int x, const int y)
-{
-  if (GetPixel(pFrame, x, 1 + y) && GetPixel(pFrame, 1 + x, y)) DrawPixel(pFrame, 0 + x, y, 0);
-  if (GetPixel(pFrame, x + 4, 1 + y) && GetPixel(pFrame, 3 + x, y)) DrawPixel(pFrame, 4 + x, y, 0);
-  if (GetPixel(pFrame, x, 9 + y) && GetPixel(pFrame, 1 + x, 10 + y)) DrawPixel(pFrame, 0 + x, 10 + y, 0);
-  if (GetPixel(pFrame, x + 4, 9 + y) && GetPixel(pFrame, 3 + x, 10 + y)) DrawPixel(pFrame, 4 + x, 10 + y, 0);
-}
-
-void AlphaNumeric::DrawSegment(uint8_t* pFrame, const int x, const int y, const uint8_t type, const uint16_t seg,
-                               const uint8_t colour)
-{
-  for (int i = 0; i < SegSizes[type][seg]; i++)
-    DrawPixel(pFrame, Segs[type][seg][i][0] + x, Segs[type][seg][i][1] + y, colour);
-}
-
-bool AlphaNumeric::GetPixel(uint8_t* pFrame, const int x, const int y) const { return pFrame[y * 128 + x] > 0; }
-
-void AlphaNumeric::DrawPixel(uint8_t* pFrame, const int x, const int y, const uint8_t colour)
-{
-  pFrame[y * 128 + x] = colour;
-}
-
-void AlphaNumeric::Clear(uint8_t* pFrame) { memset(pFrame, 0, 128 * 32); }
-
-void AlphaNumeric::Render2x16Alpha(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, i * 8, 2, 0, j, 3);
-      if ((seg_data[i + 16] >> j) & 0x1) DrawSegment(pFrame, i * 8, 19, 0, j, 3);
-    }
-    SmoothDigitCorners(pFrame, i * 8, 2);
-    SmoothDigitCorners(pFrame, i * 8, 19);
-  }
-}
-
-void AlphaNumeric::Render2x20Alpha(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 20; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i * 6) + 4, 2, 7, j, 3);
-      if ((seg_data[i + 20] >> j) & 0x1) DrawSegment(pFrame, (i * 6) + 4, 19, 7, j, 3);
-    }
-    SmoothDigitCorners6Px(pFrame, (i * 6) + 4, 2);
-    SmoothDigitCorners6Px(pFrame, (i * 6) + 4, 19);
-  }
-}
-
-void AlphaNumeric::Render2x7Alpha_2x7Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 alphanumeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 2, 0, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 19, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 2);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 19);
-  }
-}
 
-void AlphaNumeric::Render2x7Alpha_2x7Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 alphanumeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0, 0, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 21, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 21);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[28] >> j) & 0x1) DrawSegment(pFrame, 8, 12, 5, j, 3);
-    if ((seg_data[29] >> j) & 0x1) DrawSegment(pFrame, 16, 12, 5, j, 3);
-    if ((seg_data[30] >> j) & 0x1) DrawSegment(pFrame, 32, 12, 5, j, 3);
-    if ((seg_data[31] >> j) & 0x1) DrawSegment(pFrame, 40, 12, 5, j, 3);
-  }
+  m_lastLayout = layout;
+  m_lastHD = hd;
+  m_lastHasExtra = (extra_seg_data != nullptr);
+  memcpy(m_lastSegData, seg_data, sizeof(m_lastSegData));
+  if (extra_seg_data)
+    memcpy(m_lastExtraSegData, extra_seg_data, sizeof(m_lastExtraSegData));
+  else
+    memset(m_lastExtraSegData, 0, sizeof(m_lastExtraSegData));
+  memcpy(m_lastFrame, pFrame, frameSize);
 }
 
-void AlphaNumeric::Render2x6Num_2x6Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
+void AlphaNumeric::BuildGlyphs()
 {
-  for (int i = 0; i < 12; i++)
+  for (int type = 0; type < 8; type++)
   {
-    for (int j = 0; j < 16; j++)
+    for (int seg = 0; seg < 16; seg++)
     {
-      // 2x6 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 0, 1, j, 3);
-
-      // 2x6 numeric
-      if ((seg_data[i + 12] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 12, 1, j, 3);
+      uint8_t* pRows = m_glyphRows[type][seg];
+      memset(pRows, 0, kGlyphHeight);
+      for (int i = 0; i < SegSizes[type][seg]; i++) pRows[Segs[type][seg][i][1]] |= 1 << Segs[type][seg][i][0];
     }
-    SmoothDigitCorners(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 12);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[24] >> j) & 0x1) DrawSegment(pFrame, 8, 24, 5, j, 3);
-    if ((seg_data[25] >> j) & 0x1) DrawSegment(pFrame, 16, 24, 5, j, 3);
-    if ((seg_data[26] >> j) & 0x1) DrawSegment(pFrame, 32, 24, 5, j, 3);
-    if ((seg_data[27] >> j) & 0x1) DrawSegment(pFrame, 40, 24, 5, j, 3);
   }
-}
 
-void AlphaNumeric::Render2x6Num10_2x6Num10_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 12; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x6 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 0, 2, j, 3);
-      // 2x6 numeric
-      if ((seg_data[i + 12] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 20, 2, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 6) ? 0 : 4)) * 8, 20);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
+  for (int mask = 0; mask < 256; mask++)
   {
-    if ((seg_data[24] >> j) & 0x1) DrawSegment(pFrame, 8, 12, 5, j, 3);
-    if ((seg_data[25] >> j) & 0x1) DrawSegment(pFrame, 16, 12, 5, j, 3);
-    if ((seg_data[26] >> j) & 0x1) DrawSegment(pFrame, 32, 12, 5, j, 3);
-    if ((seg_data[27] >> j) & 0x1) DrawSegment(pFrame, 40, 12, 5, j, 3);
-  }
-}
+    uint8_t pixels[8];
+    for (int x = 0; x < 8; x++) pixels[x] = ((mask >> x) & 0x1) ? 3 : 0;
+    memcpy(&m_rowPixels[mask], pixels, sizeof(pixels));
 
-void AlphaNumeric::Render2x7Num_2x7Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0, 1, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 12, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 12);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[28] >> j) & 0x1) DrawSegment(pFrame, 16, 24, 5, j, 3);
-    if ((seg_data[29] >> j) & 0x1) DrawSegment(pFrame, 24, 24, 5, j, 3);
-    if ((seg_data[30] >> j) & 0x1) DrawSegment(pFrame, 40, 24, 5, j, 3);
-    if ((seg_data[31] >> j) & 0x1) DrawSegment(pFrame, 48, 24, 5, j, 3);
+    uint8_t pixelsHD[16];
+    for (int x = 0; x < 16; x++) pixelsHD[x] = pixels[x / 2];
+    memcpy(m_rowPixelsHD[mask], pixelsHD, sizeof(pixelsHD));
   }
 }
 
-void AlphaNumeric::Render2x7Num_2x7Num_10x1Num(uint8_t* pFrame, const uint16_t* const seg_data,
-                                               const uint16_t* const extra_seg_data)
+void AlphaNumeric::DrawDigit(uint8_t* pFrame, const int x, const int y, const uint8_t type, const uint16_t segments,
+                             const Smoothing smoothing, const bool hd)
 {
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0, 1, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 12, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 12);
-  }
-  // 10x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[28] >> j) & 0x1) DrawSegment(pFrame, 16, 24, 5, j, 3);
-    if ((seg_data[29] >> j) & 0x1) DrawSegment(pFrame, 24, 24, 5, j, 3);
-    if ((seg_data[30] >> j) & 0x1) DrawSegment(pFrame, 40, 24, 5, j, 3);
-    if ((seg_data[31] >> j) & 0x1) DrawSegment(pFrame, 48, 24, 5, j, 3);
-    if ((extra_seg_data[0] >> j) & 0x1) DrawSegment(pFrame, 64, 24, 5, j, 3);
-    if ((extra_seg_data[1] >> j) & 0x1) DrawSegment(pFrame, 72, 24, 5, j, 3);
-    if ((extra_seg_data[2] >> j) & 0x1) DrawSegment(pFrame, 88, 24, 5, j, 3);
-    if ((extra_seg_data[3] >> j) & 0x1) DrawSegment(pFrame, 96, 24, 5, j, 3);
-    if ((extra_seg_data[4] >> j) & 0x1) DrawSegment(pFrame, 112, 24, 5, j, 3);
-    if ((extra_seg_data[5] >> j) & 0x1) DrawSegment(pFrame, 120, 24, 5, j, 3);
-  }
-}
+  if (!segments) return;
 
-void AlphaNumeric::Render2x7Num_2x7Num_4x1Num_gen7(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
+  uint8_t rows[kGlyphHeight] = {0};
+  for (int seg = 0; seg < 16; seg++)
   {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 21, 1, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 1, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 21);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 1);
+    if (!((segments >> seg) & 0x1)) continue;
+    for (int row = 0; row < kGlyphHeight; row++) rows[row] |= m_glyphRows[type][seg][row];
   }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[28] >> j) & 0x1) DrawSegment(pFrame, 8, 13, 5, j, 3);
-    if ((seg_data[29] >> j) & 0x1) DrawSegment(pFrame, 16, 13, 5, j, 3);
-    if ((seg_data[30] >> j) & 0x1) DrawSegment(pFrame, 32, 13, 5, j, 3);
-    if ((seg_data[31] >> j) & 0x1) DrawSegment(pFrame, 40, 13, 5, j, 3);
-  }
-}
 
-void AlphaNumeric::Render2x7Num10_2x7Num10_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0, 2, j, 3);
-      // 2x7 numeric
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 20, 2, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 20);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
+  if (smoothing != Smoothing::None)
   {
-    if ((seg_data[28] >> j) & 0x1) DrawSegment(pFrame, 8, 12, 5, j, 3);
-    if ((seg_data[29] >> j) & 0x1) DrawSegment(pFrame, 16, 12, 5, j, 3);
-    if ((seg_data[30] >> j) & 0x1) DrawSegment(pFrame, 32, 12, 5, j, 3);
-    if ((seg_data[31] >> j) & 0x1) DrawSegment(pFrame, 40, 12, 5, j, 3);
+    const int right = (smoothing == Smoothing::Corners) ? 6 : 4;
+    if ((rows[1] & 0x1) && (rows[0] & 0x2)) rows[0] &= ~0x1;
+    if ((rows[1] >> right & 0x1) && (rows[0] >> (right - 1) & 0x1)) rows[0] &= ~(1 << right);
+    if ((rows[9] & 0x1) && (rows[10] & 0x2)) rows[10] &= ~0x1;
+    if ((rows[9] >> right & 0x1) && (rows[10] >> (right - 1) & 0x1)) rows[10] &= ~(1 << right);
   }
-}
 
-void AlphaNumeric::Render4x7Num10(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
+  if (hd)
   {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric10
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 1, 2, j, 3);
-      // 2x7 numeric10
-      if ((seg_data[i + 14] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 13, 2, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 1);
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 13);
+    DrawGlyphHD(pFrame, x, y, rows);
+    return;
   }
-}
 
-void AlphaNumeric::Render6x4Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 8; i++)
+  // Digits never reach beyond the right edge, so 8 pixels can always be written. Frame pixels are either 0 or 3.
+  for (int row = 0; row < kGlyphHeight; row++)
   {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x4 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 1, 5, j, 3);
-      // 2x4 numeric
-      if ((seg_data[i + 8] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 9, 5, j, 3);
-      // 2x4 numeric
-      if ((seg_data[i + 16] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 17, 5, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 1);
-    SmoothDigitCorners(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 9);
-    SmoothDigitCorners(pFrame, (i + ((i < 4) ? 0 : 2)) * 8, 17);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[24] >> j) & 0x1) DrawSegment(pFrame, 16, 25, 5, j, 3);
-    if ((seg_data[25] >> j) & 0x1) DrawSegment(pFrame, 24, 25, 5, j, 3);
-    if ((seg_data[26] >> j) & 0x1) DrawSegment(pFrame, 48, 25, 5, j, 3);
-    if ((seg_data[27] >> j) & 0x1) DrawSegment(pFrame, 56, 25, 5, j, 3);
-  }
-}
+    if (!rows[row]) continue;
 
-void AlphaNumeric::Render2x7Num_4x1Num_1x16Alpha(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  for (int i = 0; i < 14; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      // 2x7 numeric
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i + ((i < 7) ? 0 : 2)) * 8, 0);
-  }
-  // 4x1 numeric small
-  for (int j = 0; j < 16; j++)
-  {
-    if ((seg_data[14] >> j) & 0x1) DrawSegment(pFrame, 16, 12, 5, j, 3);
-    if ((seg_data[15] >> j) & 0x1) DrawSegment(pFrame, 24, 12, 5, j, 3);
-    if ((seg_data[16] >> j) & 0x1) DrawSegment(pFrame, 40, 12, 5, j, 3);
-    if ((seg_data[17] >> j) & 0x1) DrawSegment(pFrame, 48, 12, 5, j, 3);
-  }
-  // 1x16 alphanumeric
-  for (int i = 0; i < 12; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 18] >> j) & 0x1) DrawSegment(pFrame, (i * 8) + 16, 21, 0, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8) + 16, 21);
+    uint8_t* pPixels = &pFrame[(y + row) * 128 + x];
+    uint64_t pixels;
+    memcpy(&pixels, pPixels, sizeof(pixels));
+    pixels |= m_rowPixels[rows[row]];
+    memcpy(pPixels, &pixels, sizeof(pixels));
   }
 }
 
-void AlphaNumeric::Render1x16Alpha_1x16Num_1x7Num(uint8_t* pFrame, const uint16_t* const seg_data)
+void AlphaNumeric::DrawGlyphHD(uint8_t* pFrame, const int x, const int y, const uint8_t* const rows)
 {
-  // 1x16 alphanumeric
-  for (int i = 0; i < 16; i++)
+  for (int row = 0; row < kGlyphHeight; row++)
   {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 9, 0, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8), 9);
-  }
+    if (!rows[row]) continue;
 
-  // 1x16 numeric
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
+    uint8_t* pTop = &pFrame[2 * (y + row) * 256 + 2 * x];
+    uint8_t* pBottom = pTop + 256;
+    for (uint8_t* pPixels : {pTop, pBottom})
     {
-      if ((seg_data[i + 16] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 21, 1, j, 3);
+      uint64_t pixels[2];
+      memcpy(pixels, pPixels, sizeof(pixels));
+      pixels[0] |= m_rowPixelsHD[rows[row]][0];
+      pixels[1] |= m_rowPixelsHD[rows[row]][1];
+      memcpy(pPixels, pixels, sizeof(pixels));
     }
-    SmoothDigitCorners(pFrame, (i * 8), 21);
-  }
 
-  // 1x7 numeric small
-  for (int i = 0; i < 7; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 32] >> j) & 0x1) DrawSegment(pFrame, (i * 8) + 68, 1, 5, j, 3);
-    }
-  }
-}
+    if (row + 1 == kGlyphHeight || !rows[row + 1]) continue;
 
-void AlphaNumeric::Render1x7Num_1x16Alpha_1x16Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  // 1x16 alphanumeric
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 8] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 9, 0, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8), 9);
-  }
-  // 1x16 numeric
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 24] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 21, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8), 21);
-  }
-  // 1x7 numeric small
-  for (int i = 0; i < 7; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 1] >> j) & 0x1) DrawSegment(pFrame, (i * 8) + 68, 1, 5, j, 3);
-    }
-  }
-}
-
-void AlphaNumeric::Render1x16Alpha_1x16Num_1x7Num_1x4Num(uint8_t* pFrame, const uint16_t* const seg_data)
-{
-  // 1x16 alphanumeric
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 11] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 9, 0, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8), 9);
-  }
-  // 1x16 numeric
-  for (int i = 0; i < 16; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 27] >> j) & 0x1) DrawSegment(pFrame, (i * 8), 21, 1, j, 3);
-    }
-    SmoothDigitCorners(pFrame, (i * 8), 21);
-  }
-  // 1x4 numeric small
-  for (int i = 0; i < 4; i++)
-  {
-    for (int j = 0; j < 16; j++)
-    {
-      if ((seg_data[i + 7] >> j) & 0x1) DrawSegment(pFrame, (i * 8) + 4, 1, 5, j, 3);
-    }
-  }
-  // 1x7 numeric small
-  for (int i = 0; i < 7; i++)
-  {
-    for (int j = 0; j < 16; j++)
+    // Where a stroke steps diagonally to the next row, fill the two pixels closest to the diagonal on either side.
+    // Level 2 OR-ed into a lit pixel stays 3.
+    const uint8_t below = rows[row + 1];
+    const uint8_t stepsRight = rows[row] & (below >> 1) & ~(rows[row] >> 1) & ~below & 0x7f;
+    const uint8_t stepsLeft = (rows[row] >> 1) & below & ~rows[row] & ~(below >> 1) & 0x7f;
+    uint8_t* pNextTop = pBottom + 256;
+    for (int col = 0; col < 7; col++)
     {
-      if ((seg_data[i] >> j) & 0x1) DrawSegment(pFrame, (i * 8) + 68, 1, 5, j, 3);
+      if ((stepsRight >> col) & 0x1)
+      {
+        pBottom[2 * col + 2] |= 2;
+        pNextTop[2 * col + 1] |= 2;
+      }
+      if ((stepsLeft >> col) & 0x1)
+      {
+        pBottom[2 * col + 1] |= 2;
+        pNextTop[2 * col + 2] |= 2;
+      }
     }
   }
 }
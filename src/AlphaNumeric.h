@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <mutex>
 
 #include "DMDUtil/DMD.h"
 
@@ -23,36 +25,78 @@ class AlphaNumeric
   void Render(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data);
   void Render(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
               const uint16_t* const seg_data2);
+  // Renders the same layout into a 256x64 frame for HD displays. Digits are drawn at twice the size and the steps of
+  // diagonal strokes are filled with level 2.
+  void RenderHD(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data);
+  void RenderHD(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
+                const uint16_t* const seg_data2);
 
  private:
-  void SmoothDigitCorners(uint8_t* pFrame, const int x, const int y);
-  void SmoothDigitCorners6Px(uint8_t* pFrame, const int x, const int y);
-  void DrawSegment(uint8_t* pFrame, const int x, const int y, const uint8_t type, const uint16_t seg,
-                   const uint8_t colour);
-  bool GetPixel(uint8_t* pFrame, const int x, const int y) const;
-  void DrawPixel(uint8_t* pFrame, const int x, const int y, const uint8_t colour);
-  void Clear(uint8_t* pFrame);
-
-  void Render2x16Alpha(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x20Alpha(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Alpha_2x7Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Alpha_2x7Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x6Num_2x6Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x6Num10_2x6Num10_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Num_2x7Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Num_2x7Num_10x1Num(uint8_t* pFrame, const uint16_t* const seg_data,
-                                   const uint16_t* const extra_seg_data);
-  void Render2x7Num_2x7Num_4x1Num_gen7(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Num10_2x7Num10_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render4x7Num10(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render6x4Num_4x1Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render2x7Num_4x1Num_1x16Alpha(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render1x16Alpha_1x16Num_1x7Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render1x7Num_1x16Alpha_1x16Num(uint8_t* pFrame, const uint16_t* const seg_data);
-  void Render1x16Alpha_1x16Num_1x7Num_1x4Num(uint8_t* pFrame, const uint16_t* const seg_data);
+  enum class Smoothing
+  {
+    None,
+    Corners,
+    Corners6Px
+  };
+
+  static constexpr int kGlyphHeight = 11;
+  static constexpr int kSegDataSize = 128;
+  static constexpr int kExtraSegDataSize = 6;
+
+  // A row of equally spaced digits. Digits from gapAfter on are moved right by gap pixels.
+  struct DigitRow
+  {
+    uint8_t firstSegment;
+    uint8_t digits;
+    uint8_t x;
+    uint8_t pitch;
+    uint8_t gapAfter;
+    uint8_t gap;
+    uint8_t y;
+    uint8_t type;
+    Smoothing smoothing;
+    // Segments are read from the extra segment data instead.
+    bool extra = false;
+  };
+
+  // Specialized in AlphaNumeric.cpp with the rows of each layout.
+  template <AlphaNumericLayout Layout>
+  struct LayoutTable;
+
+  template <size_t N>
+  static constexpr bool IsValidLayout(const DigitRow (&rows)[N]);
+
+  void RenderFrame(uint8_t* pFrame, AlphaNumericLayout layout, const uint16_t* const seg_data,
+                   const uint16_t* const seg_data2, const bool hd);
+  void BuildGlyphs();
+  void DrawDigit(uint8_t* pFrame, const int x, const int y, const uint8_t type, const uint16_t segments,
+                 const Smoothing smoothing, const bool hd);
+  void DrawGlyphHD(uint8_t* pFrame, const int x, const int y, const uint8_t* const rows);
+
+  template <AlphaNumericLayout Layout>
+  void RenderLayout(uint8_t* pFrame, const uint16_t* const seg_data, const uint16_t* const extra_seg_data,
+                    const bool hd);
+  template <AlphaNumericLayout Layout, size_t Row>
+  void RenderRow(uint8_t* pFrame, const uint16_t* const seg_data, const uint16_t* const extra_seg_data,
+                 const bool hd);
 
   static const uint8_t SegSizes[8][16];
   static const uint8_t Segs[8][17][5][2];
+
+  // One bit per pixel for each row of each segment, bit 0 is the leftmost pixel.
+  uint8_t m_glyphRows[8][16][kGlyphHeight];
+  // A row mask expanded to 8 frame pixels, or to 16 for HD.
+  uint64_t m_rowPixels[256];
+  uint64_t m_rowPixelsHD[256][2];
+
+  // The last rendered frame and the segment data it was rendered from.
+  std::mutex m_lastFrameMutex;
+  AlphaNumericLayout m_lastLayout = AlphaNumericLayout::NoLayout;
+  bool m_lastHD = false;
+  bool m_lastHasExtra = false;
+  uint16_t m_lastSegData[kSegDataSize] = {0};
+  uint16_t m_lastExtraSegData[kExtraSegDataSize] = {0};
+  uint8_t m_lastFrame[256 * 64] = {0};
 };
 
 }  // namespace DMDUtil
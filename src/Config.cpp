@@ -40,6 +40,8 @@ Config::Config()
   m_dumpNotColorizedFrames = false;
   m_dumpFrames = false;
   m_dumpZip = false;
+  m_dumpSync = false;
+  m_dumpZipLevel = 6;
   m_filterTransitionalFrames = false;
   m_roundedCorners = 0;
   m_zedmd = true;
@@ -59,7 +61,12 @@ Config::Config()
   m_dmdServer = false;
   m_dmdServerAddr = "localhost";
   m_dmdServerPort = 6789;
+  m_dmdServerUnixSocket.clear();
+  m_dmdServerCompression = false;
+  m_dmdServerDelta = false;
+  m_dmdServerProtocolVersion = 1;
   m_localDisplaysActive = true;
+  m_queueOverflowPolicy = DMDUtil_QueueOverflowPolicy_DropOldest;
   m_logLevel = DMDUtil_LogLevel_INFO;
   m_logCallback = nullptr;
   memset(&m_pupTriggerCallbackContext, 0, sizeof(m_pupTriggerCallbackContext));
@@ -88,6 +95,15 @@ void Config::parseConfigFile(const char* path)
     SetDMDServerPort(6789);
   }
 
+  try
+  {
+    SetDMDServerUnixSocket(r.Get<std::string>("DMDServer", "UnixSocket", "").c_str());
+  }
+  catch (const std::exception&)
+  {
+    SetDMDServerUnixSocket("");
+  }
+
   try
   {
     SetAltColor(r.Get<bool>("DMDServer", "AltColor", true));
@@ -142,6 +158,19 @@ void Config::parseConfigFile(const char* path)
     SetPUPExactColorMatch(false);
   }
 
+  try
+  {
+    int queueOverflowPolicy = r.Get<int>("DMDServer", "QueueOverflowPolicy", 0);
+    if (queueOverflowPolicy < DMDUtil_QueueOverflowPolicy_DropOldest ||
+        queueOverflowPolicy > DMDUtil_QueueOverflowPolicy_Coalesce)
+      queueOverflowPolicy = DMDUtil_QueueOverflowPolicy_DropOldest;
+    SetQueueOverflowPolicy((DMDUtil_QueueOverflowPolicy)queueOverflowPolicy);
+  }
+  catch (const std::exception&)
+  {
+    SetQueueOverflowPolicy(DMDUtil_QueueOverflowPolicy_DropOldest);
+  }
+
   // ZeDMD
   try
   {
@@ -374,6 +403,24 @@ void Config::parseConfigFile(const char* path)
     SetDumpPath("");
   }
 
+  try
+  {
+    SetDumpZipLevel(r.Get<int>("Dump", "DumpZipLevel", 6));
+  }
+  catch (const std::exception&)
+  {
+    SetDumpZipLevel(6);
+  }
+
+  try
+  {
+    SetDumpSync(r.Get<bool>("Dump", "DumpSync", false));
+  }
+  catch (const std::exception&)
+  {
+    SetDumpSync(false);
+  }
+
   try
   {
     SetFilterTransitionalFrames(r.Get<bool>("Dump", "FilterTransitionalFrames", false));
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
 #include <filesystem>
 #include <limits>
@@ -42,15 +43,26 @@
 #include "AlphaNumeric.h"
 #include "FrameUtil.h"
 #include "DMDUtil/Logger.h"
+#include "DumpWriter.h"
+#include "FrameDump.h"
+#include "FramePacer.h"
+#include "FrameRing.h"
+#include "FrameSlotPool.h"
+#include "IngestQueue.h"
 #include "OutputFilters.h"
+#include "PaletteCache.h"
+#include "PixelKernels.h"
+#include "TextDump.h"
 #include "TimeUtils.h"
 #include "ZeDMD.h"
-#include "komihash/komihash.h"
 #include "miniz/miniz.h"
 #include "pupdmd.h"
 #include "serum-decode.h"
 #include "serum.h"
 #include "sockpp/tcp_connector.h"
+#if !defined(_WIN32) && !defined(_WIN64)
+#include "sockpp/unix_connector.h"
+#endif
 #ifdef DMDUTIL_ENABLE_VNI
 #include "vni.h"
 #endif
@@ -58,7 +70,6 @@
 namespace
 {
 constexpr size_t kMaxFramePixels = 256u * 64u;
-constexpr size_t kMaxRgb24Bytes = kMaxFramePixels * 3u;
 
 uint64_t SplitMix64(uint64_t value)
 {
@@ -79,38 +90,13 @@ std::string ToLower(const std::string& value)
   return out;
 }
 
-bool ZipDumpFile(const std::string& sourcePath)
+// Zipped dumps are deflated while they are written, there is no uncompressed copy on the disk.
+bool OpenDumpFile(DMDUtil::DumpFile& file, const std::string& path, bool zip, int zipLevel)
 {
-  if (sourcePath.empty())
-  {
-    return false;
-  }
-
-  std::filesystem::path srcPath(sourcePath);
-  std::string zipPath = sourcePath + ".zip";
-  std::string entryName = srcPath.filename().string();
-
-  mz_zip_archive zip;
-  mz_zip_zero_struct(&zip);
-  if (!mz_zip_writer_init_file(&zip, zipPath.c_str(), 0))
-  {
-    return false;
-  }
-
-  bool ok = mz_zip_writer_add_file(&zip, entryName.c_str(), sourcePath.c_str(), nullptr, 0, MZ_BEST_COMPRESSION);
-  ok = ok && mz_zip_writer_finalize_archive(&zip);
-  mz_zip_writer_end(&zip);
+  if (!zip) return file.Open(path.c_str(), "w");
 
-  if (!ok)
-  {
-    std::error_code ec;
-    std::filesystem::remove(zipPath, ec);
-    return false;
-  }
-
-  std::error_code ec;
-  std::filesystem::remove(sourcePath, ec);
-  return true;
+  const std::string entryName = std::filesystem::path(path).filename().string();
+  return file.OpenZip((path + ".zip").c_str(), entryName.c_str(), zipLevel);
 }
 
 bool FindCaseInsensitiveFile(const std::string& dir, const std::string& filename, std::string* outPath)
@@ -160,6 +146,31 @@ std::string BuildAltColorDir(const char* altColorPath, const char* romName)
   return path;
 }
 
+// Calls convert(firstPixel, pixels) for each run of changed rows.
+template <typename Convert>
+void ForEachChangedRows(uint64_t changedRows, uint16_t width, uint16_t height, Convert convert)
+{
+  if (changedRows == DMDUtil::FrameSlot::kAllRowsChanged || height > 64)
+  {
+    convert((size_t)0, (int)width * height);
+    return;
+  }
+
+  uint16_t y = 0;
+  while (y < height)
+  {
+    if (!(changedRows & ((uint64_t)1 << y)))
+    {
+      y++;
+      continue;
+    }
+
+    const uint16_t first = y;
+    while (y < height && (changedRows & ((uint64_t)1 << y))) y++;
+    convert((size_t)first * width, (int)(y - first) * width);
+  }
+}
+
 size_t PaletteBytesForDepth(uint8_t depth)
 {
   if (depth > 8)
@@ -202,8 +213,23 @@ class DMDServerConnector
  public:
   ~DMDServerConnector() { delete m_pConnector; }
 
-  static DMDServerConnector* Create(const char* pAddress, int port)
+  static DMDServerConnector* Create(const char* pAddress, int port, const char* pUnixSocketPath)
   {
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (pUnixSocketPath && pUnixSocketPath[0] != '\0')
+    {
+      sockpp::unix_connector* pUnixConnector = new sockpp::unix_connector(sockpp::unix_address(pUnixSocketPath));
+      if (*pUnixConnector)
+      {
+        Log(DMDUtil_LogLevel_INFO, "Connected DMDServer on %s", pUnixSocketPath);
+        return new DMDServerConnector(pUnixConnector);
+      }
+
+      Log(DMDUtil_LogLevel_INFO, "DMDServer connection to %s failed, falling back to TCP", pUnixSocketPath);
+      delete pUnixConnector;
+    }
+#endif
+
     sockpp::tcp_connector* pConnector = new sockpp::tcp_connector({pAddress, (in_port_t)port});
     if (pConnector)
     {
@@ -217,8 +243,8 @@ class DMDServerConnector
   void Close() { m_pConnector->close(); }
 
  private:
-  DMDServerConnector(sockpp::tcp_connector* pConnector) : m_pConnector(pConnector) {}
-  sockpp::tcp_connector* m_pConnector;
+  DMDServerConnector(sockpp::stream_socket* pConnector) : m_pConnector(pConnector) {}
+  sockpp::stream_socket* m_pConnector;
 };
 
 std::atomic<bool> DMD::m_finding{false};
@@ -229,14 +255,8 @@ void DMD::Update::convertToHostByteOrder()
   mode = static_cast<Mode>(ntohl(static_cast<uint32_t>(mode)));
   layout = static_cast<AlphaNumericLayout>(ntohl(static_cast<uint32_t>(layout)));
   depth = ntohl(depth);
-  for (size_t i = 0; i < 256 * 64; i++)
-  {
-    segData[i] = ntohs(segData[i]);
-  }
-  for (size_t i = 0; i < 128; i++)
-  {
-    segData2[i] = ntohs(segData2[i]);
-  }
+  PixelKernels::ConvertByteOrder16(segData, segData, 256 * 64);
+  PixelKernels::ConvertByteOrder16(segData2, segData2, 128);
   width = ntohs(width);
   height = ntohs(height);
 }
@@ -248,14 +268,8 @@ DMD::Update DMD::Update::toNetworkByteOrder() const
   copy.mode = static_cast<Mode>(htonl(static_cast<int>(mode)));
   copy.layout = static_cast<AlphaNumericLayout>(htonl(static_cast<int>(layout)));
   copy.depth = htonl(depth);
-  for (size_t i = 0; i < 256 * 64; i++)
-  {
-    copy.segData[i] = htons(segData[i]);
-  }
-  for (size_t i = 0; i < 128; i++)
-  {
-    copy.segData2[i] = htons(segData2[i]);
-  }
+  PixelKernels::ConvertByteOrder16(segData, copy.segData, 256 * 64);
+  PixelKernels::ConvertByteOrder16(segData2, copy.segData2, 128);
   copy.width = htons(width);
   copy.height = htons(height);
   return copy;
@@ -279,20 +293,47 @@ void DMD::StreamHeader::convertToNetworkByteOrder()
   length = htonl(length);
 }
 
+void DMD::FrameHeader::convertToHostByteOrder()
+{
+  // uint8_t and char are not converted, as they are already in host byte order.
+  mode = static_cast<Mode>(ntohl(static_cast<uint32_t>(mode)));
+  layout = static_cast<AlphaNumericLayout>(ntohl(static_cast<uint32_t>(layout)));
+  depth = ntohl(depth);
+  width = ntohs(width);
+  height = ntohs(height);
+  dataLength = ntohl(dataLength);
+  segDataLength = ntohl(segDataLength);
+  segData2Length = ntohl(segData2Length);
+}
+
+void DMD::FrameHeader::convertToNetworkByteOrder()
+{
+  // uint8_t and char are not converted, as they are already in network byte order.
+  mode = static_cast<Mode>(htonl(static_cast<int>(mode)));
+  layout = static_cast<AlphaNumericLayout>(htonl(static_cast<int>(layout)));
+  depth = htonl(depth);
+  width = htons(width);
+  height = htons(height);
+  dataLength = htonl(dataLength);
+  segDataLength = htonl(segDataLength);
+  segData2Length = htonl(segData2Length);
+}
+
 DMD::DMD()
 {
-  for (uint8_t i = 0; i < DMDUTIL_FRAME_BUFFER_SIZE; i++)
-  {
-    m_pUpdateBufferQueue[i] = new Update();
-    m_updateBufferQueueTimestamp[i] = 0;
-    m_updateBufferQueueHasTimestamp[i] = false;
-    m_updateBufferQueueFrameContext[i] = FrameContext{};
-  }
-  m_updateBufferQueuePosition.store(0, std::memory_order_release);
+  m_pFrameSlotPool = new FrameSlotPool();
+  std::shared_ptr<FrameSlot> emptyFrame = m_pFrameSlotPool->Acquire(Mode::Data, 128, 32);
+  memset(emptyFrame->data, 0, emptyFrame->dataSize);
+  emptyFrame->ComputeHash();
+
+  m_pFrameRing = new FrameRing(emptyFrame);
   m_stopFlag.store(false, std::memory_order_release);
-  m_updateBuffered = std::make_shared<Update>();
+  m_updateBuffered = emptyFrame;
+  m_pIngestQueue = new IngestQueue(DMDUTIL_INGEST_QUEUE_SIZE);
+  m_pIngestCoalesced = new IngestItem();
 
   m_pAlphaNumeric = new AlphaNumeric();
+  m_pDumpWriter = new DumpWriter();
   m_pSerum = nullptr;
   m_pVni = nullptr;
   m_pZeDMD = nullptr;
@@ -322,6 +363,7 @@ DMD::DMD()
   m_PIN2DMDHeight = 0;
 #endif
 
+  m_pIngestThread = new std::thread(&DMD::IngestThread, this);
   m_pDmdFrameThread = new std::thread(&DMD::DmdFrameThread, this);
   m_pPupDMDThread = new std::thread(&DMD::PupDMDThread, this);
   m_pSerumThread = new std::thread(&DMD::SerumThread, this);
@@ -332,10 +374,21 @@ DMD::DMD()
 DMD::~DMD()
 {
   Log(DMDUtil_LogLevel_INFO, "DMD destructor start");
-  std::unique_lock<std::shared_mutex> ul(m_dmdSharedMutex);
   m_stopFlag.store(true, std::memory_order_release);
-  ul.unlock();
-  m_dmdCV.notify_all();
+  m_pFrameRing->WakeAll();
+  {
+    std::lock_guard<std::mutex> lock(m_ingestMutex);
+    m_ingestCV.notify_all();
+    m_ingestSpaceCV.notify_all();
+  }
+
+  Log(DMDUtil_LogLevel_INFO, "DMD destructor: joining IngestThread");
+  if (m_pIngestThread->joinable())
+    m_pIngestThread->join();
+  else
+    Log(DMDUtil_LogLevel_ERROR, "DMD destructor: IngestThread not joinable");
+  delete m_pIngestThread;
+  m_pIngestThread = nullptr;
 
   Log(DMDUtil_LogLevel_INFO, "DMD destructor: joining DmdFrameThread");
   if (m_pDmdFrameThread->joinable())
@@ -417,6 +470,13 @@ DMD::~DMD()
     m_pDumpDMDRgb888Thread = nullptr;
   }
 
+  // Waits for the dumps to be written.
+  delete m_pDumpWriter;
+  m_pDumpWriter = nullptr;
+  const DumpStats dumpStats = GetDumpStats();
+  if (dumpStats.lostFrames > 0)
+    Log(DMDUtil_LogLevel_ERROR, "Dump stats: lost frames=%llu", (unsigned long long)dumpStats.lostFrames);
+
   if (m_pPupDMDThread)
   {
     Log(DMDUtil_LogLevel_INFO, "DMD destructor: joining PupDMDThread");
@@ -486,15 +546,27 @@ DMD::~DMD()
 
   if (m_pDMDServerConnector)
   {
+    const DMDServerStats stats = GetDMDServerStats();
+    if (stats.frames > 0)
+      Log(DMDUtil_LogLevel_INFO,
+          "DMDServer stats: frames=%llu, compressed=%llu, delta=%llu, payload=%llu bytes, sent=%llu bytes, encode "
+          "time=%llu us",
+          (unsigned long long)stats.frames, (unsigned long long)stats.compressedFrames,
+          (unsigned long long)stats.deltaFrames,
+          (unsigned long long)stats.payloadBytes, (unsigned long long)stats.sentBytes,
+          (unsigned long long)stats.encodeTimeUs);
     m_pDMDServerConnector->Close();
     delete m_pDMDServerConnector;
     m_pDMDServerConnector = nullptr;
   }
 
-  for (uint8_t i = 0; i < DMDUTIL_FRAME_BUFFER_SIZE; i++)
-  {
-    delete m_pUpdateBufferQueue[i];
-  }
+  delete m_pIngestQueue;
+  delete m_pIngestCoalesced;
+
+  // All frames need to be returned before the pool goes away.
+  delete m_pFrameRing;
+  m_updateBuffered.reset();
+  delete m_pFrameSlotPool;
 
   Log(DMDUtil_LogLevel_INFO, "DMD destructor finished");
 }
@@ -507,7 +579,10 @@ bool DMD::ConnectDMDServer()
     sockpp::initialize();
     Log(DMDUtil_LogLevel_INFO, "Connecting DMDServer on %s:%d", pConfig->GetDMDServerAddr(),
         pConfig->GetDMDServerPort());
-    m_pDMDServerConnector = DMDServerConnector::Create(pConfig->GetDMDServerAddr(), pConfig->GetDMDServerPort());
+    m_pDMDServerConnector = DMDServerConnector::Create(pConfig->GetDMDServerAddr(), pConfig->GetDMDServerPort(),
+                                                       pConfig->GetDMDServerUnixSocket());
+    m_dmdServerPathsSent = false;
+    m_dmdServerReference.clear();
     if (!m_pDMDServerConnector)
     {
       Log(DMDUtil_LogLevel_INFO, "DMDServer connection to %s:%d failed!", pConfig->GetDMDServerAddr(),
@@ -572,14 +647,16 @@ void DMD::DumpDMDTxt()
 {
   if (!m_pDumpDMDTxtThread)
   {
+    m_pDumpWriter->SetSync(Config::GetInstance()->IsDumpSync());
     m_pDumpDMDTxtThread = new std::thread(&DMD::DumpDMDTxtThread, this);
   }
 }
 
 void DMD::DumpDMDRaw()
 {
-  if (m_pDumpDMDRawThread)
+  if (!m_pDumpDMDRawThread)
   {
+    m_pDumpWriter->SetSync(Config::GetInstance()->IsDumpSync());
     m_pDumpDMDRawThread = new std::thread(&DMD::DumpDMDRawThread, this);
   }
 }
@@ -588,6 +665,7 @@ void DMD::DumpDMDRgb565()
 {
   if (!m_pDumpDMDRgb565Thread)
   {
+    m_pDumpWriter->SetSync(Config::GetInstance()->IsDumpSync());
     m_pDumpDMDRgb565Thread = new std::thread(&DMD::DumpDMDRgb565Thread, this);
   }
 }
@@ -596,6 +674,7 @@ void DMD::DumpDMDRgb888()
 {
   if (!m_pDumpDMDRgb888Thread)
   {
+    m_pDumpWriter->SetSync(Config::GetInstance()->IsDumpSync());
     m_pDumpDMDRgb888Thread = new std::thread(&DMD::DumpDMDRgb888Thread, this);
   }
 }
@@ -691,114 +770,498 @@ bool DMD::DestroyConsoleDMD(ConsoleDMD* pConsoleDMD)
 void DMD::UpdateData(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r, uint8_t g, uint8_t b,
                      Mode mode, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(mode, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->data, pData, (size_t)width * height * (mode == Mode::RGB16 ? 2 : (mode == Mode::RGB24 ? 3 : 1)));
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->data, pData, frame->dataSize);
+    frame->hasData = true;
   }
-  dmdUpdate->mode = mode;
-  dmdUpdate->depth = depth;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
-  dmdUpdate->r = r;
-  dmdUpdate->g = g;
-  dmdUpdate->b = b;
+  frame->depth = depth;
+  frame->r = r;
+  frame->g = g;
+  frame->b = b;
 
-  QueueUpdate(dmdUpdate, buffered);
+  QueueFrame(frame, buffered);
 }
 
 void DMD::UpdateDataWithTimestampInternal(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r,
                                           uint8_t g, uint8_t b, Mode mode, uint32_t timestampMs, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(mode, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->data, pData, (size_t)width * height * (mode == Mode::RGB16 ? 2 : (mode == Mode::RGB24 ? 3 : 1)));
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->data, pData, frame->dataSize);
+    frame->hasData = true;
   }
-  dmdUpdate->mode = mode;
-  dmdUpdate->depth = depth;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
-  dmdUpdate->r = r;
-  dmdUpdate->g = g;
-  dmdUpdate->b = b;
+  frame->depth = depth;
+  frame->r = r;
+  frame->g = g;
+  frame->b = b;
 
-  QueueUpdate(dmdUpdate, buffered, true, timestampMs);
+  QueueFrame(frame, buffered, true, timestampMs);
 }
 
 void DMD::QueueUpdate(const std::shared_ptr<Update> dmdUpdate, bool buffered, bool hasTimestamp, uint32_t timestampMs,
                       const FrameContext* frameContext)
 {
-  const FrameContext frameContextCopy = frameContext ? *frameContext : FrameContext{};
-  std::thread(
-      [this, dmdUpdate, buffered, hasTimestamp, timestampMs, frameContextCopy]()
-      {
-        std::unique_lock<std::shared_mutex> ul(m_dmdSharedMutex);
-        uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
-        uint8_t slot = (++updateBufferQueuePosition) % DMDUTIL_FRAME_BUFFER_SIZE;
-        memcpy(m_pUpdateBufferQueue[slot], dmdUpdate.get(), sizeof(Update));
-        m_updateBufferQueueHasTimestamp[slot] = hasTimestamp;
-        m_updateBufferQueueTimestamp[slot] = timestampMs;
-        m_updateBufferQueueFrameContext[slot] = frameContextCopy;
-        m_updateBufferQueuePosition.store(updateBufferQueuePosition, std::memory_order_release);
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(dmdUpdate->mode, dmdUpdate->width, dmdUpdate->height);
+  if (!frame)
+  {
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", dmdUpdate->width, dmdUpdate->height);
+    return;
+  }
+  frame->CopyFrom(*dmdUpdate);
+  if (frame->mode == Mode::AlphaNumeric)
+  {
+    // Segments are rendered for the displays connected here, not for the ones of the sender.
+    const bool hd = HasHDDisplay();
+    frame->width = hd ? 256 : 128;
+    frame->height = hd ? 64 : 32;
+  }
 
-        Log(DMDUtil_LogLevel_DEBUG, "Queued Frame: position=%d, mode=%d, depth=%d", updateBufferQueuePosition,
-            dmdUpdate->mode, dmdUpdate->depth);
+  QueueFrame(frame, buffered, hasTimestamp, timestampMs, frameContext);
+}
 
-        if (buffered)
-        {
-          memcpy(m_updateBuffered.get(), dmdUpdate.get(), sizeof(Update));
-          m_hasUpdateBuffered = true;
-        }
+void DMD::QueueFrame(std::shared_ptr<FrameSlot> frame, bool buffered, bool hasTimestamp, uint32_t timestampMs,
+                     const FrameContext* frameContext)
+{
+  IngestItem item;
+  item.frame = std::move(frame);
+  item.buffered = buffered;
+  item.hasTimestamp = hasTimestamp;
+  item.timestampMs = timestampMs;
+  if (frameContext) item.frameContext = *frameContext;
+
+  const DMDUtil_QueueOverflowPolicy policy = Config::GetInstance()->GetQueueOverflowPolicy();
+
+  if (policy == DMDUtil_QueueOverflowPolicy_Coalesce && m_ingestHasCoalesced.load(std::memory_order_acquire))
+  {
+    // As long as an overflowing frame is pending, newer frames replace it to keep the order intact.
+    std::lock_guard<std::mutex> lock(m_ingestMutex);
+    if (m_ingestHasCoalesced.load(std::memory_order_relaxed))
+    {
+      *m_pIngestCoalesced = std::move(item);
+      m_ingestEnqueued.fetch_add(1, std::memory_order_relaxed);
+      m_ingestDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
 
-        ul.unlock();
-        m_dmdCV.notify_all();
+  while (!m_pIngestQueue->TryPush(item))
+  {
+    if (m_stopFlag.load(std::memory_order_relaxed)) return;
 
-        const bool sendToDMDServer = !IsSerumMode(dmdUpdate->mode) || dmdUpdate->mode == Mode::SerumCommand;
-        if (m_pDMDServerConnector && sendToDMDServer)
+    if (policy == DMDUtil_QueueOverflowPolicy_Block)
+    {
+      m_ingestBlockedProducers.fetch_add(1, std::memory_order_seq_cst);
+      std::unique_lock<std::mutex> lock(m_ingestMutex);
+      while (!m_pIngestQueue->TryPush(item))
+      {
+        if (m_stopFlag.load(std::memory_order_relaxed))
         {
-          StreamHeader streamHeader;
-          streamHeader.buffered = (uint8_t)buffered;
-          streamHeader.disconnectOthers = (uint8_t)m_dmdServerDisconnectOthers;
-          streamHeader.convertToNetworkByteOrder();
-          m_pDMDServerConnector->Write(&streamHeader, sizeof(StreamHeader));
-          PathsHeader pathsHeader;
-          strcpy(pathsHeader.name, m_romName);
-          strcpy(pathsHeader.altColorPath, m_altColorPath);
-          strcpy(pathsHeader.pupVideosPath, m_pupVideosPath);
-          pathsHeader.convertToNetworkByteOrder();
-          m_pDMDServerConnector->Write(&pathsHeader, sizeof(PathsHeader));
-          Update dmdUpdateNetwork = dmdUpdate->toNetworkByteOrder();
-          m_pDMDServerConnector->Write(&dmdUpdateNetwork, sizeof(Update));
-
-          if (streamHeader.disconnectOthers != 0) m_dmdServerDisconnectOthers = false;
+          m_ingestBlockedProducers.fetch_sub(1, std::memory_order_relaxed);
+          return;
         }
-      })
-      .detach();
+        m_ingestSpaceCV.wait(lock);
+      }
+      m_ingestBlockedProducers.fetch_sub(1, std::memory_order_relaxed);
+      break;
+    }
+    else if (policy == DMDUtil_QueueOverflowPolicy_Coalesce)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_ingestMutex);
+        if (m_ingestHasCoalesced.load(std::memory_order_relaxed))
+          m_ingestDropped.fetch_add(1, std::memory_order_relaxed);
+        *m_pIngestCoalesced = std::move(item);
+        m_ingestHasCoalesced.store(true, std::memory_order_release);
+      }
+      m_ingestEnqueued.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_ingestWaiting.load(std::memory_order_relaxed))
+      {
+        std::lock_guard<std::mutex> lock(m_ingestMutex);
+        m_ingestCV.notify_one();
+      }
+      return;
+    }
+    else
+    {
+      IngestItem oldest;
+      if (m_pIngestQueue->TryPop(oldest))
+      {
+        m_ingestDropped.fetch_add(1, std::memory_order_relaxed);
+        Log(DMDUtil_LogLevel_DEBUG, "Ingest queue full, dropped oldest frame");
+      }
+    }
+  }
+
+  m_ingestEnqueued.fetch_add(1, std::memory_order_relaxed);
+
+  // Pairs with the fence in IngestThread(), either the worker sees the new frame or we see it waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_ingestWaiting.load(std::memory_order_relaxed))
+  {
+    std::lock_guard<std::mutex> lock(m_ingestMutex);
+    m_ingestCV.notify_one();
+  }
+}
+
+DMD::IngestStats DMD::GetIngestStats() const
+{
+  IngestStats stats;
+  stats.enqueued = m_ingestEnqueued.load(std::memory_order_relaxed);
+  stats.dropped = m_ingestDropped.load(std::memory_order_relaxed);
+  stats.duplicates = m_ingestDuplicates.load(std::memory_order_relaxed);
+  return stats;
+}
+
+DMD::DumpStats DMD::GetDumpStats() const
+{
+  DumpStats stats;
+  stats.lostFrames = m_dumpLostFrames.load(std::memory_order_relaxed);
+  stats.writtenBytes = m_pDumpWriter ? m_pDumpWriter->GetBytesWritten() : 0;
+  return stats;
+}
+
+DMD::DMDServerStats DMD::GetDMDServerStats() const
+{
+  DMDServerStats stats;
+  stats.frames = m_dmdServerFrames.load(std::memory_order_relaxed);
+  stats.compressedFrames = m_dmdServerCompressedFrames.load(std::memory_order_relaxed);
+  stats.deltaFrames = m_dmdServerDeltaFrames.load(std::memory_order_relaxed);
+  stats.payloadBytes = m_dmdServerPayloadBytes.load(std::memory_order_relaxed);
+  stats.sentBytes = m_dmdServerSentBytes.load(std::memory_order_relaxed);
+  stats.encodeTimeUs = m_dmdServerEncodeTimeUs.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void DMD::IngestThread()
+{
+  Log(DMDUtil_LogLevel_INFO, "IngestThread starts");
+
+  IngestItem item;
+  while (!m_stopFlag.load(std::memory_order_relaxed))
+  {
+    if (m_pIngestQueue->TryPop(item))
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_ingestBlockedProducers.load(std::memory_order_relaxed) > 0)
+      {
+        std::lock_guard<std::mutex> lock(m_ingestMutex);
+        m_ingestSpaceCV.notify_all();
+      }
+
+      PublishUpdate(item);
+      continue;
+    }
+
+    if (m_ingestHasCoalesced.load(std::memory_order_acquire))
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_ingestMutex);
+        item = std::move(*m_pIngestCoalesced);
+        m_ingestHasCoalesced.store(false, std::memory_order_release);
+      }
+
+      if (item.frame) PublishUpdate(item);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_ingestMutex);
+    m_ingestWaiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_ingestCV.wait(lock,
+                    [&]()
+                    {
+                      return m_stopFlag.load(std::memory_order_relaxed) || !m_pIngestQueue->IsEmpty() ||
+                             m_ingestHasCoalesced.load(std::memory_order_relaxed);
+                    });
+    m_ingestWaiting.store(false, std::memory_order_relaxed);
+  }
+
+  Log(DMDUtil_LogLevel_INFO, "IngestThread finished");
+}
+
+void DMD::PublishUpdate(IngestItem& item)
+{
+  const std::shared_ptr<FrameSlot>& frame = item.frame;
+
+  if (item.buffered)
+  {
+    std::lock_guard<std::mutex> lock(m_updateBufferedMutex);
+    m_updateBuffered = frame;
+    m_hasUpdateBuffered = true;
+  }
+
+  // The buffered frame gets queued again, it's already hashed then.
+  if (!frame->hashed)
+  {
+    frame->ClearMissingPayload();
+    frame->ComputeHash();
+  }
+
+  const uint16_t updateBufferQueuePosition =
+      m_pFrameRing->Publish(frame, item.hasTimestamp, item.timestampMs, item.frameContext);
+  if (m_pFrameRing->GetChangedRows(updateBufferQueuePosition % DMDUTIL_FRAME_BUFFER_SIZE) == 0)
+    m_ingestDuplicates.fetch_add(1, std::memory_order_relaxed);
+
+  Log(DMDUtil_LogLevel_DEBUG, "Queued Frame: position=%d, mode=%d, depth=%d", updateBufferQueuePosition, frame->mode,
+      frame->depth);
+
+  const bool sendToDMDServer = !IsSerumMode(frame->mode) || frame->mode == Mode::SerumCommand;
+  if (m_pDMDServerConnector && sendToDMDServer)
+  {
+    if (Config::GetInstance()->GetDMDServerProtocolVersion() >= 2)
+      WriteDMDServerFrame(*frame, item.buffered);
+    else
+      WriteDMDServerUpdate(*frame, item.buffered);
+    m_dmdServerDisconnectOthers = false;
+  }
+}
+
+// Protocol version 1, understood by every dmdserver: the paths and the complete update.
+void DMD::WriteDMDServerUpdate(const FrameSlot& frame, bool buffered)
+{
+  StreamHeader streamHeader;
+  streamHeader.buffered = (uint8_t)buffered;
+  streamHeader.disconnectOthers = (uint8_t)m_dmdServerDisconnectOthers;
+  PathsHeader pathsHeader;
+  strcpy(pathsHeader.name, m_romName);
+  strcpy(pathsHeader.altColorPath, m_altColorPath);
+  strcpy(pathsHeader.pupVideosPath, m_pupVideosPath);
+
+  m_dmdServerBuffer.resize(sizeof(StreamHeader) + sizeof(PathsHeader) + sizeof(Update));
+  uint8_t* pBuffer = m_dmdServerBuffer.data();
+  streamHeader.convertToNetworkByteOrder();
+  memcpy(pBuffer, &streamHeader, sizeof(StreamHeader));
+  pBuffer += sizeof(StreamHeader);
+  pathsHeader.convertToNetworkByteOrder();
+  memcpy(pBuffer, &pathsHeader, sizeof(PathsHeader));
+  pBuffer += sizeof(PathsHeader);
+
+  // The update is serialized in network byte order straight from the frame, what the frame doesn't fill is zeroed
+  // like in a new Update.
+  Update* pUpdate = (Update*)pBuffer;
+  uint8_t* pData = pBuffer + offsetof(Update, data);
+  uint8_t* pSegData = pBuffer + offsetof(Update, segData);
+  uint8_t* pSegData2 = pBuffer + offsetof(Update, segData2);
+  pUpdate->mode = static_cast<Mode>(htonl(static_cast<int>(frame.mode)));
+  pUpdate->layout = static_cast<AlphaNumericLayout>(htonl(static_cast<int>(frame.layout)));
+  pUpdate->depth = htonl(frame.depth);
+  if (frame.dataSize > 0) memcpy(pData, frame.data, frame.dataSize);
+  memset(pData + frame.dataSize, 0, sizeof(Update::data) - frame.dataSize);
+  if (frame.segDataSize > 0) PixelKernels::ConvertByteOrder16(frame.segData, pSegData, frame.segDataSize);
+  memset(pSegData + frame.segDataSize * sizeof(uint16_t), 0,
+         sizeof(Update::segData) - frame.segDataSize * sizeof(uint16_t));
+  if (frame.segData2Size > 0) PixelKernels::ConvertByteOrder16(frame.segData2, pSegData2, frame.segData2Size);
+  memset(pSegData2 + frame.segData2Size * sizeof(uint16_t), 0,
+         sizeof(Update::segData2) - frame.segData2Size * sizeof(uint16_t));
+  pUpdate->hasData = frame.hasData;
+  pUpdate->hasSegData = frame.hasSegData;
+  pUpdate->hasSegData2 = frame.hasSegData2;
+  pUpdate->r = frame.r;
+  pUpdate->g = frame.g;
+  pUpdate->b = frame.b;
+  pUpdate->width = htons(frame.width);
+  pUpdate->height = htons(frame.height);
+
+  m_pDMDServerConnector->Write(m_dmdServerBuffer.data(), m_dmdServerBuffer.size());
+
+  m_dmdServerFrames.fetch_add(1, std::memory_order_relaxed);
+  m_dmdServerPayloadBytes.fetch_add(sizeof(Update), std::memory_order_relaxed);
+  m_dmdServerSentBytes.fetch_add(sizeof(Update), std::memory_order_relaxed);
+}
+
+void DMD::WriteDMDServerFrame(const FrameSlot& frame, bool buffered)
+{
+  FrameHeader frameHeader;
+  frameHeader.mode = frame.mode;
+  frameHeader.layout = frame.layout;
+  frameHeader.depth = frame.depth;
+  frameHeader.r = frame.r;
+  frameHeader.g = frame.g;
+  frameHeader.b = frame.b;
+  frameHeader.width = frame.width;
+  frameHeader.height = frame.height;
+  frameHeader.dataLength = (uint32_t)frame.dataSize;
+  frameHeader.segDataLength = (uint32_t)frame.segDataSize;
+  frameHeader.segData2Length = (uint32_t)frame.segData2Size;
+  if (frame.hasData) frameHeader.flags |= DMDUTIL_FRAME_FLAG_HAS_DATA;
+  if (frame.hasSegData) frameHeader.flags |= DMDUTIL_FRAME_FLAG_HAS_SEG_DATA;
+  if (frame.hasSegData2) frameHeader.flags |= DMDUTIL_FRAME_FLAG_HAS_SEG_DATA2;
+
+  // The paths are only sent if they changed since the last frame.
+  PathsHeader pathsHeader;
+  strcpy(pathsHeader.name, m_romName);
+  strcpy(pathsHeader.altColorPath, m_altColorPath);
+  strcpy(pathsHeader.pupVideosPath, m_pupVideosPath);
+  const bool sendPaths = !m_dmdServerPathsSent || memcmp(&pathsHeader, &m_dmdServerPaths, sizeof(PathsHeader)) != 0;
+  if (sendPaths) frameHeader.flags |= DMDUTIL_FRAME_FLAG_PATHS;
+
+  const size_t payloadLength = frame.dataSize + (frame.segDataSize + frame.segData2Size) * sizeof(uint16_t);
+  m_dmdServerPayload.resize(payloadLength);
+  uint8_t* pPayload = m_dmdServerPayload.data();
+  if (frame.dataSize > 0)
+  {
+    memcpy(pPayload, frame.data, frame.dataSize);
+    pPayload += frame.dataSize;
+  }
+  PixelKernels::ConvertByteOrder16(frame.segData, pPayload, frame.segDataSize);
+  pPayload += frame.segDataSize * sizeof(uint16_t);
+  PixelKernels::ConvertByteOrder16(frame.segData2, pPayload, frame.segData2Size);
+
+  const size_t headerLength = sizeof(StreamHeader) + sizeof(FrameHeader) + (sendPaths ? sizeof(PathsHeader) : 0);
+  size_t sentLength = payloadLength;
+
+  Config* const pConfig = Config::GetInstance();
+  const bool compress = pConfig->IsDMDServerCompression() &&
+                        (frame.mode == Mode::Data || frame.mode == Mode::RGB24 || frame.mode == Mode::RGB16) &&
+                        payloadLength >= DMDUTIL_MIN_COMPRESSION_SIZE;
+
+  // XOR the payload with the previous one, mostly zeros remain which compress well.
+  // The reference is swapped in place, it holds the current payload afterwards.
+  bool delta = false;
+  if (compress && pConfig->IsDMDServerDelta())
+  {
+    delta = m_dmdServerFramesSinceKeyframe < DMDUTIL_DELTA_KEYFRAME_INTERVAL &&
+            m_dmdServerReference.size() == payloadLength && m_dmdServerReferenceHeader.mode == frameHeader.mode &&
+            m_dmdServerReferenceHeader.width == frameHeader.width &&
+            m_dmdServerReferenceHeader.height == frameHeader.height &&
+            m_dmdServerReferenceHeader.dataLength == frameHeader.dataLength &&
+            m_dmdServerReferenceHeader.segDataLength == frameHeader.segDataLength;
+    if (delta)
+    {
+      uint8_t* pReference = m_dmdServerReference.data();
+      pPayload = m_dmdServerPayload.data();
+      for (size_t i = 0; i < payloadLength; i++)
+      {
+        const uint8_t value = pPayload[i];
+        pPayload[i] ^= pReference[i];
+        pReference[i] = value;
+      }
+    }
+    else
+    {
+      m_dmdServerReference.assign(m_dmdServerPayload.begin(), m_dmdServerPayload.end());
+    }
+    m_dmdServerReferenceHeader = frameHeader;
+  }
+  else
+  {
+    m_dmdServerReference.clear();
+  }
+
+  if (compress)
+  {
+    auto start = std::chrono::steady_clock::now();
+    mz_ulong compressedLength = mz_compressBound((mz_ulong)payloadLength);
+    m_dmdServerBuffer.resize(headerLength + compressedLength);
+    if (mz_compress2(m_dmdServerBuffer.data() + headerLength, &compressedLength, m_dmdServerPayload.data(),
+                     (mz_ulong)payloadLength, MZ_BEST_SPEED) == MZ_OK &&
+        compressedLength < payloadLength)
+    {
+      frameHeader.flags |= DMDUTIL_FRAME_FLAG_COMPRESSED;
+      sentLength = compressedLength;
+      m_dmdServerCompressedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (delta)
+    {
+      // Send the complete frame instead, it becomes the next keyframe.
+      memcpy(m_dmdServerPayload.data(), m_dmdServerReference.data(), payloadLength);
+      delta = false;
+    }
+    m_dmdServerEncodeTimeUs.fetch_add(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(),
+        std::memory_order_relaxed);
+  }
+
+  if (delta)
+  {
+    frameHeader.flags |= DMDUTIL_FRAME_FLAG_DELTA;
+    m_dmdServerFramesSinceKeyframe++;
+    m_dmdServerDeltaFrames.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
+  {
+    m_dmdServerFramesSinceKeyframe = 0;
+  }
+
+  m_dmdServerBuffer.resize(headerLength + sentLength);
+  uint8_t* pBuffer = m_dmdServerBuffer.data();
+  if (!(frameHeader.flags & DMDUTIL_FRAME_FLAG_COMPRESSED))
+    memcpy(pBuffer + headerLength, m_dmdServerPayload.data(), payloadLength);
+
+  StreamHeader streamHeader;
+  streamHeader.version = 2;
+  streamHeader.mode = frame.mode;
+  streamHeader.width = frame.width;
+  streamHeader.height = frame.height;
+  streamHeader.buffered = (uint8_t)buffered;
+  streamHeader.disconnectOthers = (uint8_t)m_dmdServerDisconnectOthers;
+  streamHeader.length = (uint32_t)(headerLength - sizeof(StreamHeader) + sentLength);
+  streamHeader.convertToNetworkByteOrder();
+  memcpy(pBuffer, &streamHeader, sizeof(StreamHeader));
+  pBuffer += sizeof(StreamHeader);
+  frameHeader.convertToNetworkByteOrder();
+  memcpy(pBuffer, &frameHeader, sizeof(FrameHeader));
+  pBuffer += sizeof(FrameHeader);
+  if (sendPaths)
+  {
+    memcpy(&m_dmdServerPaths, &pathsHeader, sizeof(PathsHeader));
+    m_dmdServerPathsSent = true;
+    pathsHeader.convertToNetworkByteOrder();
+    memcpy(pBuffer, &pathsHeader, sizeof(PathsHeader));
+  }
+
+  m_pDMDServerConnector->Write(m_dmdServerBuffer.data(), m_dmdServerBuffer.size());
+
+  m_dmdServerFrames.fetch_add(1, std::memory_order_relaxed);
+  m_dmdServerPayloadBytes.fetch_add(payloadLength, std::memory_order_relaxed);
+  m_dmdServerSentBytes.fetch_add(sentLength, std::memory_order_relaxed);
 }
 
 bool DMD::QueueBuffer()
 {
-  if (m_hasUpdateBuffered)
+  std::shared_ptr<FrameSlot> frame;
   {
-    QueueUpdate(m_updateBuffered, false);
+    std::lock_guard<std::mutex> lock(m_updateBufferedMutex);
+    if (!m_hasUpdateBuffered) return false;
+    frame = m_updateBuffered;
   }
 
-  return m_hasUpdateBuffered;
+  // Queued frames are never modified, so the buffered one could simply be queued again.
+  QueueFrame(frame, false);
+  return true;
+}
+
+std::shared_ptr<FrameSlot> DMD::GetQueuedFrame(uint8_t bufferPositionMod)
+{
+  return m_pFrameRing->GetFrame(bufferPositionMod);
+}
+
+void DMD::SkipLostDumpFrames(uint16_t& bufferPosition, uint16_t queuePosition, const char* dumper)
+{
+  // Only the last DMDUTIL_FRAME_BUFFER_SIZE frames are kept, older ones have already been replaced.
+  const uint16_t behind = queuePosition - bufferPosition;
+  if (behind <= DMDUTIL_FRAME_BUFFER_SIZE) return;
+
+  const uint16_t lost = behind - DMDUTIL_FRAME_BUFFER_SIZE;
+  bufferPosition += lost;
+  m_dumpLostFrames.fetch_add(lost, std::memory_order_relaxed);
+  Log(DMDUtil_LogLevel_ERROR, "%s: Lost %d frames, the dump can't keep up", dumper, lost);
 }
 
 void DMD::UpdateData(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r, uint8_t g, uint8_t b,
@@ -817,27 +1280,24 @@ void DMD::UpdateDataWithMetadataAndTimestamp(const uint8_t* pData, int depth, ui
                                              uint8_t r, uint8_t g, uint8_t b, uint32_t timestampMs,
                                              const FrameContext& frameContext, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::Data, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->data, pData, (size_t)width * height);
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->data, pData, frame->dataSize);
+    frame->hasData = true;
   }
-  dmdUpdate->mode = Mode::Data;
-  dmdUpdate->depth = depth;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
-  dmdUpdate->r = r;
-  dmdUpdate->g = g;
-  dmdUpdate->b = b;
+  frame->depth = depth;
+  frame->r = r;
+  frame->g = g;
+  frame->b = b;
 
-  QueueUpdate(dmdUpdate, buffered, true, timestampMs, &frameContext);
+  QueueFrame(frame, buffered, true, timestampMs, &frameContext);
 }
 
 void DMD::UpdateRGB24Data(const uint8_t* pData, int depth, uint16_t width, uint16_t height, uint8_t r, uint8_t g,
@@ -866,127 +1326,105 @@ void DMD::UpdateRGB24DataWithTimestamp(const uint8_t* pData, uint16_t width, uin
 void DMD::UpdateRGB24DataWithMetadataAndTimestamp(const uint8_t* pData, uint16_t width, uint16_t height,
                                                   uint32_t timestampMs, const FrameContext& frameContext, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  dmdUpdate->mode = Mode::RGB24;
-  dmdUpdate->depth = 24;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::RGB24, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->data, pData, (size_t)width * height * 3u);
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  frame->depth = 24;
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->data, pData, frame->dataSize);
+    frame->hasData = true;
   }
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
 
-  QueueUpdate(dmdUpdate, buffered, true, timestampMs, &frameContext);
+  QueueFrame(frame, buffered, true, timestampMs, &frameContext);
 }
 
 void DMD::UpdateRGB16Data(const uint16_t* pData, uint16_t width, uint16_t height, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  dmdUpdate->mode = Mode::RGB16;
-  dmdUpdate->depth = 24;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::RGB16, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->segData, pData, (size_t)width * height * sizeof(uint16_t));
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  frame->depth = 24;
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->segData, pData, frame->segDataSize * sizeof(uint16_t));
+    frame->hasData = true;
   }
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
 
-  QueueUpdate(dmdUpdate, buffered);
+  QueueFrame(frame, buffered);
 }
 
 void DMD::UpdateRGB16DataWithTimestamp(const uint16_t* pData, uint16_t width, uint16_t height, uint32_t timestampMs,
                                        bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  dmdUpdate->mode = Mode::RGB16;
-  dmdUpdate->depth = 24;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::RGB16, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->segData, pData, (size_t)width * height * sizeof(uint16_t));
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  frame->depth = 24;
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->segData, pData, frame->segDataSize * sizeof(uint16_t));
+    frame->hasData = true;
   }
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
 
-  QueueUpdate(dmdUpdate, buffered, true, timestampMs);
+  QueueFrame(frame, buffered, true, timestampMs);
 }
 
 void DMD::UpdateRGB16DataWithMetadataAndTimestamp(const uint16_t* pData, uint16_t width, uint16_t height,
                                                   uint32_t timestampMs, const FrameContext& frameContext, bool buffered)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  dmdUpdate->mode = Mode::RGB16;
-  dmdUpdate->depth = 24;
-  dmdUpdate->width = width;
-  dmdUpdate->height = height;
-  if (pData)
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::RGB16, width, height);
+  if (!frame)
   {
-    memcpy(dmdUpdate->segData, pData, (size_t)width * height * sizeof(uint16_t));
-    dmdUpdate->hasData = true;
+    Log(DMDUtil_LogLevel_ERROR, "Invalid frame size %ux%u, skipping frame", width, height);
+    return;
   }
-  else
+
+  frame->depth = 24;
+  if (pData)
   {
-    dmdUpdate->hasData = false;
+    memcpy(frame->segData, pData, frame->segDataSize * sizeof(uint16_t));
+    frame->hasData = true;
   }
-  dmdUpdate->hasSegData = false;
-  dmdUpdate->hasSegData2 = false;
 
-  QueueUpdate(dmdUpdate, buffered, true, timestampMs, &frameContext);
+  QueueFrame(frame, buffered, true, timestampMs, &frameContext);
 }
 
 void DMD::UpdateAlphaNumericData(AlphaNumericLayout layout, const uint16_t* pData1, const uint16_t* pData2, uint8_t r,
                                  uint8_t g, uint8_t b)
 {
-  auto dmdUpdate = std::make_shared<Update>();
-  dmdUpdate->mode = Mode::AlphaNumeric;
-  dmdUpdate->layout = layout;
-  dmdUpdate->depth = 2;
-  dmdUpdate->width = 128;
-  dmdUpdate->height = 32;
-  dmdUpdate->hasData = false;
+  // With an HD display connected the segments are rendered in 256x64 instead of being scaled up later.
+  const bool hd = HasHDDisplay();
+  std::shared_ptr<FrameSlot> frame = m_pFrameSlotPool->Acquire(Mode::AlphaNumeric, hd ? 256 : 128, hd ? 64 : 32);
+  frame->layout = layout;
+  frame->depth = 2;
   if (pData1)
   {
-    memcpy(dmdUpdate->segData, pData1, 128 * sizeof(uint16_t));
-    dmdUpdate->hasSegData = true;
-  }
-  else
-  {
-    dmdUpdate->hasSegData = false;
+    memcpy(frame->segData, pData1, 128 * sizeof(uint16_t));
+    frame->hasSegData = true;
   }
   if (pData2)
   {
-    memcpy(dmdUpdate->segData2, pData2, 128 * sizeof(uint16_t));
-    dmdUpdate->hasSegData2 = true;
-  }
-  else
-  {
-    dmdUpdate->hasSegData2 = false;
+    memcpy(frame->segData2, pData2, 128 * sizeof(uint16_t));
+    frame->hasSegData2 = true;
   }
-  dmdUpdate->r = r;
-  dmdUpdate->g = g;
-  dmdUpdate->b = b;
+  frame->r = r;
+  frame->g = g;
+  frame->b = b;
 
-  QueueUpdate(dmdUpdate, false);
+  QueueFrame(frame, false);
 }
 
 bool DMD::WaitForSerumColorizeCapture(uint64_t sourceOrdinal, SerumCapture& capture, uint32_t timeoutMs)
@@ -1184,25 +1622,76 @@ uint16_t DMD::GetNextBufferQueuePosition(uint16_t bufferPosition, const uint16_t
   return bufferPosition;
 }
 
+uint16_t DMD::GetNextBufferQueuePosition(FramePacer& pacer, uint16_t bufferPosition,
+                                         const uint16_t updateBufferQueuePosition)
+{
+  // The difference wraps around correctly if updateBufferQueuePosition crossed the overflow point.
+  const uint16_t framesBehind = updateBufferQueuePosition - bufferPosition;
+  if (framesBehind == 0)
+  {
+    return bufferPosition;  // No change, return current position
+  }
+
+  const uint16_t maxFramesBehind = pacer.GetMaxFramesBehind();
+  if (framesBehind > maxFramesBehind)
+  {
+    // Too many frames behind for this device, skip a lot
+    pacer.AddSkippedFrames(framesBehind - DMDUTIL_MIN_FRAMES_BEHIND - 1, false);
+    return updateBufferQueuePosition - DMDUTIL_MIN_FRAMES_BEHIND;
+  }
+
+  const uint16_t nextBufferPosition = bufferPosition + 1;
+  if (framesBehind > maxFramesBehind / 4 && nextBufferPosition != updateBufferQueuePosition)
+  {
+    // Falling behind. Skip the next frame if the one after it looks the same, nothing visible gets lost then. If the
+    // device falls further behind, skip one frame anyway.
+    const bool nearDuplicate = GetQueuedFrame(nextBufferPosition % DMDUTIL_FRAME_BUFFER_SIZE)
+                                   ->IsNearDuplicate(*GetQueuedFrame((uint16_t)(nextBufferPosition + 1) %
+                                                                     DMDUTIL_FRAME_BUFFER_SIZE));
+    if (nearDuplicate || framesBehind > maxFramesBehind / 2)
+    {
+      pacer.AddSkippedFrames(1, nearDuplicate);
+      return nextBufferPosition + 1;
+    }
+  }
+
+  return nextBufferPosition;
+}
+
+bool DMD::PaceFrame(FramePacer& pacer, uint16_t bufferPosition, const uint16_t updateBufferQueuePosition, Mode mode)
+{
+  uint32_t timestampMs = 0;
+  const bool hasTimestamp = GetQueueTimestamp(bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE, timestampMs);
+
+  // Only a following frame of the same mode replaces this one on the display.
+  uint32_t nextTimestampMs = 0;
+  bool hasNextTimestamp = false;
+  if (hasTimestamp && bufferPosition != updateBufferQueuePosition)
+  {
+    const uint8_t nextBufferPositionMod = (uint16_t)(bufferPosition + 1) % DMDUTIL_FRAME_BUFFER_SIZE;
+    std::shared_ptr<FrameSlot> nextFrame = GetQueuedFrame(nextBufferPositionMod);
+    hasNextTimestamp = nextFrame->mode == mode && GetQueueTimestamp(nextBufferPositionMod, nextTimestampMs);
+  }
+
+  if (!pacer.Schedule(hasTimestamp, timestampMs, hasNextTimestamp, nextTimestampMs)) return false;
+
+  pacer.WaitForDeadline(m_stopFlag);
+  return true;
+}
+
 void DMD::DmdFrameThread()
 {
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
   uint16_t bufferPosition = 0;
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
 
-    bufferPosition = m_updateBufferQueuePosition.load(std::memory_order_relaxed);
+    bufferPosition = m_pFrameRing->GetPosition();
 
     if (strcmp(m_romName, name) != 0)
     {
@@ -1229,12 +1718,14 @@ void DMD::ZeDMDThread()
   uint16_t frameSize = 0;
   uint16_t segData1[128] = {0};
   uint16_t segData2[128] = {0};
-  uint8_t palette[256 * 3] = {0};
-  uint8_t indexBuffer[256 * 64] = {0};
+  uint32_t paletteGeneration = 0;
   uint8_t renderBuffer[256 * 64 * 3] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
+  FramePacer pacer("ZeDMD");
+  FrameChangeTracker changeTracker(*m_pFrameRing);
   Config* const pConfig = Config::GetInstance();
   bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
   bool excludeColorizedFrames = pConfig->IsExcludeColorizedFramesForZeDMD();
@@ -1242,24 +1733,17 @@ void DMD::ZeDMDThread()
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
 
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
-      uint16_t nextBufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
+      uint16_t nextBufferPosition = GetNextBufferQueuePosition(pacer, bufferPosition, updateBufferQueuePosition);
       if (nextBufferPosition > bufferPosition && (nextBufferPosition - bufferPosition) > 1)
       {
         Log(DMDUtil_LogLevel_INFO, "ZeDMD: Skipping %d frame(s) from position %d to %d",
@@ -1272,8 +1756,9 @@ void DMD::ZeDMDThread()
       }
       bufferPosition = nextBufferPosition;
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      const Mode updateMode = m_pUpdateBufferQueue[bufferPositionMod]->mode;
+      const Mode updateMode = frame->mode;
       if (excludeColorizedFrames)
       {
         if (IsSerumMode(updateMode, true)) continue;
@@ -1285,17 +1770,20 @@ void DMD::ZeDMDThread()
         continue;
       }
 
+      if (!PaceFrame(pacer, bufferPosition, updateBufferQueuePosition, updateMode)) continue;
+
       // Note: libzedmd has its own update detection.
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->hasData || m_pUpdateBufferQueue[bufferPositionMod]->hasSegData)
+      if (frame->hasData || frame->hasSegData)
       {
-        if (m_pUpdateBufferQueue[bufferPositionMod]->width != width ||
-            m_pUpdateBufferQueue[bufferPositionMod]->height != height)
+        if (changeTracker.Track(bufferPosition) == 0) continue;
+
+        if (frame->width != width || frame->height != height)
         {
-          Log(DMDUtil_LogLevel_INFO, "ZeDMD: Change frame size from %dx%d to %dx%d", width, height,
-              m_pUpdateBufferQueue[bufferPositionMod]->width, m_pUpdateBufferQueue[bufferPositionMod]->height);
-          width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-          height = m_pUpdateBufferQueue[bufferPositionMod]->height;
+          Log(DMDUtil_LogLevel_INFO, "ZeDMD: Change frame size from %dx%d to %dx%d", width, height, frame->width,
+              frame->height);
+          width = frame->width;
+          height = frame->height;
           const size_t framePixels = (size_t)width * height;
           if (framePixels == 0 || framePixels > kMaxFramePixels)
           {
@@ -1314,99 +1802,74 @@ void DMD::ZeDMDThread()
             bufferPositionMod);
 
         bool update = false;
-        if (m_pUpdateBufferQueue[bufferPositionMod]->depth != 24)
+        if (frame->depth != 24)
         {
-          update = UpdatePalette(palette, m_pUpdateBufferQueue[bufferPositionMod]->depth,
-                                 m_pUpdateBufferQueue[bufferPositionMod]->r, m_pUpdateBufferQueue[bufferPositionMod]->g,
-                                 m_pUpdateBufferQueue[bufferPositionMod]->b);
+          update = UpdatePalette(paletteGeneration, frame->depth, frame->r, frame->g, frame->b);
         }
 
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24)
+        if (frame->mode == Mode::RGB24)
         {
           // ZeDMD HD supports 256 * 64 pixels.
-          uint8_t rgb24Data[256 * 64 * 3];
-          const size_t rgb24Len = (size_t)width * height * 3u;
-          if (rgb24Len == 0 || rgb24Len > kMaxRgb24Bytes)
+          const uint8_t* pRgb888 = RenderRgb888(*frame);
+          if (!pRgb888)
           {
             Log(DMDUtil_LogLevel_ERROR, "ZeDMD: Invalid RGB24 frame payload for %ux%u, skipping frame", width, height);
             continue;
           }
 
-          AdjustRGB24Depth(m_pUpdateBufferQueue[bufferPositionMod]->data, rgb24Data, (size_t)width * height, palette,
-                           m_pUpdateBufferQueue[bufferPositionMod]->depth);
-          ApplyRoundedCornersRGB24(rgb24Data, width, height, roundedCorners);
-          m_pZeDMD->RenderRgb888(rgb24Data);
+          memcpy(renderBuffer, pRgb888, (size_t)frameSize * 3);
+          ApplyRoundedCornersRGB24(renderBuffer, width, height, roundedCorners);
+          FramePacer::RenderScope renderScope(pacer);
+          m_pZeDMD->RenderRgb888(renderBuffer);
         }
-        else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB16 ||
-                 (m_pSerum && IsSerumV2Mode(m_pUpdateBufferQueue[bufferPositionMod]->mode)))
+        else if (frame->mode == Mode::RGB16 || (m_pSerum && IsSerumV2Mode(frame->mode)))
         {
           uint16_t rgb565Data[256 * 64];
-          memcpy(rgb565Data, m_pUpdateBufferQueue[bufferPositionMod]->segData, (size_t)frameSize * sizeof(uint16_t));
+          memcpy(rgb565Data, frame->segData, (size_t)frameSize * sizeof(uint16_t));
           ApplyRoundedCornersRGB565(rgb565Data, width, height, roundedCorners);
+          FramePacer::RenderScope renderScope(pacer);
           m_pZeDMD->RenderRgb565(rgb565Data);
         }
         else
         {
-          if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV1 ||
-              m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Vni)
+          bool render = false;
+          if (frame->mode == Mode::SerumV1 || frame->mode == Mode::Vni)
           {
-            size_t paletteBytes = PaletteBytesForDepth((uint8_t)m_pUpdateBufferQueue[bufferPositionMod]->depth);
-            if (paletteBytes > 0 && paletteBytes <= sizeof(palette))
-            {
-              memcpy(palette, m_pUpdateBufferQueue[bufferPositionMod]->segData, paletteBytes);
-            }
-            memcpy(indexBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, frameSize);
             update = true;
+            render = true;
           }
-          else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) &&
-                    m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data) ||
-                   (showNotColorizedFrames && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::NotColorized))
+          else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) && frame->mode == Mode::Data) ||
+                   (showNotColorizedFrames && frame->mode == Mode::NotColorized))
           {
-            memcpy(indexBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, frameSize);
             update = true;
+            render = true;
           }
-          else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::AlphaNumeric)
+          else if (frame->mode == Mode::AlphaNumeric)
           {
-            if (memcmp(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1)) != 0)
+            if (memcmp(segData1, frame->segData, sizeof(segData1)) != 0)
             {
-              memcpy(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1));
+              memcpy(segData1, frame->segData, sizeof(segData1));
               update = true;
             }
 
-            if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2 &&
-                memcmp(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2)) != 0)
+            if (frame->hasSegData2 && memcmp(segData2, frame->segData2, sizeof(segData2)) != 0)
             {
-              memcpy(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2));
+              memcpy(segData2, frame->segData2, sizeof(segData2));
               update = true;
             }
-
-            if (update)
-            {
-              if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2)
-                m_pAlphaNumeric->Render(indexBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1,
-                                        segData2);
-              else
-                m_pAlphaNumeric->Render(indexBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1);
-            }
+            render = true;
           }
 
-          if (update)
+          if (update && render)
           {
-            uint16_t renderBuferPosition = 0;
-            for (int i = 0; i < frameSize; i++)
-            {
-              int pos = indexBuffer[i] * 3;
-              renderBuffer[renderBuferPosition++] = palette[pos];
-              renderBuffer[renderBuferPosition++] = palette[pos + 1];
-              renderBuffer[renderBuferPosition++] = palette[pos + 2];
-            }
-          }
-        }
+            const uint8_t* pRgb888 = RenderRgb888(*frame);
+            if (!pRgb888) continue;
 
-        if (update)
-        {
-          ApplyRoundedCornersRGB24(renderBuffer, width, height, roundedCorners);
-          m_pZeDMD->RenderRgb888(renderBuffer);
+            memcpy(renderBuffer, pRgb888, (size_t)frameSize * 3);
+            ApplyRoundedCornersRGB24(renderBuffer, width, height, roundedCorners);
+            FramePacer::RenderScope renderScope(pacer);
+            m_pZeDMD->RenderRgb888(renderBuffer);
+          }
         }
       }
     }
@@ -1428,10 +1891,11 @@ void DMD::SerumThread()
     char name[DMDUTIL_MAX_NAME_SIZE] = {0};
     char csvPath[DMDUTIL_MAX_PATH_SIZE + DMDUTIL_MAX_NAME_SIZE + DMDUTIL_MAX_NAME_SIZE + 10] = {0};
     uint32_t nextRotation = 0;
-    Update* lastDmdUpdate = nullptr;
+    std::shared_ptr<FrameSlot> lastDmdUpdate;
     uint8_t flags = 0;
 
     (void)m_stopFlag.load(std::memory_order_acquire);
+    FrameRing::Subscription subscription(*m_pFrameRing);
 
     bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
     bool dumpNotColorizedFrames = pConfig->IsDumpNotColorizedFrames();
@@ -1453,33 +1917,26 @@ void DMD::SerumThread()
 
       if (nextRotation == 0)
       {
-        std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-        m_dmdCV.wait(sl,
-                     [&]()
-                     {
-                       return m_stopFlag.load(std::memory_order_relaxed) ||
-                              (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                     });
-        sl.unlock();
+        subscription.Wait(bufferPosition, m_stopFlag);
       }
 
       uint32_t now = GetMonotonicTimeMs();
 
-      const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+      const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
       while (bufferPosition != updateBufferQueuePosition)
       {
         // Don't use GetNextBufferPosition() here, we need all frames for PUP triggers!
         ++bufferPosition;  // 65635 + 1 = 0
         uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+        std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumCommand)
+        if (frame->mode == Mode::SerumCommand)
         {
-          if (m_pSerum && m_pUpdateBufferQueue[bufferPositionMod]->hasData &&
-              m_pUpdateBufferQueue[bufferPositionMod]->hasSegData)
+          if (m_pSerum && frame->hasData && frame->hasSegData)
           {
-            const char source = static_cast<char>(m_pUpdateBufferQueue[bufferPositionMod]->data[0]);
-            const uint8_t value = m_pUpdateBufferQueue[bufferPositionMod]->data[1];
-            const uint16_t event = m_pUpdateBufferQueue[bufferPositionMod]->segData[0];
+            const char source = static_cast<char>(frame->data[0]);
+            const uint8_t value = frame->data[1];
+            const uint16_t event = frame->segData[0];
 
             if (source == 'D' && value == 1 && event >= kSerumTriggerMinEvent && event <= kSerumTriggerMaxEvent)
             {
@@ -1487,8 +1944,8 @@ void DMD::SerumThread()
 
               if (result != IDENTIFY_NO_FRAME && result != IDENTIFY_SAME_FRAME && lastDmdUpdate)
               {
-                QueueSerumFrames(lastDmdUpdate, flags & FLAG_REQUEST_32P_FRAMES, flags & FLAG_REQUEST_64P_FRAMES, false,
-                                 0);
+                QueueSerumFrames(lastDmdUpdate.get(), flags & FLAG_REQUEST_32P_FRAMES, flags & FLAG_REQUEST_64P_FRAMES,
+                                 false, 0);
               }
 
               if (result > 0 && ((result & 0xffff) < 2048))
@@ -1504,21 +1961,20 @@ void DMD::SerumThread()
           continue;
         }
 
-        if (m_pSerum && (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24 ||
-                         m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB16))
+        if (m_pSerum && (frame->mode == Mode::RGB24 || frame->mode == Mode::RGB16))
         {
           // DMDServer accepted a different connection, turn off Serum Colorization.
           Serum_Dispose();
           m_pSerum = nullptr;
           m_serumHasTimestamp = false;
           m_serumLastTimestampMs = 0;
-          lastDmdUpdate = nullptr;
+          lastDmdUpdate.reset();
           strcpy(name, "");
           QueueBuffer();
           continue;
         }
 
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data)
+        if (frame->mode == Mode::Data)
         {
           if (strcmp(m_romName, name) != 0)
           {
@@ -1537,7 +1993,7 @@ void DMD::SerumThread()
               m_pSerum = nullptr;
               m_serumHasTimestamp = false;
               m_serumLastTimestampMs = 0;
-              lastDmdUpdate = nullptr;
+              lastDmdUpdate.reset();
             }
 
             if (m_altColorPath[0] == '\0') strcpy(m_altColorPath, Config::GetInstance()->GetAltColorPath());
@@ -1632,7 +2088,7 @@ void DMD::SerumThread()
             GetQueueFrameContext(bufferPositionMod, frameContext);
 
             const auto colorizeStart = std::chrono::steady_clock::now();
-            uint32_t result = Serum_Colorize(m_pUpdateBufferQueue[bufferPositionMod]->data);
+            uint32_t result = Serum_Colorize(frame->data);
             const uint32_t colorizeTimeUs = static_cast<uint32_t>(
                 std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - colorizeStart)
                     .count());
@@ -1653,13 +2109,13 @@ void DMD::SerumThread()
               // Log(DMDUtil_LogLevel_DEBUG, "Serum: frameID=%lu, rotation=%lu, flags=%lu", m_pSerum->frameID,
               // m_pSerum->rotationtimer, m_pSerum->flags);
 
-              lastDmdUpdate = m_pUpdateBufferQueue[bufferPositionMod];
+              lastDmdUpdate = frame;
 
               uint32_t queuedTimestamp = 0;
               bool hasTimestamp = GetQueueTimestamp(bufferPositionMod, queuedTimestamp);
 
-              std::shared_ptr<Update> primaryOutput;
-              QueueSerumFrames(lastDmdUpdate, flags & FLAG_REQUEST_32P_FRAMES, flags & FLAG_REQUEST_64P_FRAMES,
+              std::shared_ptr<FrameSlot> primaryOutput;
+              QueueSerumFrames(lastDmdUpdate.get(), flags & FLAG_REQUEST_32P_FRAMES, flags & FLAG_REQUEST_64P_FRAMES,
                                hasTimestamp, queuedTimestamp, &primaryOutput);
               RecordSerumColorizeCapture(frameContext, primaryOutput, hasTimestamp, queuedTimestamp, false, result,
                                          runtimeMetadata.serumVersion, runtimeMetadata.frameID,
@@ -1685,29 +2141,23 @@ void DMD::SerumThread()
             {
               Log(DMDUtil_LogLevel_DEBUG, "Serum: unidentified frame detected");
 
-              auto noSerumUpdate = std::make_shared<Update>();
-              noSerumUpdate->mode = Mode::NotColorized;
-              noSerumUpdate->depth = m_pUpdateBufferQueue[bufferPositionMod]->depth;
-              noSerumUpdate->width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-              noSerumUpdate->height = m_pUpdateBufferQueue[bufferPositionMod]->height;
+              std::shared_ptr<FrameSlot> noSerumUpdate =
+                  m_pFrameSlotPool->Acquire(Mode::NotColorized, frame->width, frame->height);
+              noSerumUpdate->depth = frame->depth;
               noSerumUpdate->hasData = true;
-              noSerumUpdate->hasSegData = false;
-              noSerumUpdate->hasSegData2 = false;
-              memcpy(noSerumUpdate->data, m_pUpdateBufferQueue[bufferPositionMod]->data,
-                     (size_t)m_pUpdateBufferQueue[bufferPositionMod]->width *
-                         m_pUpdateBufferQueue[bufferPositionMod]->height);
+              memcpy(noSerumUpdate->data, frame->data, noSerumUpdate->dataSize);
 
               uint32_t queuedTimestamp = 0;
               bool hasTimestamp = GetQueueTimestamp(bufferPositionMod, queuedTimestamp);
-              QueueUpdate(noSerumUpdate, false, hasTimestamp, queuedTimestamp);
-              RecordSerumColorizeCapture(frameContext, std::shared_ptr<Update>(), hasTimestamp, queuedTimestamp, false,
-                                         result, runtimeMetadata.serumVersion, runtimeMetadata.frameID,
+              QueueFrame(noSerumUpdate, false, hasTimestamp, queuedTimestamp);
+              RecordSerumColorizeCapture(frameContext, std::shared_ptr<FrameSlot>(), hasTimestamp, queuedTimestamp,
+                                         false, result, runtimeMetadata.serumVersion, runtimeMetadata.frameID,
                                          runtimeMetadata.triggerID, runtimeMetadata.rotationtimer,
                                          runtimeMetadata.featureFlags, colorizeTimeUs, averageColorizeTimeUs);
             }
             else
             {
-              RecordSerumColorizeCapture(frameContext, std::shared_ptr<Update>(), false, 0, false, result,
+              RecordSerumColorizeCapture(frameContext, std::shared_ptr<FrameSlot>(), false, 0, false, result,
                                          runtimeMetadata.serumVersion, runtimeMetadata.frameID,
                                          runtimeMetadata.triggerID, runtimeMetadata.rotationtimer,
                                          runtimeMetadata.featureFlags, colorizeTimeUs, averageColorizeTimeUs);
@@ -1724,7 +2174,7 @@ void DMD::SerumThread()
 
           Log(DMDUtil_LogLevel_DEBUG, "Serum: rotation=%lu, flags=%lu", m_pSerum->rotationtimer, result >> 16);
 
-          QueueSerumFrames(lastDmdUpdate, result & 0x10000, result & 0x20000, false, 0);
+          QueueSerumFrames(lastDmdUpdate.get(), result & 0x10000, result & 0x20000, false, 0);
 
           if (result > 0 && ((result & 0xffff) < 2048))
           {
@@ -1752,20 +2202,14 @@ void DMD::VniThread()
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
   bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
   bool dumpNotColorizedFrames = pConfig->IsDumpNotColorizedFrames();
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
 
     if (m_stopFlag.load(std::memory_order_acquire))
     {
@@ -1777,11 +2221,12 @@ void DMD::VniThread()
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (bufferPosition != updateBufferQueuePosition)
     {
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
       if (m_pSerum)
       {
@@ -1794,8 +2239,7 @@ void DMD::VniThread()
         continue;
       }
 
-      if (m_pVni && (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24 ||
-                     m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB16))
+      if (m_pVni && (frame->mode == Mode::RGB24 || frame->mode == Mode::RGB16))
       {
         Vni_Dispose(m_pVni);
         m_pVni = nullptr;
@@ -1804,7 +2248,7 @@ void DMD::VniThread()
         continue;
       }
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data)
+      if (frame->mode == Mode::Data)
       {
         if (strcmp(m_romName, name) != 0)
         {
@@ -1847,35 +2291,33 @@ void DMD::VniThread()
 
         if (m_pVni)
         {
-          uint16_t width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-          uint16_t height = m_pUpdateBufferQueue[bufferPositionMod]->height;
-          uint8_t depth = (uint8_t)m_pUpdateBufferQueue[bufferPositionMod]->depth;
+          uint16_t width = frame->width;
+          uint16_t height = frame->height;
+          uint8_t depth = (uint8_t)frame->depth;
 
-          uint32_t result = Vni_Colorize(m_pVni, m_pUpdateBufferQueue[bufferPositionMod]->data, width, height, depth);
+          uint32_t result = Vni_Colorize(m_pVni, frame->data, width, height, depth);
           if (result)
           {
-            const Vni_Frame_Struc* frame = Vni_GetFrame(m_pVni);
-            if (frame && frame->has_frame && frame->frame && frame->palette && frame->bitlen <= 8)
+            const Vni_Frame_Struc* vniFrame = Vni_GetFrame(m_pVni);
+            if (vniFrame && vniFrame->has_frame && vniFrame->frame && vniFrame->palette && vniFrame->bitlen <= 8)
             {
-              const size_t frameSize = (size_t)frame->width * frame->height;
-              const size_t paletteSize = (size_t)1u << frame->bitlen;
+              const size_t frameSize = (size_t)vniFrame->width * vniFrame->height;
+              const size_t paletteSize = (size_t)1u << vniFrame->bitlen;
 
               if (frameSize <= (256u * 64u) && paletteSize <= 256u)
               {
-                auto vniUpdate = std::make_shared<Update>();
-                vniUpdate->mode = Mode::Vni;
-                vniUpdate->depth = frame->bitlen;
-                vniUpdate->width = (uint16_t)frame->width;
-                vniUpdate->height = (uint16_t)frame->height;
+                std::shared_ptr<FrameSlot> vniUpdate =
+                    m_pFrameSlotPool->Acquire(Mode::Vni, (uint16_t)vniFrame->width, (uint16_t)vniFrame->height);
+                vniUpdate->depth = vniFrame->bitlen;
                 vniUpdate->hasData = true;
-                vniUpdate->hasSegData = false;
-                vniUpdate->hasSegData2 = false;
-                memcpy(vniUpdate->data, frame->frame, frameSize);
-                memcpy(vniUpdate->segData, frame->palette, paletteSize * 3);
+                memcpy(vniUpdate->data, vniFrame->frame, frameSize);
+                memcpy(vniUpdate->segData, vniFrame->palette, paletteSize * 3);
+                memset((uint8_t*)vniUpdate->segData + paletteSize * 3, 0,
+                       vniUpdate->segDataSize * sizeof(uint16_t) - paletteSize * 3);
 
                 uint32_t queuedTimestamp = 0;
                 bool hasTimestamp = GetQueueTimestamp(bufferPositionMod, queuedTimestamp);
-                QueueUpdate(vniUpdate, false, hasTimestamp, queuedTimestamp);
+                QueueFrame(vniUpdate, false, hasTimestamp, queuedTimestamp);
               }
             }
           }
@@ -1883,21 +2325,15 @@ void DMD::VniThread()
           {
             Log(DMDUtil_LogLevel_DEBUG, "VNI: unidentified frame detected");
 
-            auto noVniUpdate = std::make_shared<Update>();
-            noVniUpdate->mode = Mode::NotColorized;
-            noVniUpdate->depth = m_pUpdateBufferQueue[bufferPositionMod]->depth;
-            noVniUpdate->width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-            noVniUpdate->height = m_pUpdateBufferQueue[bufferPositionMod]->height;
+            std::shared_ptr<FrameSlot> noVniUpdate =
+                m_pFrameSlotPool->Acquire(Mode::NotColorized, frame->width, frame->height);
+            noVniUpdate->depth = frame->depth;
             noVniUpdate->hasData = true;
-            noVniUpdate->hasSegData = false;
-            noVniUpdate->hasSegData2 = false;
-            memcpy(noVniUpdate->data, m_pUpdateBufferQueue[bufferPositionMod]->data,
-                   (size_t)m_pUpdateBufferQueue[bufferPositionMod]->width *
-                       m_pUpdateBufferQueue[bufferPositionMod]->height);
+            memcpy(noVniUpdate->data, frame->data, noVniUpdate->dataSize);
 
             uint32_t queuedTimestamp = 0;
             bool hasTimestamp = GetQueueTimestamp(bufferPositionMod, queuedTimestamp);
-            QueueUpdate(noVniUpdate, false, hasTimestamp, queuedTimestamp);
+            QueueFrame(noVniUpdate, false, hasTimestamp, queuedTimestamp);
           }
         }
       }
@@ -1906,8 +2342,8 @@ void DMD::VniThread()
 #endif
 }
 
-void DMD::QueueSerumFrames(Update* dmdUpdate, bool render32, bool render64, bool hasTimestamp, uint32_t timestampMs,
-                           std::shared_ptr<Update>* primaryOutput)
+void DMD::QueueSerumFrames(const FrameSlot* dmdUpdate, bool render32, bool render64, bool hasTimestamp,
+                           uint32_t timestampMs, std::shared_ptr<FrameSlot>* primaryOutput)
 {
   if (!render32 && !render64) return;
 
@@ -1923,139 +2359,90 @@ void DMD::QueueSerumFrames(Update* dmdUpdate, bool render32, bool render64, bool
     m_serumLastTimestampMs = timestampMs;
   }
 
-  auto serumUpdate = std::make_shared<Update>();
-  serumUpdate->hasData = true;
-  serumUpdate->hasSegData = false;
-  serumUpdate->hasSegData2 = false;
-
   if (m_pSerum->SerumVersion == SERUM_V1 && render32)
   {
     const size_t frameBytes = (size_t)dmdUpdate->width * dmdUpdate->height;
-    if (frameBytes == 0 || frameBytes > sizeof(serumUpdate->data))
+    std::shared_ptr<FrameSlot> serumUpdate =
+        frameBytes > 0 ? m_pFrameSlotPool->Acquire(Mode::SerumV1, dmdUpdate->width, dmdUpdate->height) : nullptr;
+    if (!serumUpdate)
     {
       Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v1 frame size %ux%u, skipping frame", dmdUpdate->width,
           dmdUpdate->height);
       return;
     }
 
-    serumUpdate->mode = Mode::SerumV1;
     serumUpdate->depth = 6;
-    serumUpdate->width = dmdUpdate->width;
-    serumUpdate->height = dmdUpdate->height;
+    serumUpdate->hasData = true;
     memcpy(serumUpdate->data, m_pSerum->frame, frameBytes);
     memcpy(serumUpdate->segData, m_pSerum->palette, PALETTE_SIZE);
+    memset((uint8_t*)serumUpdate->segData + PALETTE_SIZE, 0,
+           serumUpdate->segDataSize * sizeof(uint16_t) - PALETTE_SIZE);
 
     if (primaryOutput)
     {
       *primaryOutput = serumUpdate;
       primaryOutput = nullptr;
     }
-    QueueUpdate(serumUpdate, false, hasTimestamp, timestampMs);
+    QueueFrame(serumUpdate, false, hasTimestamp, timestampMs);
   }
   else if (m_pSerum->SerumVersion == SERUM_V2)
   {
+    Mode mode32 = Mode::Unknown;
+    Mode mode64 = Mode::Unknown;
     if (m_pSerum->width32 > 0 && m_pSerum->width64 == 0)
-    {
-      if (render32)
-      {
-        const size_t frameWords32 = (size_t)m_pSerum->width32 * 32u;
-        if (frameWords32 > (sizeof(serumUpdate->segData) / sizeof(serumUpdate->segData[0])))
-        {
-          Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 32p frame width %u, skipping frame", m_pSerum->width32);
-          return;
-        }
-
-        serumUpdate->mode = Mode::SerumV2_32;
-        serumUpdate->depth = 24;
-        serumUpdate->width = m_pSerum->width32;
-        serumUpdate->height = 32;
-        memcpy(serumUpdate->segData, m_pSerum->frame32, frameWords32 * sizeof(uint16_t));
-
-        if (primaryOutput)
-        {
-          *primaryOutput = serumUpdate;
-          primaryOutput = nullptr;
-        }
-        QueueUpdate(serumUpdate, false, hasTimestamp, timestampMs);
-      }
+    {
+      mode32 = Mode::SerumV2_32;
     }
     else if (m_pSerum->width32 == 0 && m_pSerum->width64 > 0)
     {
-      if (render64)
-      {
-        const size_t frameWords64 = (size_t)m_pSerum->width64 * 64u;
-        if (frameWords64 > (sizeof(serumUpdate->segData) / sizeof(serumUpdate->segData[0])))
-        {
-          Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 64p frame width %u, skipping frame", m_pSerum->width64);
-          return;
-        }
-
-        serumUpdate->mode = Mode::SerumV2_64;
-        serumUpdate->depth = 24;
-        serumUpdate->width = m_pSerum->width64;
-        serumUpdate->height = 64;
-        memcpy(serumUpdate->segData, m_pSerum->frame64, frameWords64 * sizeof(uint16_t));
-
-        if (primaryOutput)
-        {
-          *primaryOutput = serumUpdate;
-          primaryOutput = nullptr;
-        }
-        QueueUpdate(serumUpdate, false, hasTimestamp, timestampMs);
-      }
+      mode64 = Mode::SerumV2_64;
     }
     else if (m_pSerum->width32 > 0 && m_pSerum->width64 > 0)
     {
-      if (render32)
+      mode32 = Mode::SerumV2_32_64;
+      mode64 = Mode::SerumV2_64_32;
+    }
+
+    if (render32 && mode32 != Mode::Unknown)
+    {
+      std::shared_ptr<FrameSlot> serumUpdate = m_pFrameSlotPool->Acquire(mode32, m_pSerum->width32, 32);
+      if (!serumUpdate)
       {
-        const size_t frameWords32 = (size_t)m_pSerum->width32 * 32u;
-        if (frameWords32 > (sizeof(serumUpdate->segData) / sizeof(serumUpdate->segData[0])))
-        {
-          Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 32p frame width %u, skipping frame", m_pSerum->width32);
-          return;
-        }
+        Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 32p frame width %u, skipping frame", m_pSerum->width32);
+        return;
+      }
 
-        serumUpdate->mode = Mode::SerumV2_32_64;
-        serumUpdate->depth = 24;
-        serumUpdate->width = m_pSerum->width32;
-        serumUpdate->height = 32;
-        memcpy(serumUpdate->segData, m_pSerum->frame32, frameWords32 * sizeof(uint16_t));
+      serumUpdate->depth = 24;
+      serumUpdate->hasData = true;
+      memcpy(serumUpdate->segData, m_pSerum->frame32, serumUpdate->segDataSize * sizeof(uint16_t));
 
-        if (primaryOutput)
-        {
-          *primaryOutput = serumUpdate;
-          primaryOutput = nullptr;
-        }
-        QueueUpdate(serumUpdate, false, hasTimestamp, timestampMs);
+      if (primaryOutput)
+      {
+        *primaryOutput = serumUpdate;
+        primaryOutput = nullptr;
       }
+      QueueFrame(serumUpdate, false, hasTimestamp, timestampMs);
+    }
 
-      if (render64)
+    if (render64 && mode64 != Mode::Unknown)
+    {
+      std::shared_ptr<FrameSlot> serumUpdate = m_pFrameSlotPool->Acquire(mode64, m_pSerum->width64, 64);
+      if (!serumUpdate)
       {
-        const size_t frameWords64 = (size_t)m_pSerum->width64 * 64u;
-        if (frameWords64 > (sizeof(serumUpdate->segData) / sizeof(serumUpdate->segData[0])))
-        {
-          Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 64p frame width %u, skipping frame", m_pSerum->width64);
-          return;
-        }
+        Log(DMDUtil_LogLevel_ERROR, "Serum: Invalid v2 64p frame width %u, skipping frame", m_pSerum->width64);
+        return;
+      }
 
-        // We can't reuse the shared pointer from above because it might have been sent already.
-        auto serumUpdateHD = std::make_shared<Update>();
-        serumUpdateHD->hasData = true;
-        serumUpdateHD->hasSegData = false;
-        serumUpdateHD->hasSegData2 = false;
-        serumUpdateHD->mode = Mode::SerumV2_64_32;
-        serumUpdateHD->depth = 24;
-        serumUpdateHD->width = m_pSerum->width64;
-        serumUpdateHD->height = 64;
-        memcpy(serumUpdateHD->segData, m_pSerum->frame64, frameWords64 * sizeof(uint16_t));
-
-        if (primaryOutput)
-        {
-          *primaryOutput = serumUpdateHD;
-          primaryOutput = nullptr;
-        }
-        QueueUpdate(serumUpdateHD, false, hasTimestamp, timestampMs);
+      serumUpdate->depth = 24;
+      serumUpdate->hasData = true;
+      memcpy(serumUpdate->segData, m_pSerum->frame64, serumUpdate->segDataSize * sizeof(uint16_t));
+
+      if (primaryOutput)
+      {
+        *primaryOutput = serumUpdate;
+        primaryOutput = nullptr;
       }
+      QueueFrame(serumUpdate, false, hasTimestamp, timestampMs);
     }
   }
 }
@@ -2070,24 +2457,22 @@ void DMD::PIN2DMDThread()
   uint16_t bufferPosition = 0;
   uint16_t segData1[128] = {0};
   uint16_t segData2[128] = {0};
-  uint8_t palette[256 * 3] = {0};
-  uint8_t renderBuffer[256 * 64] = {0};
+  uint32_t paletteGeneration = 0;
 
   const int targetWidth = m_PIN2DMDWidth;
   const int targetHeight = m_PIN2DMDHeight;
   const int targetLength = targetWidth * targetHeight;
-  const int maxSourceLength = 256 * 64;
-  uint8_t* rgb24Data = new uint8_t[maxSourceLength * 3];
   uint8_t* scaledBuffer = new uint8_t[targetLength * 3];
   constexpr int kMaxTempWidth = 384;
   constexpr int kMaxTempHeight = 128;
   uint8_t* tempBuffer = new uint8_t[kMaxTempWidth * kMaxTempHeight * 3];
 
-  memset(rgb24Data, 0, maxSourceLength * 3);
   memset(scaledBuffer, 0, targetLength * 3);
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
+  FramePacer pacer("PIN2DMD");
   Config* const pConfig = Config::GetInstance();
   bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
   bool excludeColorizedFrames = pConfig->IsExcludeColorizedFramesForPIN2DMD();
@@ -2156,29 +2541,22 @@ void DMD::PIN2DMDThread()
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
-      delete[] rgb24Data;
       delete[] scaledBuffer;
       delete[] tempBuffer;
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
-      bufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
+      bufferPosition = GetNextBufferQueuePosition(pacer, bufferPosition, updateBufferQueuePosition);
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      const Mode updateMode = m_pUpdateBufferQueue[bufferPositionMod]->mode;
+      const Mode updateMode = frame->mode;
       if (excludeColorizedFrames)
       {
         if (IsSerumMode(updateMode, true)) continue;
@@ -2188,97 +2566,55 @@ void DMD::PIN2DMDThread()
         continue;
       }
 
-      if (!(m_pUpdateBufferQueue[bufferPositionMod]->hasData || m_pUpdateBufferQueue[bufferPositionMod]->hasSegData))
+      if (!PaceFrame(pacer, bufferPosition, updateBufferQueuePosition, updateMode)) continue;
+
+      if (!(frame->hasData || frame->hasSegData))
         continue;
 
-      uint16_t width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-      uint16_t height = m_pUpdateBufferQueue[bufferPositionMod]->height;
-      int length = (int)width * height;
+      uint16_t width = frame->width;
+      uint16_t height = frame->height;
 
       bool update = false;
-      if (m_pUpdateBufferQueue[bufferPositionMod]->depth != 24)
+      if (frame->depth != 24)
       {
-        update = UpdatePalette(palette, m_pUpdateBufferQueue[bufferPositionMod]->depth,
-                               m_pUpdateBufferQueue[bufferPositionMod]->r, m_pUpdateBufferQueue[bufferPositionMod]->g,
-                               m_pUpdateBufferQueue[bufferPositionMod]->b);
+        update = UpdatePalette(paletteGeneration, frame->depth, frame->r, frame->g, frame->b);
       }
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24)
+      bool render = true;
+      if (frame->mode == Mode::RGB24 || frame->mode == Mode::RGB16 || IsSerumV2Mode(frame->mode) ||
+          frame->mode == Mode::SerumV1 || frame->mode == Mode::Vni)
       {
-        AdjustRGB24Depth(m_pUpdateBufferQueue[bufferPositionMod]->data, rgb24Data, length, palette,
-                         m_pUpdateBufferQueue[bufferPositionMod]->depth);
         update = true;
       }
-      else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB16 ||
-               IsSerumV2Mode(m_pUpdateBufferQueue[bufferPositionMod]->mode))
+      else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) && frame->mode == Mode::Data) ||
+               (showNotColorizedFrames && frame->mode == Mode::NotColorized))
       {
-        const uint16_t* src = m_pUpdateBufferQueue[bufferPositionMod]->segData;
-        for (int i = 0; i < length; i++)
-        {
-          uint16_t value = src[i];
-          uint8_t r = (uint8_t)((value >> 11) & 0x1F);
-          uint8_t g = (uint8_t)((value >> 5) & 0x3F);
-          uint8_t b = (uint8_t)(value & 0x1F);
-          rgb24Data[i * 3] = (uint8_t)((r << 3) | (r >> 2));
-          rgb24Data[i * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
-          rgb24Data[i * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
-        }
         update = true;
       }
-      else
+      else if (frame->mode == Mode::AlphaNumeric)
       {
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV1 ||
-            m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Vni)
+        if (memcmp(segData1, frame->segData, sizeof(segData1)) != 0)
         {
-          size_t paletteBytes = PaletteBytesForDepth((uint8_t)m_pUpdateBufferQueue[bufferPositionMod]->depth);
-          if (paletteBytes > 0 && paletteBytes <= sizeof(palette))
-          {
-            memcpy(palette, m_pUpdateBufferQueue[bufferPositionMod]->segData, paletteBytes);
-          }
-          memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
-          update = true;
-        }
-        else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) &&
-                  m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data) ||
-                 (showNotColorizedFrames && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::NotColorized))
-        {
-          memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+          memcpy(segData1, frame->segData, sizeof(segData1));
           update = true;
         }
-        else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::AlphaNumeric)
-        {
-          if (memcmp(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1)) != 0)
-          {
-            memcpy(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1));
-            update = true;
-          }
-
-          if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2 &&
-              memcmp(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2)) != 0)
-          {
-            memcpy(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2));
-            update = true;
-          }
-
-          if (update)
-          {
-            if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2)
-              m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1,
-                                      segData2);
-            else
-              m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1);
-          }
-        }
 
-        if (update)
+        if (frame->hasSegData2 && memcmp(segData2, frame->segData2, sizeof(segData2)) != 0)
         {
-          FrameUtil::Helper::ConvertToRgb24(rgb24Data, renderBuffer, length, palette);
+          memcpy(segData2, frame->segData2, sizeof(segData2));
+          update = true;
         }
       }
+      else
+      {
+        render = false;
+      }
 
-      if (update && scaleToTarget(rgb24Data, width, height, scaledBuffer))
+      const uint8_t* pRgb888 = (update && render) ? RenderRgb888(*frame) : nullptr;
+      if (pRgb888 && scaleToTarget(pRgb888, width, height, scaledBuffer))
       {
         ApplyRoundedCornersRGB24(scaledBuffer, targetWidth, targetHeight, roundedCorners);
+        FramePacer::RenderScope renderScope(pacer);
         PIN2DMDRenderRaw(targetWidth, targetHeight, scaledBuffer, 1);
       }
     }
@@ -2291,7 +2627,7 @@ void DMD::PixelcadeDMDThread()
   uint16_t bufferPosition = 0;
   uint16_t segData1[128] = {0};
   uint16_t segData2[128] = {0};
-  uint8_t palette[256 * 3] = {0};
+  uint32_t paletteGeneration = 0;
 
   const int targetWidth = m_pPixelcadeDMD->GetWidth();
   const int targetHeight = m_pPixelcadeDMD->GetHeight();
@@ -2300,7 +2636,9 @@ void DMD::PixelcadeDMDThread()
   memset(rgb565Data, 0, targetLength * sizeof(uint16_t));
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
+  FramePacer pacer("Pixelcade");
   Config* const pConfig = Config::GetInstance();
   bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
   bool excludeColorizedFrames = pConfig->IsExcludeColorizedFramesForPixelcade();
@@ -2308,27 +2646,21 @@ void DMD::PixelcadeDMDThread()
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       delete[] rgb565Data;
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
-      bufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
+      bufferPosition = GetNextBufferQueuePosition(pacer, bufferPosition, updateBufferQueuePosition);
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      const Mode updateMode = m_pUpdateBufferQueue[bufferPositionMod]->mode;
+      const Mode updateMode = frame->mode;
       if (excludeColorizedFrames)
       {
         if (IsSerumMode(updateMode, true)) continue;
@@ -2338,25 +2670,23 @@ void DMD::PixelcadeDMDThread()
         continue;
       }
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->hasData || m_pUpdateBufferQueue[bufferPositionMod]->hasSegData)
+      if (!PaceFrame(pacer, bufferPosition, updateBufferQueuePosition, updateMode)) continue;
+
+      if (frame->hasData || frame->hasSegData)
       {
-        uint16_t width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-        uint16_t height = m_pUpdateBufferQueue[bufferPositionMod]->height;
-        int length = (int)width * height;
+        uint16_t width = frame->width;
+        uint16_t height = frame->height;
 
         bool update = false;
-        if (m_pUpdateBufferQueue[bufferPositionMod]->depth != 24)
+        if (frame->depth != 24)
         {
-          update = UpdatePalette(palette, m_pUpdateBufferQueue[bufferPositionMod]->depth,
-                                 m_pUpdateBufferQueue[bufferPositionMod]->r, m_pUpdateBufferQueue[bufferPositionMod]->g,
-                                 m_pUpdateBufferQueue[bufferPositionMod]->b);
+          update = UpdatePalette(paletteGeneration, frame->depth, frame->r, frame->g, frame->b);
         }
 
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24)
+        if (frame->mode == Mode::RGB24)
         {
-          uint8_t rgb24Data[256 * 64 * 3];
-          AdjustRGB24Depth(m_pUpdateBufferQueue[bufferPositionMod]->data, rgb24Data, length, palette,
-                           m_pUpdateBufferQueue[bufferPositionMod]->depth);
+          const uint8_t* rgb24Data = RenderRgb888(*frame);
+          if (!rgb24Data) continue;
 
           uint8_t* scaledBuffer = new uint8_t[targetLength * 3];
           if (width == targetWidth && height == targetHeight)
@@ -2371,47 +2701,39 @@ void DMD::PixelcadeDMDThread()
           if (m_pPixelcadeDMD->GetIsV2())
           {
             ApplyRoundedCornersRGB24(scaledBuffer, targetWidth, targetHeight, roundedCorners);
+            FramePacer::RenderScope renderScope(pacer);
             m_pPixelcadeDMD->UpdateRGB24(scaledBuffer);
           }
           else
           {
-            for (int i = 0; i < targetLength; i++)
-            {
-              int pos = i * 3;
-              uint32_t r = scaledBuffer[pos];
-              uint32_t g = scaledBuffer[pos + 1];
-              uint32_t b = scaledBuffer[pos + 2];
-
-              rgb565Data[i] = (uint16_t)(((r & 0xF8u) << 8) | ((g & 0xFCu) << 3) | (b >> 3));
-            }
+            PixelKernels::Rgb888ToRgb565(scaledBuffer, rgb565Data, targetLength);
             update = true;
           }
 
           delete[] scaledBuffer;
         }
-        else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB16)
+        else if (frame->mode == Mode::RGB16)
         {
           if (width == targetWidth && height == targetHeight)
-            memcpy(rgb565Data, m_pUpdateBufferQueue[bufferPositionMod]->segData, targetLength * 2);
+            memcpy(rgb565Data, frame->segData, targetLength * 2);
           else if (width == targetWidth && height == 16)
-            FrameUtil::Helper::Center((uint8_t*)rgb565Data, targetWidth, targetHeight,
-                                      (uint8_t*)m_pUpdateBufferQueue[bufferPositionMod]->segData, targetWidth, 16, 16);
+            FrameUtil::Helper::Center((uint8_t*)rgb565Data, targetWidth, targetHeight, (uint8_t*)frame->segData,
+                                      targetWidth, 16, 16);
           else if (height == 64)
-            FrameUtil::Helper::ScaleDown((uint8_t*)rgb565Data, targetWidth, targetHeight,
-                                         (uint8_t*)m_pUpdateBufferQueue[bufferPositionMod]->segData, width, 64, 16);
+            FrameUtil::Helper::ScaleDown((uint8_t*)rgb565Data, targetWidth, targetHeight, (uint8_t*)frame->segData,
+                                         width, 64, 16);
           else
             continue;
 
           update = true;
         }
-        else if (IsSerumV2Mode(m_pUpdateBufferQueue[bufferPositionMod]->mode))
+        else if (IsSerumV2Mode(frame->mode))
         {
-          if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV2_32 ||
-              m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV2_32_64)
-            memcpy(rgb565Data, m_pUpdateBufferQueue[bufferPositionMod]->segData, targetLength * 2);
-          else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV2_64)
-            FrameUtil::Helper::ScaleDown((uint8_t*)rgb565Data, targetWidth, targetHeight,
-                                         (uint8_t*)m_pUpdateBufferQueue[bufferPositionMod]->segData, width, 64, 16);
+          if (frame->mode == Mode::SerumV2_32 || frame->mode == Mode::SerumV2_32_64)
+            memcpy(rgb565Data, frame->segData, targetLength * 2);
+          else if (frame->mode == Mode::SerumV2_64)
+            FrameUtil::Helper::ScaleDown((uint8_t*)rgb565Data, targetWidth, targetHeight, (uint8_t*)frame->segData,
+                                         width, 64, 16);
           else
             continue;
 
@@ -2419,51 +2741,38 @@ void DMD::PixelcadeDMDThread()
         }
         else
         {
-          uint8_t renderBuffer[256 * 64];
-
-          if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV1 ||
-              m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Vni)
+          bool render = false;
+          if (frame->mode == Mode::SerumV1 || frame->mode == Mode::Vni)
           {
-            size_t paletteBytes = PaletteBytesForDepth((uint8_t)m_pUpdateBufferQueue[bufferPositionMod]->depth);
-            if (paletteBytes > 0 && paletteBytes <= sizeof(palette))
-            {
-              memcpy(palette, m_pUpdateBufferQueue[bufferPositionMod]->segData, paletteBytes);
-            }
-            memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
             update = true;
+            render = true;
           }
-          else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) &&
-                    m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data) ||
-                   (showNotColorizedFrames && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::NotColorized))
+          else if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) && frame->mode == Mode::Data) ||
+                   (showNotColorizedFrames && frame->mode == Mode::NotColorized))
           {
-            memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
             update = true;
+            render = true;
           }
-          else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::AlphaNumeric)
+          else if (frame->mode == Mode::AlphaNumeric)
           {
-            if (memcmp(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1)) != 0)
+            if (memcmp(segData1, frame->segData, sizeof(segData1)) != 0)
             {
-              memcpy(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1));
+              memcpy(segData1, frame->segData, sizeof(segData1));
               update = true;
             }
 
-            if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2 &&
-                memcmp(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2)) != 0)
+            if (frame->hasSegData2 && memcmp(segData2, frame->segData2, sizeof(segData2)) != 0)
             {
-              memcpy(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2));
+              memcpy(segData2, frame->segData2, sizeof(segData2));
               update = true;
             }
-
-            if (update)
-            {
-              if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2)
-                m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1,
-                                        segData2);
-              else
-                m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1);
-            }
+            render = true;
           }
 
+          const uint8_t* renderBuffer = nullptr;
+          const uint8_t* framePalette = nullptr;
+          if (update && (!render || !RenderIndexed(*frame, renderBuffer, framePalette))) continue;
+
           if (update)
           {
             uint8_t scaledBuffer[128 * 32];
@@ -2478,21 +2787,15 @@ void DMD::PixelcadeDMDThread()
             else
               continue;
 
-            for (int i = 0; i < targetLength; i++)
-            {
-              int pos = scaledBuffer[i] * 3;
-              uint32_t r = palette[pos];
-              uint32_t g = palette[pos + 1];
-              uint32_t b = palette[pos + 2];
-
-              rgb565Data[i] = (uint16_t)(((r & 0xF8u) << 8) | ((g & 0xFCu) << 3) | (b >> 3));
-            }
+            PixelKernels::IndexedToRgb565(scaledBuffer, framePalette, (uint16_t)(1u << frame->depth), rgb565Data,
+                                          targetLength);
           }
         }
 
         if (update)
         {
           ApplyRoundedCornersRGB565(rgb565Data, targetWidth, targetHeight, roundedCorners);
+          FramePacer::RenderScope renderScope(pacer);
           m_pPixelcadeDMD->Update(rgb565Data);
         }
       }
@@ -2507,40 +2810,35 @@ void DMD::LevelDMDThread()
   uint8_t renderBuffer[256 * 64] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  // Only data frames are processed.
+  FrameRing::Subscription subscription(*m_pFrameRing,
+                                       [](const FrameSlot& frame) { return frame.mode == Mode::Data; });
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       bufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      if (!m_levelDMDs.empty() && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data &&
-          m_pUpdateBufferQueue[bufferPositionMod]->hasData)
+      if (!m_levelDMDs.empty() && frame->mode == Mode::Data && frame->hasData)
       {
-        int length =
-            (int)m_pUpdateBufferQueue[bufferPositionMod]->width * m_pUpdateBufferQueue[bufferPositionMod]->height;
-        if (memcmp(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length) != 0)
+        int length = (int)frame->width * frame->height;
+        if (memcmp(renderBuffer, frame->data, length) != 0)
         {
-          memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+          memcpy(renderBuffer, frame->data, length);
           for (LevelDMD* pLevelDMD : m_levelDMDs)
           {
             if (pLevelDMD->GetLength() == length)
-              pLevelDMD->Update(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->depth);
+              pLevelDMD->Update(renderBuffer, frame->depth);
           }
         }
       }
@@ -2553,39 +2851,36 @@ void DMD::RGB24DMDThread()
   uint16_t bufferPosition = 0;
   uint16_t segData1[128] = {0};
   uint16_t segData2[128] = {0};
-  uint8_t palette[256 * 3] = {0};
+  uint32_t paletteGeneration = 0;
   uint8_t renderBuffer[256 * 64] = {0};
   uint8_t rgb24Data[256 * 64 * 3] = {0};
   uint8_t rgb24DataScaled[256 * 64 * 3] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing);
 
+  FramePacer pacer("RGB24DMD");
+  FrameChangeTracker changeTracker(*m_pFrameRing);
   Config* const pConfig = Config::GetInstance();
   bool showNotColorizedFrames = pConfig->IsShowNotColorizedFrames();
   bool excludeColorizedFrames = pConfig->IsExcludeColorizedFramesForRGB24DMD();
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
-      bufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
+      bufferPosition = GetNextBufferQueuePosition(pacer, bufferPosition, updateBufferQueuePosition);
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      const Mode updateMode = m_pUpdateBufferQueue[bufferPositionMod]->mode;
+      const Mode updateMode = frame->mode;
       if (excludeColorizedFrames)
       {
         if (IsSerumMode(updateMode, true)) continue;
@@ -2595,142 +2890,111 @@ void DMD::RGB24DMDThread()
         continue;
       }
 
-      if (!m_rgb24DMDs.empty() &&
-          (m_pUpdateBufferQueue[bufferPositionMod]->hasData || m_pUpdateBufferQueue[bufferPositionMod]->hasSegData))
+      if (!PaceFrame(pacer, bufferPosition, updateBufferQueuePosition, updateMode)) continue;
+
+      if (!m_rgb24DMDs.empty() && (frame->hasData || frame->hasSegData))
       {
-        int length =
-            (int)m_pUpdateBufferQueue[bufferPositionMod]->width * m_pUpdateBufferQueue[bufferPositionMod]->height;
+        // The displays still show the previous frame.
+        if (changeTracker.Track(bufferPosition) == 0) continue;
+
+        int length = (int)frame->width * frame->height;
         bool update = false;
 
-        if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::RGB24)
+        if (frame->mode == Mode::RGB24)
         {
-          if (memcmp(rgb24Data, m_pUpdateBufferQueue[bufferPositionMod]->data, length * 3) != 0)
+          if (memcmp(rgb24Data, frame->data, length * 3) != 0)
           {
-            if (m_pUpdateBufferQueue[bufferPositionMod]->depth != 24)
-            {
-              UpdatePalette(palette, m_pUpdateBufferQueue[bufferPositionMod]->depth,
-                            m_pUpdateBufferQueue[bufferPositionMod]->r, m_pUpdateBufferQueue[bufferPositionMod]->g,
-                            m_pUpdateBufferQueue[bufferPositionMod]->b);
-            }
-
-            AdjustRGB24Depth(m_pUpdateBufferQueue[bufferPositionMod]->data, rgb24Data, length, palette,
-                             m_pUpdateBufferQueue[bufferPositionMod]->depth);
+            const uint8_t* pRgb888 = RenderRgb888(*frame);
+            if (!pRgb888) continue;
+            memcpy(rgb24Data, pRgb888, length * 3);
 
+            FramePacer::RenderScope renderScope(pacer);
             for (RGB24DMD* pRGB24DMD : m_rgb24DMDs)
             {
-              pRGB24DMD->Update(rgb24Data, m_pUpdateBufferQueue[bufferPositionMod]->width,
-                                m_pUpdateBufferQueue[bufferPositionMod]->height);
+              pRGB24DMD->Update(rgb24Data, frame->width, frame->height);
             }
             // Reset renderBuffer in case the mode changes for the next frame to ensure that memcmp() will detect it.
             memset(renderBuffer, 0, sizeof(renderBuffer));
           }
         }
-        else if (m_pUpdateBufferQueue[bufferPositionMod]->mode != Mode::RGB16 &&
-                 !IsSerumV2Mode(m_pUpdateBufferQueue[bufferPositionMod]->mode))
+        else if (frame->mode != Mode::RGB16 && !IsSerumV2Mode(frame->mode))
         {
-          if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV1 ||
-              m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Vni)
+          bool render = true;
+          if (frame->mode == Mode::SerumV1 || frame->mode == Mode::Vni)
           {
-            size_t paletteBytes = PaletteBytesForDepth((uint8_t)m_pUpdateBufferQueue[bufferPositionMod]->depth);
-            if (paletteBytes > 0 && paletteBytes <= sizeof(palette))
-            {
-              memcpy(palette, m_pUpdateBufferQueue[bufferPositionMod]->segData, paletteBytes);
-            }
-            memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+            // The next tinted frame has to be rendered again.
+            paletteGeneration = 0;
+            memcpy(renderBuffer, frame->data, length);
             update = true;
           }
           else
           {
-            update = UpdatePalette(
-                palette, m_pUpdateBufferQueue[bufferPositionMod]->depth, m_pUpdateBufferQueue[bufferPositionMod]->r,
-                m_pUpdateBufferQueue[bufferPositionMod]->g, m_pUpdateBufferQueue[bufferPositionMod]->b);
+            update = UpdatePalette(paletteGeneration, frame->depth, frame->r, frame->g, frame->b);
 
-            if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) &&
-                 m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data) ||
-                (showNotColorizedFrames && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::NotColorized))
+            if (((excludeColorizedFrames || !(m_pSerum || m_pVni)) && frame->mode == Mode::Data) ||
+                (showNotColorizedFrames && frame->mode == Mode::NotColorized))
             {
-              if (memcmp(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length) != 0)
+              if (memcmp(renderBuffer, frame->data, length) != 0)
               {
-                memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+                memcpy(renderBuffer, frame->data, length);
                 update = true;
               }
             }
-            else if (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::AlphaNumeric)
+            else if (frame->mode == Mode::AlphaNumeric)
             {
-              if (memcmp(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1)) != 0)
+              if (memcmp(segData1, frame->segData, sizeof(segData1)) != 0)
               {
-                memcpy(segData1, m_pUpdateBufferQueue[bufferPositionMod]->segData, sizeof(segData1));
+                memcpy(segData1, frame->segData, sizeof(segData1));
                 update = true;
               }
 
-              if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2 &&
-                  memcmp(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2)) != 0)
+              if (frame->hasSegData2 && memcmp(segData2, frame->segData2, sizeof(segData2)) != 0)
               {
-                memcpy(segData2, m_pUpdateBufferQueue[bufferPositionMod]->segData2, sizeof(segData2));
+                memcpy(segData2, frame->segData2, sizeof(segData2));
                 update = true;
               }
-
-              if (update)
-              {
-                if (m_pUpdateBufferQueue[bufferPositionMod]->hasSegData2)
-                  m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1,
-                                          segData2);
-                else
-                  m_pAlphaNumeric->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->layout, segData1);
-              }
+            }
+            else
+            {
+              render = false;
             }
           }
 
-          if (update)
+          const uint8_t* pRgb888 = (update && render) ? RenderRgb888(*frame) : nullptr;
+          if (pRgb888)
           {
-            for (int i = 0; i < length; i++)
-            {
-              int palettePos = renderBuffer[i] * 3;
-              int pos = i * 3;
-              rgb24Data[pos] = palette[palettePos];
-              rgb24Data[pos + 1] = palette[palettePos + 1];
-              rgb24Data[pos + 2] = palette[palettePos + 2];
-            }
+            memcpy(rgb24Data, pRgb888, length * 3);
 
+            FramePacer::RenderScope renderScope(pacer);
             for (RGB24DMD* pRGB24DMD : m_rgb24DMDs)
             {
-              pRGB24DMD->Update(rgb24Data, m_pUpdateBufferQueue[bufferPositionMod]->width,
-                                m_pUpdateBufferQueue[bufferPositionMod]->height);
+              pRGB24DMD->Update(rgb24Data, frame->width, frame->height);
             }
           }
         }
         else
         {
           // Serum v2 or RGB16
-          for (int i = 0; i < length; i++)
-          {
-            int pos = i * 3;
-            rgb24Data[pos] = ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] >> 8) & 0xF8) |
-                             ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] >> 13) & 0x07);
-            rgb24Data[pos + 1] = ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] >> 3) & 0xFC) |
-                                 ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] >> 9) & 0x03);
-            rgb24Data[pos + 2] = ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] << 3) & 0xF8) |
-                                 ((m_pUpdateBufferQueue[bufferPositionMod]->segData[i] >> 2) & 0x07);
-          }
+          const uint8_t* pRgb888 = RenderRgb888(*frame);
+          if (!pRgb888) continue;
+          memcpy(rgb24Data, pRgb888, length * 3);
 
+          FramePacer::RenderScope renderScope(pacer);
           for (RGB24DMD* pRGB24DMD : m_rgb24DMDs)
           {
             if (excludeColorizedFrames)
             {
-              if (IsSerumMode(m_pUpdateBufferQueue[bufferPositionMod]->mode, true)) continue;
+              if (IsSerumMode(frame->mode, true)) continue;
             }
             else if ((m_pSerum || m_pVni) &&
-                     (!IsSerumMode(m_pUpdateBufferQueue[bufferPositionMod]->mode, showNotColorizedFrames) ||
-                      (pRGB24DMD->GetWidth() == 256 &&
-                       m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV2_32_64) ||
-                      (pRGB24DMD->GetWidth() < 256 &&
-                       m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::SerumV2_64_32)))
+                     (!IsSerumMode(frame->mode, showNotColorizedFrames) ||
+                      (pRGB24DMD->GetWidth() == 256 && frame->mode == Mode::SerumV2_32_64) ||
+                      (pRGB24DMD->GetWidth() < 256 && frame->mode == Mode::SerumV2_64_32)))
             {
               continue;
             }
 
-            pRGB24DMD->Update(rgb24Data, m_pUpdateBufferQueue[bufferPositionMod]->width,
-                              m_pUpdateBufferQueue[bufferPositionMod]->height);
+            pRGB24DMD->Update(rgb24Data, frame->width, frame->height);
           }
         }
       }
@@ -2744,41 +3008,34 @@ void DMD::ConsoleDMDThread()
   uint8_t renderBuffer[256 * 64] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  // Only data frames are processed.
+  FrameRing::Subscription subscription(*m_pFrameRing,
+                                       [](const FrameSlot& frame) { return frame.mode == Mode::Data; });
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       bufferPosition = GetNextBufferQueuePosition(bufferPosition, updateBufferQueuePosition);
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
-      if (!m_consoleDMDs.empty() && m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data &&
-          m_pUpdateBufferQueue[bufferPositionMod]->hasData)
+      if (!m_consoleDMDs.empty() && frame->mode == Mode::Data && frame->hasData)
       {
-        int length =
-            (int)m_pUpdateBufferQueue[bufferPositionMod]->width * m_pUpdateBufferQueue[bufferPositionMod]->height;
-        if (memcmp(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length) != 0)
+        int length = (int)frame->width * frame->height;
+        if (memcmp(renderBuffer, frame->data, length) != 0)
         {
-          memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+          memcpy(renderBuffer, frame->data, length);
           for (ConsoleDMD* pConsoleDMD : m_consoleDMDs)
           {
-            pConsoleDMD->Render(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->width,
-                                m_pUpdateBufferQueue[bufferPositionMod]->height,
-                                m_pUpdateBufferQueue[bufferPositionMod]->depth);
+            pConsoleDMD->Render(renderBuffer, frame->width, frame->height, frame->depth);
           }
         }
       }
@@ -2789,53 +3046,153 @@ void DMD::ConsoleDMDThread()
 bool DMD::UpdatePalette(uint8_t* pPalette, uint8_t depth, uint8_t r, uint8_t g, uint8_t b)
 {
   if (depth != 2 && depth != 4) return false;
-  uint8_t palette[192];
 
-  const uint8_t colors = (depth == 2) ? 4 : 16;
-  memcpy(palette, pPalette, colors * 3);
-  uint8_t pos = 0;
+  std::shared_ptr<const TintPalette> palette = PaletteCache::Get(depth, r, g, b);
+  const size_t bytes = palette->colors * 3;
+  if (memcmp(pPalette, palette->rgb888, bytes) == 0) return false;
 
-  for (uint8_t i = 0; i < colors; i++)
-  {
-    float perc = FrameUtil::Helper::CalcBrightness((float)i / (float)(colors - 1));
-    pPalette[pos++] = (uint8_t)((float)r * perc);
-    pPalette[pos++] = (uint8_t)((float)g * perc);
-    pPalette[pos++] = (uint8_t)((float)b * perc);
-  }
+  memcpy(pPalette, palette->rgb888, bytes);
+  return true;
+}
+
+bool DMD::UpdatePalette(uint32_t& paletteGeneration, uint8_t depth, uint8_t r, uint8_t g, uint8_t b)
+{
+  if (depth != 2 && depth != 4) return false;
+
+  const uint32_t generation = PaletteCache::Get(depth, r, g, b)->generation;
+  if (generation == paletteGeneration) return false;
 
-  return (memcmp(pPalette, palette, colors * 3) != 0);
+  paletteGeneration = generation;
+  return true;
 }
 
 void DMD::AdjustRGB24Depth(uint8_t* pData, uint8_t* pDstData, int length, uint8_t* palette, uint8_t depth)
 {
   if (depth != 24)
   {
-    for (int i = 0; i < length; i++)
+    PixelKernels::QuantizeRgb888(pData, palette, depth, pDstData, length);
+  }
+  else
+  {
+    memcpy(pDstData, pData, length * 3);
+  }
+}
+
+// The output threads share the rendering of a frame. Whichever thread needs it first renders it into the frame slot,
+// all others reuse the result.
+bool DMD::RenderIndexed(FrameSlot& frame, const uint8_t*& pIndexed, const uint8_t*& pPalette)
+{
+  std::lock_guard<std::mutex> lock(frame.renderMutex);
+  if (!RenderIndexedLocked(frame)) return false;
+
+  pIndexed = frame.pRenderIndexed;
+  pPalette = frame.renderPalette;
+  return true;
+}
+
+const uint8_t* DMD::RenderRgb888(FrameSlot& frame)
+{
+  std::lock_guard<std::mutex> lock(frame.renderMutex);
+  return RenderRgb888Locked(frame) ? frame.pRenderRgb888 : nullptr;
+}
+
+bool DMD::RenderIndexedLocked(FrameSlot& frame)
+{
+  if (frame.indexedState != FrameSlot::RenderState::Pending)
+    return frame.indexedState == FrameSlot::RenderState::Done;
+
+  frame.indexedState = FrameSlot::RenderState::Unavailable;
+  const size_t length = (size_t)frame.width * frame.height;
+  if (length == 0 || length > 256 * 64) return false;
+
+  switch (frame.mode)
+  {
+    case Mode::SerumV1:
+    case Mode::Vni:
     {
-      int pos = i * 3;
-      uint32_t r = pData[pos];
-      uint32_t g = pData[pos + 1];
-      uint32_t b = pData[pos + 2];
+      const size_t paletteBytes = PaletteBytesForDepth((uint8_t)frame.depth);
+      if (!frame.hasData || frame.dataSize < length || !frame.hasSegData || paletteBytes == 0 ||
+          paletteBytes > sizeof(frame.renderPalette) || paletteBytes > frame.segDataSize * sizeof(uint16_t))
+        return false;
+
+      memcpy(frame.renderPalette, frame.segData, paletteBytes);
+      frame.pRenderIndexed = frame.data;
+      break;
+    }
+
+    case Mode::Data:
+    case Mode::NotColorized:
+      if (!frame.hasData || frame.dataSize < length || (frame.depth != 2 && frame.depth != 4)) return false;
 
-      int v = (int)(0.2126f * (float)r + 0.7152f * (float)g + 0.0722f * (float)b);
-      if (v > 255) v = 255;
+      UpdatePalette(frame.renderPalette, frame.depth, frame.r, frame.g, frame.b);
+      frame.pRenderIndexed = frame.data;
+      break;
+
+    case Mode::AlphaNumeric:
+      if (!frame.hasSegData || (frame.depth != 2 && frame.depth != 4)) return false;
 
-      uint8_t level;
-      if (depth == 2)
-        level = (uint8_t)(v >> 6);
+      UpdatePalette(frame.renderPalette, frame.depth, frame.r, frame.g, frame.b);
+      if (!frame.pRenderAlphaNumeric) frame.pRenderAlphaNumeric = new uint8_t[256 * 64];
+      if (frame.width == 256 && frame.height == 64)
+      {
+        if (frame.hasSegData2)
+          m_pAlphaNumeric->RenderHD(frame.pRenderAlphaNumeric, frame.layout, frame.segData, frame.segData2);
+        else
+          m_pAlphaNumeric->RenderHD(frame.pRenderAlphaNumeric, frame.layout, frame.segData);
+      }
+      else if (frame.hasSegData2)
+        m_pAlphaNumeric->Render(frame.pRenderAlphaNumeric, frame.layout, frame.segData, frame.segData2);
       else
-        level = (uint8_t)(v >> 4);
+        m_pAlphaNumeric->Render(frame.pRenderAlphaNumeric, frame.layout, frame.segData);
+      frame.pRenderIndexed = frame.pRenderAlphaNumeric;
+      break;
+
+    default:
+      return false;
+  }
+
+  frame.indexedState = FrameSlot::RenderState::Done;
+  return true;
+}
 
-      int pos2 = level * 3;
-      pDstData[pos] = palette[pos2];
-      pDstData[pos + 1] = palette[pos2 + 1];
-      pDstData[pos + 2] = palette[pos2 + 2];
+bool DMD::RenderRgb888Locked(FrameSlot& frame)
+{
+  if (frame.rgb888State != FrameSlot::RenderState::Pending) return frame.rgb888State == FrameSlot::RenderState::Done;
+
+  frame.rgb888State = FrameSlot::RenderState::Unavailable;
+  const size_t length = (size_t)frame.width * frame.height;
+  if (length == 0 || length > 256 * 64) return false;
+
+  if (frame.mode == Mode::RGB24)
+  {
+    if (!frame.hasData || frame.dataSize < length * 3) return false;
+    if (frame.depth != 24)
+    {
+      if (frame.depth != 2 && frame.depth != 4) return false;
+      UpdatePalette(frame.renderPalette, frame.depth, frame.r, frame.g, frame.b);
     }
+
+    if (!frame.pRenderRgb888) frame.pRenderRgb888 = new uint8_t[256 * 64 * 3];
+    AdjustRGB24Depth(frame.data, frame.pRenderRgb888, (int)length, frame.renderPalette, frame.depth);
+  }
+  else if (frame.mode == Mode::RGB16 || IsSerumV2Mode(frame.mode))
+  {
+    if (!frame.hasSegData || frame.segDataSize < length) return false;
+
+    if (!frame.pRenderRgb888) frame.pRenderRgb888 = new uint8_t[256 * 64 * 3];
+    PixelKernels::Rgb565ToRgb888(frame.segData, frame.pRenderRgb888, length);
   }
   else
   {
-    memcpy(pDstData, pData, length * 3);
+    if (!RenderIndexedLocked(frame)) return false;
+
+    if (!frame.pRenderRgb888) frame.pRenderRgb888 = new uint8_t[256 * 64 * 3];
+    PixelKernels::IndexedToRgb888(frame.pRenderIndexed, frame.renderPalette, (uint16_t)(1u << frame.depth),
+                                  frame.pRenderRgb888, length);
   }
+
+  frame.rgb888State = FrameSlot::RenderState::Done;
+  return true;
 }
 
 void DMD::GenerateRandomSuffix(char* buffer, size_t length)
@@ -2890,31 +3247,44 @@ bool DMD::GetDumpSuffix(const char* romName, char* outSuffix, size_t outSize)
 
 bool DMD::GetQueueTimestamp(uint8_t bufferPositionMod, uint32_t& timestampMs) const
 {
-  if (!m_updateBufferQueueHasTimestamp[bufferPositionMod]) return false;
-  timestampMs = m_updateBufferQueueTimestamp[bufferPositionMod];
-  return true;
+  return m_pFrameRing->GetTimestamp(bufferPositionMod, timestampMs);
 }
 
-uint16_t DMD::GetUpdateQueuePosition() const { return m_updateBufferQueuePosition.load(std::memory_order_acquire); }
+uint16_t DMD::GetUpdateQueuePosition() const { return m_pFrameRing->GetPosition(); }
 
-bool DMD::DumpersReached(uint16_t targetPosition) const
+bool DMD::DumpersReached(uint16_t targetPosition, bool flushed) const
 {
   if (m_dumpTxtActive.load(std::memory_order_acquire) &&
-      m_dumpTxtPosition.load(std::memory_order_acquire) != targetPosition)
+      (flushed ? m_dumpTxtFlushed : m_dumpTxtPosition).load(std::memory_order_acquire) != targetPosition)
     return false;
   if (m_dumpRawActive.load(std::memory_order_acquire) &&
-      m_dumpRawPosition.load(std::memory_order_acquire) != targetPosition)
+      (flushed ? m_dumpRawFlushed : m_dumpRawPosition).load(std::memory_order_acquire) != targetPosition)
     return false;
   if (m_dump565Active.load(std::memory_order_acquire) &&
-      m_dump565Position.load(std::memory_order_acquire) != targetPosition)
+      (flushed ? m_dump565Flushed : m_dump565Position).load(std::memory_order_acquire) != targetPosition)
     return false;
   if (m_dump888Active.load(std::memory_order_acquire) &&
-      m_dump888Position.load(std::memory_order_acquire) != targetPosition)
+      (flushed ? m_dump888Flushed : m_dump888Position).load(std::memory_order_acquire) != targetPosition)
     return false;
   return true;
 }
 
-void DMD::RecordSerumColorizeCapture(const FrameContext& frameContext, const std::shared_ptr<Update>& primaryOutput,
+bool DMD::TakeDumpFlushRequest(uint32_t& flushRequest) const
+{
+  const uint32_t request = m_dumpFlushRequest.load(std::memory_order_acquire);
+  if (request == flushRequest) return false;
+  flushRequest = request;
+  return true;
+}
+
+void DMD::SetDumpFlushed(std::atomic<uint16_t>& flushedPosition, uint16_t position)
+{
+  std::lock_guard<std::mutex> lock(m_dumpPositionMutex);
+  flushedPosition.store(position, std::memory_order_release);
+  m_dumpPositionCv.notify_all();
+}
+
+void DMD::RecordSerumColorizeCapture(const FrameContext& frameContext, const std::shared_ptr<FrameSlot>& primaryOutput,
                                      bool hasTimestamp, uint32_t outputTimestampMs, bool isRotation,
                                      uint32_t serumResult, uint32_t serumVersion, uint32_t serumFrameId,
                                      uint32_t serumTriggerId, uint32_t serumRotationTimer, uint32_t serumFeatureFlags,
@@ -2947,7 +3317,7 @@ void DMD::RecordSerumColorizeCapture(const FrameContext& frameContext, const std
   capture.outputTimestampMs = outputTimestampMs;
   if (primaryOutput)
   {
-    capture.update = *primaryOutput;
+    primaryOutput->CopyTo(capture.update);
   }
 
   std::lock_guard<std::mutex> lock(m_serumCaptureMutex);
@@ -2965,90 +3335,96 @@ bool DMD::GetQueueFrameContext(uint8_t bufferPositionMod, FrameContext& frameCon
   {
     return false;
   }
-  frameContext = m_updateBufferQueueFrameContext[bufferPositionMod];
-  return frameContext.valid;
+  return m_pFrameRing->GetFrameContext(bufferPositionMod, frameContext);
 }
 
-bool DMD::WaitForDumpers(uint16_t targetPosition, uint32_t timeoutMs)
+bool DMD::WaitForDumpers(uint16_t targetPosition, uint32_t timeoutMs, bool flush)
 {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
   std::unique_lock<std::mutex> lock(m_dumpPositionMutex);
-  if (DumpersReached(targetPosition)) return true;
-  if (timeoutMs == 0) return false;
-  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
-  return m_dumpPositionCv.wait_until(lock, deadline, [&]() { return DumpersReached(targetPosition); });
+  if (!flush)
+    return DumpersReached(targetPosition, false) ||
+           (timeoutMs > 0 &&
+            m_dumpPositionCv.wait_until(lock, deadline, [&]() { return DumpersReached(targetPosition, false); }));
+
+  if (!DumpersReached(targetPosition, true))
+  {
+    // Idle dumpers keep partial buffers, ask them to hand over everything.
+    m_dumpFlushRequest.fetch_add(1, std::memory_order_release);
+    m_pFrameRing->Signal();
+    if (timeoutMs == 0 ||
+        !m_dumpPositionCv.wait_until(lock, deadline, [&]() { return DumpersReached(targetPosition, true); }))
+      return false;
+  }
+  lock.unlock();
+  return m_pDumpWriter->WaitUntilWritten(deadline);
 }
 
 void DMD::DumpDMDTxtThread()
 {
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
   uint16_t bufferPosition = 0;
+  uint32_t flushRequest = 0;
   uint8_t renderBuffer[3][256 * 64] = {0};
+  uint64_t renderHashes[3] = {0};
   uint32_t passed[3] = {0};
   std::chrono::steady_clock::time_point start;
-  FILE* f = nullptr;
-  std::string currentPath;
+  DumpFile f(*m_pDumpWriter);
+  // A whole frame is formatted first and written at once.
+  std::vector<char> text;
   std::unordered_set<uint64_t> seenHashes;
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing, nullptr, true);
 
   Config* const pConfig = Config::GetInstance();
   bool dumpNotColorizedFrames = pConfig->IsDumpNotColorizedFrames();
   bool filterTransitionalFrames = pConfig->IsFilterTransitionalFrames();
   bool dumpZip = pConfig->IsDumpZip();
+  int dumpZipLevel = pConfig->GetDumpZipLevel();
   m_dumpTxtActive.store(true, std::memory_order_release);
   m_dumpTxtPosition.store(bufferPosition, std::memory_order_release);
   m_dumpPositionCv.notify_all();
 
-  auto closeDumpFile = [&](FILE*& handle, std::string& path)
+  while (true)
   {
-    if (!handle) return;
-    fflush(handle);
-    fclose(handle);
-    handle = nullptr;
-    if (dumpZip && !path.empty())
+    // Hand over what was formatted before going to sleep, everything if WaitForDumpers() asks for it.
+    if (m_pFrameRing->GetPosition() == bufferPosition)
     {
-      ZipDumpFile(path);
+      const bool flushRequested = TakeDumpFlushRequest(flushRequest);
+      f.Flush(flushRequested);
+      if (flushRequested) SetDumpFlushed(m_dumpTxtFlushed, bufferPosition);
     }
-    path.clear();
-  };
-
-  while (true)
-  {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
-      closeDumpFile(f, currentPath);
+      f.Close();
       m_dumpTxtActive.store(false, std::memory_order_release);
       m_dumpPositionCv.notify_all();
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       // Don't use GetNextBufferPosition() here, we need all frames!
+      SkipLostDumpFrames(bufferPosition, updateBufferQueuePosition, "DumpDMDTxt");
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
       m_dumpTxtPosition.store(bufferPosition, std::memory_order_release);
       m_dumpPositionCv.notify_all();
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->depth <= 4 && m_pUpdateBufferQueue[bufferPositionMod]->hasData &&
-          ((m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data && !dumpNotColorizedFrames) ||
-           (m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::NotColorized && dumpNotColorizedFrames)))
+      if (frame->depth <= 4 && frame->hasData &&
+          ((frame->mode == Mode::Data && !dumpNotColorizedFrames) ||
+           (frame->mode == Mode::NotColorized && dumpNotColorizedFrames)))
       {
         bool update = false;
         if (strcmp(m_romName, name) != 0)
         {
           // New game ROM.
           start = std::chrono::steady_clock::now();
-          closeDumpFile(f, currentPath);
+          f.Close();
           strcpy(name, m_romName);
 
           if (name[0] != '\0')
@@ -3073,26 +3449,18 @@ void DMD::DumpDMDTxtThread()
             {
               snprintf(filename, sizeof(filename), "%s/%s-%s.txt", m_dumpPath, name, suffix);
             }
-            f = fopen(filename, "w");
-            if (f)
-            {
-              currentPath = filename;
-            }
-            else
-            {
-              currentPath.clear();
-            }
+            OpenDumpFile(f, filename, dumpZip, dumpZipLevel);
             update = true;
             memset(renderBuffer, 0, 2 * 256 * 64);
+            renderHashes[0] = renderHashes[1] = 0;
             passed[0] = passed[1] = 0;
           }
         }
 
         if (name[0] != '\0')
         {
-          int length =
-              (int)m_pUpdateBufferQueue[bufferPositionMod]->width * m_pUpdateBufferQueue[bufferPositionMod]->height;
-          if (update || (memcmp(renderBuffer[1], m_pUpdateBufferQueue[bufferPositionMod]->data, length) != 0))
+          int length = (int)frame->width * frame->height;
+          if (update || frame->hash != renderHashes[1])
           {
             uint32_t queuedTimestamp = 0;
             if (GetQueueTimestamp(bufferPositionMod, queuedTimestamp))
@@ -3105,9 +3473,10 @@ void DMD::DumpDMDTxtThread()
                                          std::chrono::steady_clock::now() - start)
                                          .count());
             }
-            memcpy(renderBuffer[2], m_pUpdateBufferQueue[bufferPositionMod]->data, length);
+            memcpy(renderBuffer[2], frame->data, length);
+            renderHashes[2] = frame->hash;
 
-            if (filterTransitionalFrames && m_pUpdateBufferQueue[bufferPositionMod]->depth == 2 &&
+            if (filterTransitionalFrames && frame->depth == 2 &&
                 (passed[2] - passed[1]) < DMDUTIL_MAX_TRANSITIONAL_FRAME_DURATION)
             {
               int i = 0;
@@ -3123,12 +3492,13 @@ void DMD::DumpDMDTxtThread()
 
                 // renderBuffer[1] is a transitional frame, delete it.
                 memcpy(renderBuffer[1], renderBuffer[2], length);
+                renderHashes[1] = renderHashes[2];
                 passed[1] += passed[2];
                 continue;
               }
             }
 
-            if (f)
+            if (f.IsOpen())
             {
               if (passed[0] > 0)
               {
@@ -3136,10 +3506,9 @@ void DMD::DumpDMDTxtThread()
 
                 if (dumpNotColorizedFrames)
                 {
-                  uint64_t hash = komihash(renderBuffer[0], length, 0);
-                  if (seenHashes.find(hash) == seenHashes.end())
+                  if (seenHashes.find(renderHashes[0]) == seenHashes.end())
                   {
-                    seenHashes.insert(hash);
+                    seenHashes.insert(renderHashes[0]);
                   }
                   else
                   {
@@ -3150,22 +3519,17 @@ void DMD::DumpDMDTxtThread()
 
                 if (dump)
                 {
-                  fprintf(f, "0x%08x\r\n", passed[0]);
-                  for (int y = 0; y < m_pUpdateBufferQueue[bufferPositionMod]->height; y++)
-                  {
-                    for (int x = 0; x < m_pUpdateBufferQueue[bufferPositionMod]->width; x++)
-                    {
-                      fprintf(f, "%x", renderBuffer[0][y * m_pUpdateBufferQueue[bufferPositionMod]->width + x]);
-                    }
-                    fprintf(f, "\r\n");
-                  }
-                  fprintf(f, "\r\n");
+                  const size_t size =
+                      TextDump::FormatIndexedFrame(text, passed[0], renderBuffer[0], frame->width, frame->height);
+                  f.Write(text.data(), size);
                 }
               }
             }
             memcpy(renderBuffer[0], renderBuffer[1], length);
+            renderHashes[0] = renderHashes[1];
             passed[0] = passed[1];
             memcpy(renderBuffer[1], renderBuffer[2], length);
+            renderHashes[1] = renderHashes[2];
             passed[1] = passed[2];
           }
         }
@@ -3178,63 +3542,56 @@ void DMD::DumpDMDRgb565Thread()
 {
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
   uint16_t bufferPosition = 0;
+  uint32_t flushRequest = 0;
   uint16_t renderBuffer[3][256 * 64] = {0};
   uint16_t frameWidths[3] = {0};
   uint16_t frameHeights[3] = {0};
   uint32_t passed[3] = {0};
   std::chrono::steady_clock::time_point start;
-  FILE* f = nullptr;
-  std::string currentPath;
+  DumpFile f(*m_pDumpWriter);
+  // A whole frame is formatted first and written at once.
+  std::vector<char> text;
   uint8_t palette[256 * 3] = {0};
   uint8_t rgb24Temp[256 * 64 * 3] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing, nullptr, true);
+  FrameChangeTracker changeTracker(*m_pFrameRing);
   bool dumpZip = Config::GetInstance()->IsDumpZip();
+  int dumpZipLevel = Config::GetInstance()->GetDumpZipLevel();
   m_dump565Active.store(true, std::memory_order_release);
   m_dump565Position.store(bufferPosition, std::memory_order_release);
   m_dumpPositionCv.notify_all();
 
-  auto closeDumpFile = [&](FILE*& handle, std::string& path)
+  while (true)
   {
-    if (!handle) return;
-    fflush(handle);
-    fclose(handle);
-    handle = nullptr;
-    if (dumpZip && !path.empty())
+    // Hand over what was formatted before going to sleep, everything if WaitForDumpers() asks for it.
+    if (m_pFrameRing->GetPosition() == bufferPosition)
     {
-      ZipDumpFile(path);
+      const bool flushRequested = TakeDumpFlushRequest(flushRequest);
+      f.Flush(flushRequested);
+      if (flushRequested) SetDumpFlushed(m_dump565Flushed, bufferPosition);
     }
-    path.clear();
-  };
-
-  while (true)
-  {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
-      closeDumpFile(f, currentPath);
+      f.Close();
       m_dump565Active.store(false, std::memory_order_release);
       m_dumpPositionCv.notify_all();
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       // Don't use GetNextBufferPosition() here, we need all frames!
+      SkipLostDumpFrames(bufferPosition, updateBufferQueuePosition, "DumpDMDRgb565");
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
       m_dump565Position.store(bufferPosition, std::memory_order_release);
       m_dumpPositionCv.notify_all();
 
-      Update* update = m_pUpdateBufferQueue[bufferPositionMod];
+      std::shared_ptr<FrameSlot> update = GetQueuedFrame(bufferPositionMod);
       if (!(update->hasData || update->hasSegData)) continue;
 
       if (!(update->mode == Mode::RGB24 || update->mode == Mode::RGB16 || update->mode == Mode::SerumV1 ||
@@ -3246,7 +3603,7 @@ void DMD::DumpDMDRgb565Thread()
       {
         // New game ROM.
         start = std::chrono::steady_clock::now();
-        closeDumpFile(f, currentPath);
+        f.Close();
         strcpy(name, m_romName);
 
         if (name[0] != '\0')
@@ -3271,15 +3628,7 @@ void DMD::DumpDMDRgb565Thread()
           {
             snprintf(filename, sizeof(filename), "%s/%s-%s.565.txt", m_dumpPath, name, suffix);
           }
-          f = fopen(filename, "w");
-          if (f)
-          {
-            currentPath = filename;
-          }
-          else
-          {
-            currentPath.clear();
-          }
+          OpenDumpFile(f, filename, dumpZip, dumpZipLevel);
           updateFrame = true;
           memset(renderBuffer, 0, sizeof(renderBuffer));
           memset(frameWidths, 0, sizeof(frameWidths));
@@ -3307,10 +3656,18 @@ void DMD::DumpDMDRgb565Thread()
         updateFrame = true;
       }
 
+      // nextFrame still holds the last processed frame, only its changed rows need to be converted again.
+      uint64_t changedRows = changeTracker.Track(bufferPosition);
+      if (updateFrame)
+        changedRows = FrameSlot::kAllRowsChanged;
+      else if (changedRows == 0)
+        continue;
+
       uint16_t* nextFrame = renderBuffer[2];
       if (update->mode == Mode::RGB16 || IsSerumV2Mode(update->mode))
       {
-        memcpy(nextFrame, update->segData, frameBytes);
+        ForEachChangedRows(changedRows, width, height, [&](size_t first, int pixels)
+                           { memcpy(nextFrame + first, update->segData + first, (size_t)pixels * sizeof(uint16_t)); });
       }
       else
       {
@@ -3320,7 +3677,6 @@ void DMD::DumpDMDRgb565Thread()
           {
             UpdatePalette(palette, update->depth, update->r, update->g, update->b);
           }
-          AdjustRGB24Depth(update->data, rgb24Temp, length, palette, update->depth);
         }
         else
         {
@@ -3329,17 +3685,17 @@ void DMD::DumpDMDRgb565Thread()
           {
             memcpy(palette, update->segData, paletteBytes);
           }
-          FrameUtil::Helper::ConvertToRgb24(rgb24Temp, update->data, length, palette);
         }
 
-        for (int i = 0; i < length; i++)
-        {
-          int pos = i * 3;
-          uint32_t r = rgb24Temp[pos];
-          uint32_t g = rgb24Temp[pos + 1];
-          uint32_t b = rgb24Temp[pos + 2];
-          nextFrame[i] = (uint16_t)(((r & 0xF8u) << 8) | ((g & 0xFCu) << 3) | (b >> 3));
-        }
+        ForEachChangedRows(changedRows, width, height,
+                           [&](size_t first, int pixels)
+                           {
+                             if (update->mode == Mode::RGB24)
+                               AdjustRGB24Depth(update->data + first * 3, rgb24Temp, pixels, palette, update->depth);
+                             else
+                               FrameUtil::Helper::ConvertToRgb24(rgb24Temp, update->data + first, pixels, palette);
+                             PixelKernels::Rgb888ToRgb565(rgb24Temp, nextFrame + first, pixels);
+                           });
       }
 
       if (updateFrame || memcmp(renderBuffer[1], nextFrame, frameBytes) != 0)
@@ -3358,21 +3714,11 @@ void DMD::DumpDMDRgb565Thread()
         frameWidths[2] = width;
         frameHeights[2] = height;
 
-        if (f && passed[0] > 0 && frameWidths[0] > 0 && frameHeights[0] > 0)
+        if (f.IsOpen() && passed[0] > 0 && frameWidths[0] > 0 && frameHeights[0] > 0)
         {
-          fprintf(f, "0x%08x\r\n", passed[0]);
-          uint32_t rowWidth = frameWidths[0];
-          uint32_t rowHeight = frameHeights[0];
-          const uint16_t* frame = renderBuffer[0];
-          for (uint32_t y = 0; y < rowHeight; y++)
-          {
-            for (uint32_t x = 0; x < rowWidth; x++)
-            {
-              fprintf(f, "%04x", frame[y * rowWidth + x]);
-            }
-            fprintf(f, "\r\n");
-          }
-          fprintf(f, "\r\n");
+          const size_t size =
+              TextDump::FormatRgb565Frame(text, passed[0], renderBuffer[0], frameWidths[0], frameHeights[0]);
+          f.Write(text.data(), size);
         }
 
         size_t prevBytes = (size_t)frameWidths[1] * frameHeights[1] * sizeof(uint16_t);
@@ -3395,62 +3741,55 @@ void DMD::DumpDMDRgb888Thread()
 {
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
   uint16_t bufferPosition = 0;
+  uint32_t flushRequest = 0;
   uint8_t renderBuffer[3][256 * 64 * 3] = {0};
   uint16_t frameWidths[3] = {0};
   uint16_t frameHeights[3] = {0};
   uint32_t passed[3] = {0};
   std::chrono::steady_clock::time_point start;
-  FILE* f = nullptr;
-  std::string currentPath;
+  DumpFile f(*m_pDumpWriter);
+  // A whole frame is formatted first and written at once.
+  std::vector<char> text;
   uint8_t palette[256 * 3] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing, nullptr, true);
+  FrameChangeTracker changeTracker(*m_pFrameRing);
   bool dumpZip = Config::GetInstance()->IsDumpZip();
+  int dumpZipLevel = Config::GetInstance()->GetDumpZipLevel();
   m_dump888Active.store(true, std::memory_order_release);
   m_dump888Position.store(bufferPosition, std::memory_order_release);
   m_dumpPositionCv.notify_all();
 
-  auto closeDumpFile = [&](FILE*& handle, std::string& path)
+  while (true)
   {
-    if (!handle) return;
-    fflush(handle);
-    fclose(handle);
-    handle = nullptr;
-    if (dumpZip && !path.empty())
+    // Hand over what was formatted before going to sleep, everything if WaitForDumpers() asks for it.
+    if (m_pFrameRing->GetPosition() == bufferPosition)
     {
-      ZipDumpFile(path);
+      const bool flushRequested = TakeDumpFlushRequest(flushRequest);
+      f.Flush(flushRequested);
+      if (flushRequested) SetDumpFlushed(m_dump888Flushed, bufferPosition);
     }
-    path.clear();
-  };
-
-  while (true)
-  {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
-      closeDumpFile(f, currentPath);
+      f.Close();
       m_dump888Active.store(false, std::memory_order_release);
       m_dumpPositionCv.notify_all();
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       // Don't use GetNextBufferPosition() here, we need all frames!
+      SkipLostDumpFrames(bufferPosition, updateBufferQueuePosition, "DumpDMDRgb888");
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
       m_dump888Position.store(bufferPosition, std::memory_order_release);
       m_dumpPositionCv.notify_all();
 
-      Update* update = m_pUpdateBufferQueue[bufferPositionMod];
+      std::shared_ptr<FrameSlot> update = GetQueuedFrame(bufferPositionMod);
       if (!(update->hasData || update->hasSegData)) continue;
 
       if (!(update->mode == Mode::RGB24 || update->mode == Mode::RGB16 || update->mode == Mode::SerumV1 ||
@@ -3462,7 +3801,7 @@ void DMD::DumpDMDRgb888Thread()
       {
         // New game ROM.
         start = std::chrono::steady_clock::now();
-        closeDumpFile(f, currentPath);
+        f.Close();
         strcpy(name, m_romName);
 
         if (name[0] != '\0')
@@ -3487,15 +3826,7 @@ void DMD::DumpDMDRgb888Thread()
           {
             snprintf(filename, sizeof(filename), "%s/%s-%s.888.txt", m_dumpPath, name, suffix);
           }
-          f = fopen(filename, "w");
-          if (f)
-          {
-            currentPath = filename;
-          }
-          else
-          {
-            currentPath.clear();
-          }
+          OpenDumpFile(f, filename, dumpZip, dumpZipLevel);
           updateFrame = true;
           memset(renderBuffer, 0, sizeof(renderBuffer));
           memset(frameWidths, 0, sizeof(frameWidths));
@@ -3523,6 +3854,13 @@ void DMD::DumpDMDRgb888Thread()
         updateFrame = true;
       }
 
+      // nextFrame still holds the last processed frame, only its changed rows need to be converted again.
+      uint64_t changedRows = changeTracker.Track(bufferPosition);
+      if (updateFrame)
+        changedRows = FrameSlot::kAllRowsChanged;
+      else if (changedRows == 0)
+        continue;
+
       uint8_t* nextFrame = renderBuffer[2];
       if (update->mode == Mode::RGB24)
       {
@@ -3530,21 +3868,14 @@ void DMD::DumpDMDRgb888Thread()
         {
           UpdatePalette(palette, update->depth, update->r, update->g, update->b);
         }
-        AdjustRGB24Depth(update->data, nextFrame, length, palette, update->depth);
+        ForEachChangedRows(
+            changedRows, width, height, [&](size_t first, int pixels)
+            { AdjustRGB24Depth(update->data + first * 3, nextFrame + first * 3, pixels, palette, update->depth); });
       }
       else if (update->mode == Mode::RGB16 || IsSerumV2Mode(update->mode))
       {
-        const uint16_t* src = update->segData;
-        for (int i = 0; i < length; i++)
-        {
-          uint16_t value = src[i];
-          uint8_t r = (uint8_t)((value >> 11) & 0x1F);
-          uint8_t g = (uint8_t)((value >> 5) & 0x3F);
-          uint8_t b = (uint8_t)(value & 0x1F);
-          nextFrame[i * 3] = (uint8_t)((r << 3) | (r >> 2));
-          nextFrame[i * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
-          nextFrame[i * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
-        }
+        ForEachChangedRows(changedRows, width, height, [&](size_t first, int pixels)
+                           { PixelKernels::Rgb565ToRgb888(update->segData + first, nextFrame + first * 3, pixels); });
       }
       else
       {
@@ -3553,7 +3884,9 @@ void DMD::DumpDMDRgb888Thread()
         {
           memcpy(palette, update->segData, paletteBytes);
         }
-        FrameUtil::Helper::ConvertToRgb24(nextFrame, update->data, length, palette);
+        ForEachChangedRows(
+            changedRows, width, height, [&](size_t first, int pixels)
+            { FrameUtil::Helper::ConvertToRgb24(nextFrame + first * 3, update->data + first, pixels, palette); });
       }
 
       if (updateFrame || memcmp(renderBuffer[1], nextFrame, frameBytes) != 0)
@@ -3572,22 +3905,11 @@ void DMD::DumpDMDRgb888Thread()
         frameWidths[2] = width;
         frameHeights[2] = height;
 
-        if (f && passed[0] > 0 && frameWidths[0] > 0 && frameHeights[0] > 0)
+        if (f.IsOpen() && passed[0] > 0 && frameWidths[0] > 0 && frameHeights[0] > 0)
         {
-          fprintf(f, "0x%08x\r\n", passed[0]);
-          uint32_t rowWidth = frameWidths[0];
-          uint32_t rowHeight = frameHeights[0];
-          const uint8_t* frame = renderBuffer[0];
-          for (uint32_t y = 0; y < rowHeight; y++)
-          {
-            for (uint32_t x = 0; x < rowWidth; x++)
-            {
-              int pos = (int)(y * rowWidth + x) * 3;
-              fprintf(f, "%02x%02x%02x", frame[pos], frame[pos + 1], frame[pos + 2]);
-            }
-            fprintf(f, "\r\n");
-          }
-          fprintf(f, "\r\n");
+          const size_t size =
+              TextDump::FormatRgb888Frame(text, passed[0], renderBuffer[0], frameWidths[0], frameHeights[0]);
+          f.Write(text.data(), size);
         }
 
         size_t prevBytes = (size_t)frameWidths[1] * frameHeights[1] * 3;
@@ -3610,84 +3932,112 @@ void DMD::DumpDMDRawThread()
 {
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
   uint16_t bufferPosition = 0;
+  uint32_t flushRequest = 0;
   std::chrono::steady_clock::time_point start;
-  FILE* f = nullptr;
+  FrameDumpWriter writer(*m_pDumpWriter);
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  FrameRing::Subscription subscription(*m_pFrameRing, nullptr, true);
+
+  // The frame dump deflates its blocks itself.
+  const bool dumpZip = Config::GetInstance()->IsDumpZip();
+  const int dumpZipLevel = Config::GetInstance()->GetDumpZipLevel();
   m_dumpRawActive.store(true, std::memory_order_release);
   m_dumpRawPosition.store(bufferPosition, std::memory_order_release);
   m_dumpPositionCv.notify_all();
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    // Hand over what was written before going to sleep, everything if WaitForDumpers() asks for it.
+    if (m_pFrameRing->GetPosition() == bufferPosition)
+    {
+      const bool flushRequested = TakeDumpFlushRequest(flushRequest);
+      writer.Flush(flushRequested);
+      if (flushRequested) SetDumpFlushed(m_dumpRawFlushed, bufferPosition);
+    }
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
-      if (f)
-      {
-        fflush(f);
-        fclose(f);
-        f = nullptr;
-      }
+      writer.Close();
       m_dumpRawActive.store(false, std::memory_order_release);
       m_dumpPositionCv.notify_all();
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       // Don't use GetNextBufferPosition() here, we need all frames!
+      SkipLostDumpFrames(bufferPosition, updateBufferQueuePosition, "DumpDMDRaw");
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
       m_dumpRawPosition.store(bufferPosition, std::memory_order_release);
       m_dumpPositionCv.notify_all();
 
-      if (m_pUpdateBufferQueue[bufferPositionMod]->hasData || m_pUpdateBufferQueue[bufferPositionMod]->hasSegData)
+      if (frame->hasData || frame->hasSegData)
       {
         if (strcmp(m_romName, name) != 0)
         {
           // New game ROM.
           start = std::chrono::steady_clock::now();
-          if (f)
-          {
-            fclose(f);
-            f = nullptr;
-          }
+          writer.Close();
           strcpy(name, m_romName);
 
           if (name[0] != '\0')
           {
-            char filename[128];
-            snprintf(filename, DMDUTIL_MAX_NAME_SIZE + 5, "%s.raw", name);
-            f = fopen(filename, "ab");
+            char filename[DMDUTIL_MAX_NAME_SIZE + 128 + 8 + 8];
+            char suffix[9];  // 8 chars + null terminator
+            if (!GetDumpSuffix(name, suffix, sizeof(suffix)))
+            {
+              GenerateRandomSuffix(suffix, 8);
+            }
+            if (m_dumpPath[0] == '\0') strcpy(m_dumpPath, Config::GetInstance()->GetDumpPath());
+            size_t pathLen = strlen(m_dumpPath);
+            if (pathLen == 0)
+            {
+              snprintf(filename, sizeof(filename), "./%s-%s.dmdump", name, suffix);
+            }
+            else if (m_dumpPath[pathLen - 1] == '/' || m_dumpPath[pathLen - 1] == '\\')
+            {
+              snprintf(filename, sizeof(filename), "%s%s-%s.dmdump", m_dumpPath, name, suffix);
+            }
+            else
+            {
+              snprintf(filename, sizeof(filename), "%s/%s-%s.dmdump", m_dumpPath, name, suffix);
+            }
+            if (!writer.Open(filename, dumpZip, dumpZipLevel))
+            {
+              Log(DMDUtil_LogLevel_ERROR, "Failed to open frame dump %s", filename);
+            }
           }
         }
 
-        if (name[0] != '\0')
+        if (writer.IsOpen())
         {
-          if (f)
+          FrameDumpHeader header;
+          if (!GetQueueTimestamp(bufferPositionMod, header.timestampMs))
           {
-            uint32_t current = 0;
-            if (!GetQueueTimestamp(bufferPositionMod, current))
-            {
-              current = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - start)
-                            .count();
-            }
-            fwrite(&current, 4, 1, f);
-
-            uint32_t size = sizeof(m_pUpdateBufferQueue[bufferPositionMod]);
-            fwrite(&size, 4, 1, f);
-
-            fwrite(m_pUpdateBufferQueue[bufferPositionMod], 1, size, f);
+            header.timestampMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - start)
+                                     .count();
+          }
+          header.mode = frame->mode;
+          header.layout = frame->layout;
+          header.depth = (uint8_t)frame->depth;
+          header.width = frame->width;
+          header.height = frame->height;
+          header.r = frame->r;
+          header.g = frame->g;
+          header.b = frame->b;
+          GetQueueFrameContext(bufferPositionMod, header.frameContext);
+
+          if (!writer.Write(header, frame->hasData ? frame->data : nullptr, frame->dataSize,
+                            frame->hasSegData ? frame->segData : nullptr, frame->segDataSize,
+                            frame->hasSegData2 ? frame->segData2 : nullptr, frame->segData2Size))
+          {
+            Log(DMDUtil_LogLevel_ERROR, "Failed to write frame dump, stopping it");
+            writer.Close();
           }
         }
       }
@@ -3699,32 +4049,30 @@ void DMD::PupDMDThread()
 {
   uint16_t bufferPosition = 0;
   uint8_t renderBuffer[256 * 64] = {0};
+  uint64_t renderHash = 0;
   uint8_t palette[192] = {0};
   char name[DMDUTIL_MAX_NAME_SIZE] = {0};
 
   (void)m_stopFlag.load(std::memory_order_acquire);
+  // Only data frames are processed.
+  FrameRing::Subscription subscription(*m_pFrameRing,
+                                       [](const FrameSlot& frame) { return frame.mode == Mode::Data; });
 
   while (true)
   {
-    std::shared_lock<std::shared_mutex> sl(m_dmdSharedMutex);
-    m_dmdCV.wait(sl,
-                 [&]()
-                 {
-                   return m_stopFlag.load(std::memory_order_relaxed) ||
-                          (m_updateBufferQueuePosition.load(std::memory_order_relaxed) != bufferPosition);
-                 });
-    sl.unlock();
+    subscription.Wait(bufferPosition, m_stopFlag);
     if (m_stopFlag.load(std::memory_order_acquire))
     {
       return;
     }
 
-    const uint16_t updateBufferQueuePosition = m_updateBufferQueuePosition.load(std::memory_order_acquire);
+    const uint16_t updateBufferQueuePosition = m_pFrameRing->GetPosition();
     while (!m_stopFlag.load(std::memory_order_relaxed) && bufferPosition != updateBufferQueuePosition)
     {
       // Don't use GetNextBufferPosition() here, we need all frames!
       ++bufferPosition;  // 65635 + 1 = 0
       uint8_t bufferPositionMod = bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE;
+      std::shared_ptr<FrameSlot> frame = GetQueuedFrame(bufferPositionMod);
 
       if (strcmp(m_romName, name) != 0)
       {
@@ -3744,7 +4092,7 @@ void DMD::PupDMDThread()
             m_pPUPDMD = new PUPDMD::DMD();
             m_pPUPDMD->SetLogCallback(PUPDMDLogCallback, nullptr);
 
-            if (!m_pPUPDMD->Load(m_pupVideosPath, m_romName, m_pUpdateBufferQueue[bufferPositionMod]->depth))
+            if (!m_pPUPDMD->Load(m_pupVideosPath, m_romName, frame->depth))
             {
               delete (m_pPUPDMD);
               m_pPUPDMD = nullptr;
@@ -3753,18 +4101,17 @@ void DMD::PupDMDThread()
         }
       }
 
-      if (m_pPUPDMD && m_pUpdateBufferQueue[bufferPositionMod]->hasData &&
-          m_pUpdateBufferQueue[bufferPositionMod]->mode == Mode::Data &&
-          m_pUpdateBufferQueue[bufferPositionMod]->depth != 24)
+      if (m_pPUPDMD && frame->hasData && frame->mode == Mode::Data && frame->depth != 24)
       {
-        uint16_t width = m_pUpdateBufferQueue[bufferPositionMod]->width;
-        uint16_t height = m_pUpdateBufferQueue[bufferPositionMod]->height;
+        uint16_t width = frame->width;
+        uint16_t height = frame->height;
         int length = (int)width * height;
 
-        if (memcmp(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length) != 0)
+        if (frame->hash != renderHash)
         {
-          memcpy(renderBuffer, m_pUpdateBufferQueue[bufferPositionMod]->data, length);
-          uint8_t depth = m_pUpdateBufferQueue[bufferPositionMod]->depth;
+          renderHash = frame->hash;
+          memcpy(renderBuffer, frame->data, length);
+          uint8_t depth = frame->depth;
 
           uint8_t scaledBuffer[128 * 32];
           if (width == 128 && height == 32)
@@ -3820,16 +4167,14 @@ void DMD::SetPUPTrigger(const char source, const uint16_t event, const uint8_t v
 {
   if (m_pSerum && source == 'D' && value == 1)
   {
-    auto commandUpdate = std::make_shared<Update>();
-    commandUpdate->mode = Mode::SerumCommand;
-    commandUpdate->hasData = true;
-    commandUpdate->hasSegData = true;
-    commandUpdate->hasSegData2 = false;
-    commandUpdate->data[0] = static_cast<uint8_t>(source);
-    commandUpdate->data[1] = value;
-    commandUpdate->segData[0] = event;
-
-    QueueUpdate(commandUpdate, false);
+    std::shared_ptr<FrameSlot> commandFrame = m_pFrameSlotPool->Acquire(Mode::SerumCommand, 0, 0);
+    commandFrame->hasData = true;
+    commandFrame->hasSegData = true;
+    commandFrame->data[0] = static_cast<uint8_t>(source);
+    commandFrame->data[1] = value;
+    commandFrame->segData[0] = event;
+
+    QueueFrame(commandFrame, false);
   }
 }
 
@@ -2,22 +2,68 @@
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <winsock2.h>  // Windows byte-order functions
+#define DMDSERVER_POLL WSAPoll
 #else
 #include <arpa/inet.h>  // Linux/macOS byte-order functions
+#include <poll.h>
+#include <unistd.h>
+#define DMDSERVER_POLL poll
 #endif
 
 #include <algorithm>
 #include <chrono>
-#include <iostream>
-#include <sstream>
+#include <cstring>
+#include <memory>
 
 #include "DMDUtil/DMD.h"
 #include "DMDUtil/Logger.h"
+#include "PixelKernels.h"
+#include "miniz/miniz.h"
 #include "sockpp/tcp_acceptor.h"
 
 namespace DMDUtil
 {
 
+namespace
+{
+constexpr size_t kMaxPayloadSize =
+    sizeof(DMD::Update::data) + sizeof(DMD::Update::segData) + sizeof(DMD::Update::segData2);
+
+// The largest message that might follow a StreamHeader.
+size_t GetMaxMessageLength()
+{
+  return std::max(sizeof(DMD::PathsHeader) + sizeof(DMD::Update),
+                  sizeof(DMD::FrameHeader) + sizeof(DMD::PathsHeader) + (size_t)mz_compressBound(kMaxPayloadSize));
+}
+}  // namespace
+
+struct DMDServer::Client
+{
+  sockpp::stream_socket sock;
+  uint32_t id = 0;
+  std::vector<uint8_t> buffer;
+  size_t bufferFilled = 0;
+  bool handleDisconnectOthers = true;
+  bool logged = false;
+  bool buffered = false;
+
+  // Protocol version 2 only sends the paths on change and reuses the update for every frame of this client.
+  DMD::PathsHeader pathsHeader;
+  bool hasPathsHeader = false;
+  std::shared_ptr<DMD::Update> update = std::make_shared<DMD::Update>();
+  std::vector<uint8_t> payload;
+  std::vector<uint8_t> reference;
+  DMD::FrameHeader referenceHeader;
+  bool hasReference = false;
+
+  uint64_t frames = 0;
+  uint64_t compressedFrames = 0;
+  uint64_t deltaFrames = 0;
+  uint64_t payloadBytes = 0;
+  uint64_t receivedBytes = 0;
+  uint64_t decodeTimeUs = 0;
+};
+
 DMDServer::DMDServer(DMD* dmd, bool fixedAltColorPath, bool fixedPupPath)
     : m_dmd(dmd), m_fixedAltColorPath(fixedAltColorPath), m_fixedPupPath(fixedPupPath)
 {
@@ -25,7 +71,7 @@ DMDServer::DMDServer(DMD* dmd, bool fixedAltColorPath, bool fixedPupPath)
 
 DMDServer::~DMDServer() { Stop(); }
 
-bool DMDServer::Start(const char* addr, in_port_t port)
+bool DMDServer::Start(const char* addr, in_port_t port, const char* unixSocketPath)
 {
   if (m_running.load(std::memory_order_acquire) || !m_dmd->HasDisplay()) return false;
 
@@ -39,8 +85,32 @@ bool DMDServer::Start(const char* addr, in_port_t port)
 
   m_acceptor.set_non_blocking();
 
+#if !defined(_WIN32) && !defined(_WIN64)
+  // Local clients could use the Unix domain socket instead of TCP. It's optional, TCP always works as fallback.
+  if (unixSocketPath && unixSocketPath[0] != '\0')
+  {
+    // Remove a stale socket file of a previous run.
+    unlink(unixSocketPath);
+    m_unixAcceptor = sockpp::unix_acceptor(sockpp::unix_address(unixSocketPath));
+    if (m_unixAcceptor)
+    {
+      m_unixAcceptor.set_non_blocking();
+      m_unixSocketPath = unixSocketPath;
+      Log(DMDUtil_LogLevel_INFO, "DMDServer listening on %s", unixSocketPath);
+    }
+    else
+    {
+      Log(DMDUtil_LogLevel_ERROR, "Error creating DMDServer acceptor on %s: %s", unixSocketPath,
+          m_unixAcceptor.last_error_str().c_str());
+    }
+  }
+#endif
+
+  m_lastClientId = 0;
+  m_currentClientId = 0;
+  m_disconnectOtherClients = 0;
   m_running.store(true, std::memory_order_release);
-  m_acceptThread = new std::thread(&DMDServer::AcceptLoop, this);
+  m_pServerThread = new std::thread(&DMDServer::Run, this);
   return true;
 }
 
@@ -48,205 +118,183 @@ void DMDServer::Stop()
 {
   m_running.store(false, std::memory_order_release);
 
-  if (m_acceptThread)
+  if (m_pServerThread)
   {
-    m_acceptThread->join();
-    delete m_acceptThread;
-    m_acceptThread = nullptr;
+    m_pServerThread->join();
+    delete m_pServerThread;
+    m_pServerThread = nullptr;
   }
 
-  std::unique_lock<std::mutex> lock(m_threadMutex);
-  m_currentThreadId = 0;
+  m_currentClientId = 0;
   m_disconnectOtherClients = 0;
-  lock.unlock();
+
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (!m_unixSocketPath.empty())
+  {
+    m_unixAcceptor.close();
+    unlink(m_unixSocketPath.c_str());
+    m_unixSocketPath.clear();
+  }
+#endif
 }
 
-void DMDServer::AcceptLoop()
+void DMDServer::Run()
 {
-  uint32_t threadId = 0;
+  std::vector<pollfd> fds;
+  std::vector<Client*> clients;
 
   while (m_running.load(std::memory_order_relaxed))
   {
-    sockpp::inet_address peer;
-    sockpp::tcp_socket sock = m_acceptor.accept(&peer);
+    fds.clear();
+    fds.push_back({m_acceptor.handle(), POLLIN, 0});
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (!m_unixSocketPath.empty()) fds.push_back({m_unixAcceptor.handle(), POLLIN, 0});
+#endif
+    const size_t numAcceptors = fds.size();
+    clients = m_clients;
+    for (Client* pClient : clients) fds.push_back({pClient->sock.handle(), POLLIN, 0});
 
-    if (!sock)
+    // The timeout is only required to notice Stop().
+    int ready = DMDSERVER_POLL(fds.data(), fds.size(), 100);
+    if (ready < 0)
+    {
+      Log(DMDUtil_LogLevel_ERROR, "DMDServer poll failed");
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      continue;
+    }
+    if (ready == 0) continue;
+
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+      if (fds[numAcceptors + i].revents != 0 && !ReadClient(clients[i])) CloseClient(clients[i]);
+    }
+
+    // Only the current (most recent) client is allowed to disconnect other clients.
+    if (m_disconnectOtherClients != 0)
     {
-      if (m_acceptor.last_error() == EWOULDBLOCK)
+      clients = m_clients;
+      for (Client* pClient : clients)
       {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        continue;
+        if (pClient->id != m_currentClientId && pClient->id < m_disconnectOtherClients) CloseClient(pClient);
       }
+    }
 
-      Log(DMDUtil_LogLevel_ERROR, "Error accepting connection: %s", m_acceptor.last_error_str().c_str());
-      continue;
+    for (size_t i = 0; i < numAcceptors; i++)
+    {
+      if (fds[i].revents & POLLIN)
+      {
+        AcceptClients();
+        break;
+      }
+    }
+  }
+
+  clients = m_clients;
+  for (Client* pClient : clients) CloseClient(pClient);
+}
+
+void DMDServer::AcceptClients()
+{
+  while (true)
+  {
+    sockpp::inet_address peer;
+    sockpp::tcp_socket sock = m_acceptor.accept(&peer);
+
+    if (!sock)
+    {
+      if (m_acceptor.last_error() != EWOULDBLOCK)
+        Log(DMDUtil_LogLevel_ERROR, "Error accepting connection: %s", m_acceptor.last_error_str().c_str());
+      break;
     }
 
-    std::unique_lock<std::mutex> lock(m_threadMutex);
-    m_currentThreadId = ++threadId;
-    m_threads.push_back(m_currentThreadId);
-    lock.unlock();
+    AddClient(std::move(sock));
+  }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+  while (!m_unixSocketPath.empty())
+  {
+    sockpp::unix_socket sock = m_unixAcceptor.accept();
+
+    if (!sock)
+    {
+      if (m_unixAcceptor.last_error() != EWOULDBLOCK)
+        Log(DMDUtil_LogLevel_ERROR, "Error accepting connection: %s", m_unixAcceptor.last_error_str().c_str());
+      break;
+    }
 
-    std::thread thr(&DMDServer::ClientThread, this, std::move(sock), m_currentThreadId);
-    thr.detach();
+    AddClient(std::move(sock));
   }
+#endif
 }
 
-void DMDServer::ClientThread(sockpp::tcp_socket sock, uint32_t threadId)
+void DMDServer::AddClient(sockpp::stream_socket sock)
 {
-  // Socket auf non-blocking setzen
   sock.set_non_blocking();
 
-  uint8_t buffer[sizeof(DMDUtil::DMD::Update)];
-  DMDUtil::DMD::StreamHeader* pStreamHeader = (DMDUtil::DMD::StreamHeader*)malloc(sizeof(DMDUtil::DMD::StreamHeader));
-  ssize_t n;
-  bool handleDisconnectOthers = true;
-  bool logged = false;
+  Client* pClient = new Client();
+  pClient->sock = std::move(sock);
+  pClient->id = ++m_lastClientId;
+  pClient->buffer.resize(sizeof(DMD::StreamHeader) + GetMaxMessageLength());
+  pClient->payload.resize(kMaxPayloadSize);
+  pClient->reference.resize(kMaxPayloadSize);
+  m_clients.push_back(pClient);
+  m_currentClientId = pClient->id;
 
-  DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: New DMD client %d connected", threadId, threadId);
+  Log(DMDUtil_LogLevel_INFO, "%d: New DMD client %d connected", pClient->id, pClient->id);
+}
 
-  while (m_running.load(std::memory_order_relaxed) &&
-         (threadId == m_currentThreadId || m_disconnectOtherClients == 0 || m_disconnectOtherClients <= threadId))
+bool DMDServer::ReadClient(Client* pClient)
+{
+  while (true)
   {
-    n = sock.read_n(buffer, sizeof(DMDUtil::DMD::StreamHeader));
-
+    ssize_t n = pClient->sock.read(pClient->buffer.data() + pClient->bufferFilled,
+                                   pClient->buffer.size() - pClient->bufferFilled);
     if (n < 0)
     {
-      if (sock.last_error() == EWOULDBLOCK)
-      {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        continue;
-      }
-
-      // network error or connection closed
-      break;
+      // Everything available has been read, otherwise it is a network error.
+      return pClient->sock.last_error() == EWOULDBLOCK;
     }
     else if (n == 0)
     {
       // connection closed by client
-      break;
+      return false;
     }
-    else if (n == sizeof(DMDUtil::DMD::StreamHeader))
-    {
-      memcpy(pStreamHeader, buffer, n);
-      pStreamHeader->convertToHostByteOrder();
-      if (strcmp(pStreamHeader->header, "DMDStream") == 0 && pStreamHeader->version == 1)
-      {
-        DMDUtil::Log(DMDUtil_LogLevel_DEBUG, "%d: Received DMDStream header version %d for DMD mode %d", threadId,
-                     pStreamHeader->version, pStreamHeader->mode);
-        if (pStreamHeader->buffered && threadId == m_currentThreadId)
-          DMDUtil::Log(DMDUtil_LogLevel_DEBUG, "%d: Next data will be buffered", threadId);
 
-        // Only the current (most recent) thread is allowed to disconnect other clients.
-        if (handleDisconnectOthers && threadId == m_currentThreadId && pStreamHeader->disconnectOthers)
-        {
-          m_threadMutex.lock();
-          m_disconnectOtherClients = threadId;
-          m_threadMutex.unlock();
-          handleDisconnectOthers = false;
-          DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Other clients will be disconnected", threadId);
-        }
+    pClient->bufferFilled += n;
+    if (!ProcessMessages(pClient)) return false;
+  }
+}
 
-        switch (pStreamHeader->mode)
+bool DMDServer::ProcessMessages(Client* pClient)
+{
+  size_t offset = 0;
+  while (pClient->bufferFilled - offset >= sizeof(DMD::StreamHeader))
+  {
+    DMD::StreamHeader streamHeader;
+    memcpy(&streamHeader, pClient->buffer.data() + offset, sizeof(DMD::StreamHeader));
+    streamHeader.convertToHostByteOrder();
+
+    const bool known = strncmp(streamHeader.header, "DMDStream", sizeof(streamHeader.header)) == 0 &&
+                       (streamHeader.version == 1 || streamHeader.version == 2);
+    size_t length = 0;
+    if (known)
+    {
+      if (streamHeader.version == 2)
+      {
+        length = streamHeader.length;
+      }
+      else
+      {
+        switch (streamHeader.mode)
         {
-          case DMDUtil::DMD::Mode::Data:
-          case DMDUtil::DMD::Mode::SerumCommand:
-            if ((n = sock.read_n(buffer, sizeof(DMDUtil::DMD::PathsHeader))) == sizeof(DMDUtil::DMD::PathsHeader))
-            {
-              DMDUtil::DMD::PathsHeader pathsHeader;
-              memcpy(&pathsHeader, buffer, n);
-              pathsHeader.convertToHostByteOrder();
-
-              if (strcmp(pathsHeader.header, "Paths") == 0 &&
-                  (n = sock.read_n(buffer, sizeof(DMDUtil::DMD::Update))) == sizeof(DMDUtil::DMD::Update) &&
-                  threadId == m_currentThreadId)
-              {
-                DMDUtil::Log(DMDUtil_LogLevel_DEBUG,
-                             "%d: Received paths header: ROM '%s', AltColorPath '%s', PupPath '%s'", threadId,
-                             pathsHeader.name, pathsHeader.altColorPath, pathsHeader.pupVideosPath);
-                auto data = std::make_shared<DMDUtil::DMD::Update>();
-                memcpy(data.get(), buffer, n);
-                data->convertToHostByteOrder();
-                logged = false;
-
-                if (data->width <= DMDSERVER_MAX_WIDTH && data->height <= DMDSERVER_MAX_HEIGHT)
-                {
-                  m_dmd->SetRomName(pathsHeader.name);
-                  if (!m_fixedAltColorPath) m_dmd->SetAltColorPath(pathsHeader.altColorPath);
-                  if (!m_fixedPupPath) m_dmd->SetPUPVideosPath(pathsHeader.pupVideosPath);
-
-                  m_dmd->QueueUpdate(data, (pStreamHeader->buffered == 1));
-                }
-                else
-                {
-                  DMDUtil::Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package is missing or corrupted!", threadId);
-                }
-              }
-              else if (threadId != m_currentThreadId)
-              {
-                if (!logged)
-                {
-                  DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", threadId, m_currentThreadId);
-                  logged = true;
-                }
-                DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", threadId, m_currentThreadId);
-              }
-              else
-              {
-                DMDUtil::Log(DMDUtil_LogLevel_ERROR, "%d: Paths header is missing!", threadId);
-              }
-            }
-            break;
-
-          case DMDUtil::DMD::Mode::RGB16:
-            if ((n = sock.read_n(buffer, pStreamHeader->length)) == pStreamHeader->length &&
-                threadId == m_currentThreadId && pStreamHeader->width <= DMDSERVER_MAX_WIDTH &&
-                pStreamHeader->height <= DMDSERVER_MAX_HEIGHT)
-            {
-              uint16_t* pixelData = (uint16_t*)buffer;
-              size_t pixelCount = pStreamHeader->length / sizeof(uint16_t);
-              for (size_t i = 0; i < pixelCount; i++)
-              {
-                pixelData[i] = ntohs(pixelData[i]);
-              }
-              logged = false;
-              m_dmd->UpdateRGB16Data((uint16_t*)buffer, pStreamHeader->width, pStreamHeader->height,
-                                     pStreamHeader->buffered == 1);
-            }
-            else if (threadId != m_currentThreadId)
-            {
-              if (!logged)
-              {
-                DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", threadId, m_currentThreadId);
-                logged = true;
-              }
-            }
-            else
-            {
-              DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: TCP data package is missing or corrupted!", threadId);
-            }
+          case DMD::Mode::Data:
+          case DMD::Mode::SerumCommand:
+            length = sizeof(DMD::PathsHeader) + sizeof(DMD::Update);
             break;
 
-          case DMDUtil::DMD::Mode::RGB24:
-            if ((n = sock.read_n(buffer, pStreamHeader->length)) == pStreamHeader->length &&
-                threadId == m_currentThreadId && pStreamHeader->width <= DMDSERVER_MAX_WIDTH &&
-                pStreamHeader->height <= DMDSERVER_MAX_HEIGHT)
-            {
-              logged = false;
-              m_dmd->UpdateRGB24Data(buffer, pStreamHeader->width, pStreamHeader->height, pStreamHeader->buffered == 1);
-            }
-            else if (threadId != m_currentThreadId)
-            {
-              if (!logged)
-              {
-                DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", threadId, m_currentThreadId);
-                logged = true;
-              }
-            }
-            else
-            {
-              DMDUtil::Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package is missing or corrupted!", threadId);
-            }
+          case DMD::Mode::RGB16:
+          case DMD::Mode::RGB24:
+            length = streamHeader.length;
             break;
 
           default:
@@ -254,57 +302,340 @@ void DMDServer::ClientThread(sockpp::tcp_socket sock, uint32_t threadId)
             break;
         }
       }
-      else if (threadId == m_currentThreadId)
+
+      if (length > GetMaxMessageLength())
       {
-        DMDUtil::Log(DMDUtil_LogLevel_DEBUG, "%d: Received unknown TCP package", threadId);
+        Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package of %u bytes is too large!", pClient->id,
+            (uint32_t)length);
+        return false;
       }
     }
+
+    // Wait for the rest of the message.
+    if (pClient->bufferFilled - offset < sizeof(DMD::StreamHeader) + length) break;
+
+    if (known)
+      HandleMessage(pClient, streamHeader, pClient->buffer.data() + offset + sizeof(DMD::StreamHeader), length);
+    else if (pClient->id == m_currentClientId)
+      Log(DMDUtil_LogLevel_DEBUG, "%d: Received unknown TCP package", pClient->id);
+
+    offset += sizeof(DMD::StreamHeader) + length;
+  }
+
+  if (offset > 0)
+  {
+    memmove(pClient->buffer.data(), pClient->buffer.data() + offset, pClient->bufferFilled - offset);
+    pClient->bufferFilled -= offset;
   }
+  return true;
+}
+
+void DMDServer::HandleMessage(Client* pClient, const DMD::StreamHeader& streamHeader, uint8_t* pData, size_t length)
+{
+  const uint32_t id = pClient->id;
 
-  if (m_disconnectOtherClients != 0 && m_disconnectOtherClients > threadId)
-    DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Client %d requested disconnect", threadId, m_disconnectOtherClients);
+  Log(DMDUtil_LogLevel_DEBUG, "%d: Received DMDStream header version %d for DMD mode %d", id, streamHeader.version,
+      streamHeader.mode);
+  if (streamHeader.buffered && id == m_currentClientId) Log(DMDUtil_LogLevel_DEBUG, "%d: Next data will be buffered", id);
+  pClient->buffered = (streamHeader.buffered == 1);
 
-  // Display a buffered frame or clear the display on disconnect of the current thread.
-  if (threadId == m_currentThreadId && !pStreamHeader->buffered && !m_dmd->QueueBuffer())
+  if (pClient->handleDisconnectOthers && id == m_currentClientId && streamHeader.disconnectOthers)
   {
-    m_dmd->SetRomName("");
-    DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: Clear screen on disconnect", threadId);
-    // Clear the DMD by sending a black screen.
-    // Fixed dimension of 128x32 should be OK for all devices.
-    memset(buffer, 0, 128 * 32 * 3);
-    m_dmd->UpdateRGB24Data(buffer, 128, 32, true);
+    m_disconnectOtherClients = id;
+    pClient->handleDisconnectOthers = false;
+    Log(DMDUtil_LogLevel_INFO, "%d: Other clients will be disconnected", id);
+  }
+
+  if (streamHeader.version == 2)
+  {
+    HandleFrame(pClient, streamHeader, pData, length);
+    return;
   }
 
-  m_threadMutex.lock();
-  m_threads.erase(remove(m_threads.begin(), m_threads.end(), threadId), m_threads.end());
-  if (threadId == m_currentThreadId)
+  switch (streamHeader.mode)
   {
-    if (m_disconnectOtherClients == threadId)
+    case DMD::Mode::Data:
+    case DMD::Mode::SerumCommand:
     {
-      // Wait until all other threads ended or a new client connnects in between.
-      while (m_threads.size() >= 1 && m_currentThreadId == threadId)
+      DMD::PathsHeader pathsHeader;
+      memcpy(&pathsHeader, pData, sizeof(DMD::PathsHeader));
+      pathsHeader.convertToHostByteOrder();
+
+      if (strncmp(pathsHeader.header, "Paths", sizeof(pathsHeader.header)) == 0 && id == m_currentClientId)
+      {
+        Log(DMDUtil_LogLevel_DEBUG, "%d: Received paths header: ROM '%s', AltColorPath '%s', PupPath '%s'", id,
+            pathsHeader.name, pathsHeader.altColorPath, pathsHeader.pupVideosPath);
+        DMD::Update* pUpdate = pClient->update.get();
+        memcpy(pUpdate, pData + sizeof(DMD::PathsHeader), sizeof(DMD::Update));
+        pUpdate->convertToHostByteOrder();
+        pClient->logged = false;
+
+        if (pUpdate->width <= DMDSERVER_MAX_WIDTH && pUpdate->height <= DMDSERVER_MAX_HEIGHT)
+        {
+          m_dmd->SetRomName(pathsHeader.name);
+          if (!m_fixedAltColorPath) m_dmd->SetAltColorPath(pathsHeader.altColorPath);
+          if (!m_fixedPupPath) m_dmd->SetPUPVideosPath(pathsHeader.pupVideosPath);
+
+          m_dmd->QueueUpdate(pClient->update, pClient->buffered);
+        }
+        else
+        {
+          Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package is missing or corrupted!", id);
+        }
+      }
+      else if (id != m_currentClientId)
+      {
+        if (!pClient->logged)
+        {
+          Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", id, m_currentClientId);
+          pClient->logged = true;
+        }
+      }
+      else
+      {
+        Log(DMDUtil_LogLevel_ERROR, "%d: Paths header is missing!", id);
+      }
+      break;
+    }
+
+    case DMD::Mode::RGB16:
+      if (id == m_currentClientId && streamHeader.width <= DMDSERVER_MAX_WIDTH &&
+          streamHeader.height <= DMDSERVER_MAX_HEIGHT &&
+          length >= (size_t)streamHeader.width * streamHeader.height * sizeof(uint16_t))
+      {
+        uint16_t* pixelData = (uint16_t*)pData;
+        PixelKernels::ConvertByteOrder16(pixelData, pixelData, length / sizeof(uint16_t));
+        pClient->logged = false;
+        m_dmd->UpdateRGB16Data(pixelData, streamHeader.width, streamHeader.height, pClient->buffered);
+      }
+      else if (id != m_currentClientId)
+      {
+        if (!pClient->logged)
+        {
+          Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", id, m_currentClientId);
+          pClient->logged = true;
+        }
+      }
+      else
+      {
+        Log(DMDUtil_LogLevel_INFO, "%d: TCP data package is missing or corrupted!", id);
+      }
+      break;
+
+    case DMD::Mode::RGB24:
+      if (id == m_currentClientId && streamHeader.width <= DMDSERVER_MAX_WIDTH &&
+          streamHeader.height <= DMDSERVER_MAX_HEIGHT && length >= (size_t)streamHeader.width * streamHeader.height * 3)
+      {
+        pClient->logged = false;
+        m_dmd->UpdateRGB24Data(pData, streamHeader.width, streamHeader.height, pClient->buffered);
+      }
+      else if (id != m_currentClientId)
+      {
+        if (!pClient->logged)
+        {
+          Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", id, m_currentClientId);
+          pClient->logged = true;
+        }
+      }
+      else
       {
-        m_threadMutex.unlock();
-        // Let other threads terminate.
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        m_threadMutex.lock();
+        Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package is missing or corrupted!", id);
       }
+      break;
+
+    default:
+      // Other modes aren't supported via network.
+      break;
+  }
+}
+
+void DMDServer::HandleFrame(Client* pClient, const DMD::StreamHeader& streamHeader, const uint8_t* pData,
+                            size_t length)
+{
+  const uint32_t id = pClient->id;
+  DMD::Update* pUpdate = pClient->update.get();
 
-      m_currentThreadId = 0;
+  DMD::FrameHeader frameHeader;
+  bool valid = length >= sizeof(DMD::FrameHeader);
+  if (valid)
+  {
+    memcpy(&frameHeader, pData, sizeof(DMD::FrameHeader));
+    frameHeader.convertToHostByteOrder();
+    pData += sizeof(DMD::FrameHeader);
+    length -= sizeof(DMD::FrameHeader);
+
+    valid = strncmp(frameHeader.header, "Frame", sizeof(frameHeader.header)) == 0 &&
+            frameHeader.width <= DMDSERVER_MAX_WIDTH && frameHeader.height <= DMDSERVER_MAX_HEIGHT &&
+            frameHeader.dataLength <= sizeof(pUpdate->data) &&
+            frameHeader.segDataLength <= sizeof(pUpdate->segData) / sizeof(uint16_t) &&
+            frameHeader.segData2Length <= sizeof(pUpdate->segData2) / sizeof(uint16_t);
+  }
+
+  if (valid && (frameHeader.flags & DMDUTIL_FRAME_FLAG_PATHS))
+  {
+    valid = length >= sizeof(DMD::PathsHeader);
+    if (valid)
+    {
+      memcpy(&pClient->pathsHeader, pData, sizeof(DMD::PathsHeader));
+      pClient->pathsHeader.convertToHostByteOrder();
+      pData += sizeof(DMD::PathsHeader);
+      length -= sizeof(DMD::PathsHeader);
+
+      valid = strncmp(pClient->pathsHeader.header, "Paths", sizeof(pClient->pathsHeader.header)) == 0;
+      pClient->hasPathsHeader = valid;
+      if (valid)
+        Log(DMDUtil_LogLevel_DEBUG, "%d: Received paths header: ROM '%s', AltColorPath '%s', PupPath '%s'", id,
+            pClient->pathsHeader.name, pClient->pathsHeader.altColorPath, pClient->pathsHeader.pupVideosPath);
+    }
+  }
+
+  const size_t payloadLength =
+      frameHeader.dataLength + (frameHeader.segDataLength + frameHeader.segData2Length) * sizeof(uint16_t);
+  const uint8_t* pPayload = pData;
+  if (valid && (frameHeader.flags & DMDUTIL_FRAME_FLAG_COMPRESSED))
+  {
+    auto start = std::chrono::steady_clock::now();
+    mz_ulong uncompressedLength = (mz_ulong)pClient->payload.size();
+    valid = mz_uncompress(pClient->payload.data(), &uncompressedLength, pData, (mz_ulong)length) == MZ_OK &&
+            uncompressedLength == payloadLength;
+    pClient->decodeTimeUs +=
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    pClient->compressedFrames++;
+    pPayload = pClient->payload.data();
+  }
+  else if (valid)
+  {
+    valid = length == payloadLength;
+  }
+
+  if (valid && (frameHeader.flags & DMDUTIL_FRAME_FLAG_DELTA))
+  {
+    // A delta can only be applied to the previous frame of the same mode and size.
+    valid = pClient->hasReference && pClient->referenceHeader.mode == frameHeader.mode &&
+            pClient->referenceHeader.width == frameHeader.width &&
+            pClient->referenceHeader.height == frameHeader.height &&
+            pClient->referenceHeader.dataLength == frameHeader.dataLength &&
+            pClient->referenceHeader.segDataLength == frameHeader.segDataLength &&
+            pClient->referenceHeader.segData2Length == frameHeader.segData2Length;
+    if (valid)
+    {
+      uint8_t* pReference = pClient->reference.data();
+      for (size_t i = 0; i < payloadLength; i++) pReference[i] ^= pPayload[i];
+      pClient->deltaFrames++;
+    }
+    else
+    {
+      Log(DMDUtil_LogLevel_DEBUG, "%d: Dropping delta frame until the next keyframe", id);
+    }
+  }
+  else if (valid)
+  {
+    memcpy(pClient->reference.data(), pPayload, payloadLength);
+  }
+
+  if (!valid)
+  {
+    pClient->hasReference = false;
+    if (id == m_currentClientId) Log(DMDUtil_LogLevel_ERROR, "%d: TCP data package is missing or corrupted!", id);
+    return;
+  }
+
+  // The reference holds the complete payload of this frame now.
+  pClient->referenceHeader = frameHeader;
+  pClient->hasReference = true;
+  pClient->frames++;
+  pClient->payloadBytes += payloadLength;
+  pClient->receivedBytes += length;
+
+  if (id != m_currentClientId)
+  {
+    if (!pClient->logged)
+    {
+      Log(DMDUtil_LogLevel_INFO, "%d: Client %d blocks the DMD", id, m_currentClientId);
+      pClient->logged = true;
+    }
+    return;
+  }
+
+  pPayload = pClient->reference.data();
+  memcpy(pUpdate->data, pPayload, frameHeader.dataLength);
+  pPayload += frameHeader.dataLength;
+  memcpy(pUpdate->segData, pPayload, frameHeader.segDataLength * sizeof(uint16_t));
+  pPayload += frameHeader.segDataLength * sizeof(uint16_t);
+  memcpy(pUpdate->segData2, pPayload, frameHeader.segData2Length * sizeof(uint16_t));
+
+  pUpdate->mode = frameHeader.mode;
+  pUpdate->layout = frameHeader.layout;
+  pUpdate->depth = frameHeader.depth;
+  pUpdate->hasData = (frameHeader.flags & DMDUTIL_FRAME_FLAG_HAS_DATA);
+  pUpdate->hasSegData = (frameHeader.flags & DMDUTIL_FRAME_FLAG_HAS_SEG_DATA);
+  pUpdate->hasSegData2 = (frameHeader.flags & DMDUTIL_FRAME_FLAG_HAS_SEG_DATA2);
+  pUpdate->r = frameHeader.r;
+  pUpdate->g = frameHeader.g;
+  pUpdate->b = frameHeader.b;
+  pUpdate->width = frameHeader.width;
+  pUpdate->height = frameHeader.height;
+  PixelKernels::ConvertByteOrder16(pUpdate->segData, pUpdate->segData, frameHeader.segDataLength);
+  PixelKernels::ConvertByteOrder16(pUpdate->segData2, pUpdate->segData2, frameHeader.segData2Length);
+  pClient->logged = false;
+
+  // Another client might have been the current one in between, so the paths are applied on every frame.
+  if (pClient->hasPathsHeader)
+  {
+    m_dmd->SetRomName(pClient->pathsHeader.name);
+    if (!m_fixedAltColorPath) m_dmd->SetAltColorPath(pClient->pathsHeader.altColorPath);
+    if (!m_fixedPupPath) m_dmd->SetPUPVideosPath(pClient->pathsHeader.pupVideosPath);
+  }
+
+  m_dmd->QueueUpdate(pClient->update, pClient->buffered);
+}
+
+void DMDServer::CloseClient(Client* pClient)
+{
+  const uint32_t id = pClient->id;
+
+  if (m_disconnectOtherClients != 0 && m_disconnectOtherClients > id)
+    Log(DMDUtil_LogLevel_INFO, "%d: Client %d requested disconnect", id, m_disconnectOtherClients);
+
+  // Display a buffered frame or clear the display on disconnect of the current client.
+  if (id == m_currentClientId && !pClient->buffered && !m_dmd->QueueBuffer())
+  {
+    m_dmd->SetRomName("");
+    Log(DMDUtil_LogLevel_INFO, "%d: Clear screen on disconnect", id);
+    // Clear the DMD by sending a black screen.
+    // Fixed dimension of 128x32 should be OK for all devices.
+    uint8_t black[128 * 32 * 3] = {0};
+    m_dmd->UpdateRGB24Data(black, 128, 32, true);
+  }
+
+  pClient->sock.close();
+  m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), pClient), m_clients.end());
+
+  if (id == m_currentClientId)
+  {
+    if (m_disconnectOtherClients == id)
+    {
+      m_currentClientId = 0;
       m_disconnectOtherClients = 0;
     }
     else
     {
-      m_currentThreadId = (m_threads.size() >= 1) ? m_threads.back() : 0;
+      m_currentClientId = !m_clients.empty() ? m_clients.back()->id : 0;
     }
 
-    DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: DMD client %d set as current", threadId, m_currentThreadId);
+    Log(DMDUtil_LogLevel_INFO, "%d: DMD client %d set as current", id, m_currentClientId);
   }
-  m_threadMutex.unlock();
 
-  DMDUtil::Log(DMDUtil_LogLevel_INFO, "%d: DMD client %d disconnected", threadId, threadId);
+  Log(DMDUtil_LogLevel_INFO, "%d: DMD client %d disconnected", id, id);
+  if (pClient->frames > 0)
+    Log(DMDUtil_LogLevel_INFO,
+        "%d: DMD client %d stats: frames=%llu, compressed=%llu, delta=%llu, ratio=%.2f, avg decode time=%llu us", id,
+        id, (unsigned long long)pClient->frames, (unsigned long long)pClient->compressedFrames,
+        (unsigned long long)pClient->deltaFrames,
+        pClient->receivedBytes > 0 ? (double)pClient->payloadBytes / pClient->receivedBytes : 0.0,
+        (unsigned long long)(pClient->compressedFrames > 0 ? pClient->decodeTimeUs / pClient->compressedFrames : 0));
 
-  free(pStreamHeader);
+  delete pClient;
 }
 
 }  // namespace DMDUtil
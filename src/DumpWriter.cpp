@@ -0,0 +1,443 @@
+#include "DumpWriter.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <ctime>
+#include <unordered_set>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "DMDUtil/Logger.h"
+#include "miniz/miniz.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+// Buffers kept for reuse, enough for all dumpers.
+constexpr size_t kMaxFreeBuffers = 16;
+
+constexpr uint32_t kZipLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kZipDataDescriptorSignature = 0x08074b50;
+constexpr uint32_t kZipCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kZip64EndSignature = 0x06064b50;
+constexpr uint32_t kZip64LocatorSignature = 0x07064b50;
+constexpr uint32_t kZipEndSignature = 0x06054b50;
+// Sizes follow the data in a data descriptor.
+constexpr uint16_t kZipFlagDataDescriptor = 0x0008;
+constexpr uint16_t kZipMethodDeflate = 8;
+constexpr uint16_t kZipVersion = 20;
+constexpr uint16_t kZip64Version = 45;
+constexpr uint64_t kZip32Limit = 0xffffffff;
+
+void Put16(std::vector<uint8_t>& buffer, uint16_t value)
+{
+  buffer.push_back((uint8_t)value);
+  buffer.push_back((uint8_t)(value >> 8));
+}
+
+void Put32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+  for (int i = 0; i < 4; i++) buffer.push_back((uint8_t)(value >> (i * 8)));
+}
+
+void Put64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+  for (int i = 0; i < 8; i++) buffer.push_back((uint8_t)(value >> (i * 8)));
+}
+
+void SyncFile(FILE* pFile)
+{
+  fflush(pFile);
+#if defined(_WIN32) || defined(_WIN64)
+  _commit(_fileno(pFile));
+#else
+  fsync(fileno(pFile));
+#endif
+}
+}  // namespace
+
+DumpWriter::DumpWriter() { m_thread = std::thread(&DumpWriter::Run, this); }
+
+DumpWriter::~DumpWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void DumpWriter::Submit(Request&& request)
+{
+  const size_t size = request.buffer.size();
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_spaceCv.wait(lock,
+                   [&]() { return m_pendingBytes == 0 || m_pendingBytes + size <= DMDUTIL_DUMP_WRITER_MAX_PENDING; });
+    m_pendingBytes += size;
+    m_pendingRequests++;
+    m_queue.push_back(std::move(request));
+  }
+  m_cv.notify_one();
+}
+
+bool DumpWriter::WaitUntilWritten(std::chrono::steady_clock::time_point deadline)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_spaceCv.wait_until(lock, deadline, [&]() { return m_pendingRequests == 0; });
+}
+
+std::vector<uint8_t> DumpWriter::AcquireBuffer()
+{
+  std::vector<uint8_t> buffer;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_freeBuffers.empty())
+    {
+      buffer = std::move(m_freeBuffers.back());
+      m_freeBuffers.pop_back();
+    }
+  }
+  // Room for the last formatted line that crosses the limit.
+  buffer.reserve(DMDUTIL_DUMP_WRITER_BUFFER_SIZE + 4096);
+  return buffer;
+}
+
+void DumpWriter::Run()
+{
+  std::deque<Request> batch;
+  std::unordered_set<File*> written;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+      if (m_queue.empty()) return;
+      batch.swap(m_queue);
+    }
+
+    const bool sync = m_sync.load(std::memory_order_relaxed);
+    size_t batchBytes = 0;
+    for (Request& request : batch)
+    {
+      File* pFile = request.pFile;
+      batchBytes += request.buffer.size();
+      if (!request.buffer.empty() && !pFile->failed.load(std::memory_order_relaxed))
+      {
+        if (fwrite(request.buffer.data(), 1, request.buffer.size(), pFile->pFile) == request.buffer.size())
+        {
+          m_bytesWritten.fetch_add(request.buffer.size(), std::memory_order_relaxed);
+          if (sync) written.insert(pFile);
+        }
+        else
+        {
+          pFile->failed.store(true, std::memory_order_relaxed);
+          Log(DMDUtil_LogLevel_ERROR, "DumpWriter: Failed to write %s", pFile->path.c_str());
+        }
+      }
+
+      if (request.close)
+      {
+        if (sync) SyncFile(pFile->pFile);
+        if (fclose(pFile->pFile) != 0 && !pFile->failed.load(std::memory_order_relaxed))
+          Log(DMDUtil_LogLevel_ERROR, "DumpWriter: Failed to close %s", pFile->path.c_str());
+        written.erase(pFile);
+        delete pFile;
+      }
+    }
+
+    for (File* pFile : written) SyncFile(pFile->pFile);
+    written.clear();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (Request& request : batch)
+      {
+        if (request.buffer.capacity() == 0 || m_freeBuffers.size() >= kMaxFreeBuffers) continue;
+        request.buffer.clear();
+        m_freeBuffers.push_back(std::move(request.buffer));
+      }
+      m_pendingBytes -= batchBytes;
+      m_pendingRequests -= batch.size();
+    }
+    m_spaceCv.notify_all();
+    batch.clear();
+  }
+}
+
+struct DumpFile::ZipEntry
+{
+  tdefl_compressor* pCompressor = nullptr;
+  std::string name;
+  uint16_t dosTime = 0;
+  uint16_t dosDate = 0;
+  uint32_t crc = MZ_CRC32_INIT;
+  uint64_t size = 0;
+  uint64_t compressedSize = 0;
+  std::vector<uint8_t> compressed;
+
+  ~ZipEntry() { tdefl_compressor_free(pCompressor); }
+
+  static mz_bool PutCompressed(const void* pData, int length, void* pUser)
+  {
+    ZipEntry* pZip = (ZipEntry*)pUser;
+    const uint8_t* pBytes = (const uint8_t*)pData;
+    pZip->compressed.insert(pZip->compressed.end(), pBytes, pBytes + length);
+    pZip->compressedSize += length;
+    return MZ_TRUE;
+  }
+};
+
+DumpFile::DumpFile(DumpWriter& writer) : m_writer(writer) {}
+
+DumpFile::~DumpFile() { Close(); }
+
+bool DumpFile::Open(const char* path, const char* mode)
+{
+  Close();
+  return OpenFile(path, mode);
+}
+
+bool DumpFile::OpenZip(const char* path, const char* entryName, int compressionLevel)
+{
+  Close();
+
+  auto pZip = std::make_unique<ZipEntry>();
+  pZip->pCompressor = tdefl_compressor_alloc();
+  // Negative window bits for a raw deflate stream, as zip expects it.
+  if (!pZip->pCompressor ||
+      tdefl_init(pZip->pCompressor, &ZipEntry::PutCompressed, pZip.get(),
+                 (int)tdefl_create_comp_flags_from_zip_params(std::clamp(compressionLevel, 0, 9),
+                                                              -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY)) !=
+          TDEFL_STATUS_OKAY ||
+      !OpenFile(path, "wb"))
+    return false;
+
+  const time_t now = time(nullptr);
+  struct tm local;
+#if defined(_WIN32) || defined(_WIN64)
+  localtime_s(&local, &now);
+#else
+  localtime_r(&now, &local);
+#endif
+  pZip->dosTime = (uint16_t)((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec >> 1));
+  pZip->dosDate = (uint16_t)(((std::max(local.tm_year, 80) - 80) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+  pZip->name = entryName;
+  pZip->compressed = m_writer.AcquireBuffer();
+
+  // CRC and sizes are unknown yet, they follow the data.
+  std::vector<uint8_t>& header = pZip->compressed;
+  Put32(header, kZipLocalHeaderSignature);
+  Put16(header, kZipVersion);
+  Put16(header, kZipFlagDataDescriptor);
+  Put16(header, kZipMethodDeflate);
+  Put16(header, pZip->dosTime);
+  Put16(header, pZip->dosDate);
+  Put32(header, 0);
+  Put32(header, 0);
+  Put32(header, 0);
+  Put16(header, (uint16_t)pZip->name.size());
+  Put16(header, 0);
+  header.insert(header.end(), pZip->name.begin(), pZip->name.end());
+
+  m_pZip = std::move(pZip);
+  return true;
+}
+
+bool DumpFile::OpenFile(const char* path, const char* mode)
+{
+  FILE* pFile = fopen(path, mode);
+  if (!pFile) return false;
+
+  // The buffer of the DumpFile replaces the one of the stream.
+  setvbuf(pFile, nullptr, _IONBF, 0);
+  m_pFile = new DumpWriter::File();
+  m_pFile->pFile = pFile;
+  m_pFile->path = path;
+  m_buffer = m_writer.AcquireBuffer();
+  return true;
+}
+
+void DumpFile::Close()
+{
+  if (!m_pFile) return;
+
+  if (!m_pZip)
+  {
+    Submit(m_buffer, true);
+    return;
+  }
+
+  Deflate(true);
+  ZipEntry& zip = *m_pZip;
+  std::vector<uint8_t>& out = zip.compressed;
+  const uint64_t localHeaderSize = 30 + zip.name.size();
+  const bool zip64 = zip.size >= kZip32Limit || zip.compressedSize >= kZip32Limit;
+
+  Put32(out, kZipDataDescriptorSignature);
+  Put32(out, zip.crc);
+  if (zip64)
+  {
+    Put64(out, zip.compressedSize);
+    Put64(out, zip.size);
+  }
+  else
+  {
+    Put32(out, (uint32_t)zip.compressedSize);
+    Put32(out, (uint32_t)zip.size);
+  }
+  const uint64_t centralOffset = localHeaderSize + zip.compressedSize + (zip64 ? 24 : 16);
+
+  const size_t centralStart = out.size();
+  Put32(out, kZipCentralHeaderSignature);
+  Put16(out, zip64 ? kZip64Version : kZipVersion);
+  Put16(out, zip64 ? kZip64Version : kZipVersion);
+  Put16(out, kZipFlagDataDescriptor);
+  Put16(out, kZipMethodDeflate);
+  Put16(out, zip.dosTime);
+  Put16(out, zip.dosDate);
+  Put32(out, zip.crc);
+  Put32(out, zip64 ? (uint32_t)kZip32Limit : (uint32_t)zip.compressedSize);
+  Put32(out, zip64 ? (uint32_t)kZip32Limit : (uint32_t)zip.size);
+  Put16(out, (uint16_t)zip.name.size());
+  Put16(out, zip64 ? 20 : 0);
+  Put16(out, 0);
+  Put16(out, 0);
+  Put16(out, 0);
+  Put32(out, 0);
+  Put32(out, 0);
+  out.insert(out.end(), zip.name.begin(), zip.name.end());
+  if (zip64)
+  {
+    Put16(out, 0x0001);
+    Put16(out, 16);
+    Put64(out, zip.size);
+    Put64(out, zip.compressedSize);
+  }
+  const uint64_t centralSize = out.size() - centralStart;
+
+  if (zip64 || centralOffset >= kZip32Limit)
+  {
+    Put32(out, kZip64EndSignature);
+    Put64(out, 44);
+    Put16(out, kZip64Version);
+    Put16(out, kZip64Version);
+    Put32(out, 0);
+    Put32(out, 0);
+    Put64(out, 1);
+    Put64(out, 1);
+    Put64(out, centralSize);
+    Put64(out, centralOffset);
+
+    Put32(out, kZip64LocatorSignature);
+    Put32(out, 0);
+    Put64(out, centralOffset + centralSize);
+    Put32(out, 1);
+  }
+
+  Put32(out, kZipEndSignature);
+  Put16(out, 0);
+  Put16(out, 0);
+  Put16(out, 1);
+  Put16(out, 1);
+  Put32(out, (uint32_t)centralSize);
+  Put32(out, (uint32_t)std::min(centralOffset, kZip32Limit));
+  Put16(out, 0);
+
+  Submit(out, true);
+  m_pZip.reset();
+  m_buffer = std::vector<uint8_t>();
+}
+
+void DumpFile::Write(const void* pData, size_t size)
+{
+  if (!m_pFile) return;
+
+  const uint8_t* pBytes = (const uint8_t*)pData;
+  if (m_buffer.empty()) m_bufferStart = std::chrono::steady_clock::now();
+  m_buffer.insert(m_buffer.end(), pBytes, pBytes + size);
+  if (m_buffer.size() >= DMDUTIL_DUMP_WRITER_BUFFER_SIZE) Flush();
+}
+
+void DumpFile::Printf(const char* format, ...)
+{
+  if (!m_pFile) return;
+
+  char text[512];
+  va_list args;
+  va_start(args, format);
+  const int length = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (length <= 0) return;
+
+  if ((size_t)length < sizeof(text))
+  {
+    Write(text, length);
+    return;
+  }
+
+  std::vector<char> longText(length + 1);
+  va_start(args, format);
+  vsnprintf(longText.data(), longText.size(), format, args);
+  va_end(args);
+  Write(longText.data(), length);
+}
+
+void DumpFile::Flush(bool force)
+{
+  if (!m_pFile || (m_buffer.empty() && (!force || !m_pZip))) return;
+
+  if (!force && m_buffer.size() < DMDUTIL_DUMP_WRITER_FLUSH_SIZE &&
+      std::chrono::steady_clock::now() - m_bufferStart <
+          std::chrono::milliseconds(DMDUTIL_DUMP_WRITER_FLUSH_INTERVAL_MS))
+    return;
+
+  if (!m_pZip)
+  {
+    Submit(m_buffer, false);
+    return;
+  }
+
+  Deflate(false);
+  if (m_pZip->compressed.size() >= DMDUTIL_DUMP_WRITER_BUFFER_SIZE || (force && !m_pZip->compressed.empty()))
+    Submit(m_pZip->compressed, false);
+}
+
+void DumpFile::Deflate(bool finish)
+{
+  ZipEntry& zip = *m_pZip;
+  zip.crc = (uint32_t)mz_crc32(zip.crc, m_buffer.data(), m_buffer.size());
+  zip.size += m_buffer.size();
+  tdefl_compress_buffer(zip.pCompressor, m_buffer.data(), m_buffer.size(), finish ? TDEFL_FINISH : TDEFL_NO_FLUSH);
+  m_buffer.clear();
+}
+
+void DumpFile::Submit(std::vector<uint8_t>& buffer, bool close)
+{
+  DumpWriter::Request request;
+  request.pFile = m_pFile;
+  request.buffer = std::move(buffer);
+  request.close = close;
+  m_writer.Submit(std::move(request));
+
+  if (close)
+  {
+    m_pFile = nullptr;
+    buffer = std::vector<uint8_t>();
+  }
+  else
+  {
+    buffer = m_writer.AcquireBuffer();
+  }
+}
+
+}  // namespace DMDUtil
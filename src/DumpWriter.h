@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DMDUTIL_DUMP_WRITER_BUFFER_SIZE (256 * 1024)
+#define DMDUTIL_DUMP_WRITER_MAX_PENDING (64 * 1024 * 1024)
+// A partial buffer is only handed over once it holds this many bytes or its first byte waits this long.
+#define DMDUTIL_DUMP_WRITER_FLUSH_SIZE (64 * 1024)
+#define DMDUTIL_DUMP_WRITER_FLUSH_INTERVAL_MS 250
+
+namespace DMDUtil
+{
+
+class DumpFile;
+
+// The I/O thread shared by all dumpers of a DMD. Dumpers format into the memory buffer of their DumpFile, full
+// buffers are handed over and written with a single fwrite, so a slow disk doesn't hold back the dumpers. Only if
+// more than DMDUTIL_DUMP_WRITER_MAX_PENDING bytes are waiting, handing over a buffer blocks.
+class DumpWriter
+{
+ public:
+  DumpWriter();
+  // Writes everything pending and closes all files.
+  ~DumpWriter();
+
+  // Flush every write to the disk, for cabinets that are switched off without shutting down.
+  void SetSync(bool sync) { m_sync.store(sync, std::memory_order_relaxed); }
+  uint64_t GetBytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+  // Returns true once everything handed over so far is written.
+  bool WaitUntilWritten(std::chrono::steady_clock::time_point deadline);
+
+ private:
+  friend class DumpFile;
+
+  struct File
+  {
+    FILE* pFile = nullptr;
+    std::string path;
+    std::atomic<bool> failed{false};
+  };
+
+  struct Request
+  {
+    File* pFile = nullptr;
+    std::vector<uint8_t> buffer;
+    // Close and delete the file after writing the buffer.
+    bool close = false;
+  };
+
+  void Submit(Request&& request);
+  std::vector<uint8_t> AcquireBuffer();
+  void Run();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::condition_variable m_spaceCv;
+  std::deque<Request> m_queue;
+  std::vector<std::vector<uint8_t>> m_freeBuffers;
+  size_t m_pendingBytes = 0;
+  size_t m_pendingRequests = 0;
+  bool m_stop = false;
+  std::atomic<bool> m_sync{false};
+  std::atomic<uint64_t> m_bytesWritten{0};
+  std::thread m_thread;
+};
+
+// A dump file written by the DumpWriter. Must only be used by one thread.
+class DumpFile
+{
+ public:
+  explicit DumpFile(DumpWriter& writer);
+  ~DumpFile();
+
+  DumpFile(const DumpFile&) = delete;
+  DumpFile& operator=(const DumpFile&) = delete;
+
+  bool Open(const char* path, const char* mode);
+  // Writes a zip archive with a single entry. The data is deflated by the calling thread whenever a buffer is full,
+  // so there is no uncompressed copy on the disk.
+  bool OpenZip(const char* path, const char* entryName, int compressionLevel);
+  // Returns immediately, the I/O thread writes the rest and closes the file.
+  void Close();
+  bool IsOpen() const { return m_pFile != nullptr; }
+  // True once the I/O thread failed to write to the file.
+  bool HasFailed() const { return m_pFile && m_pFile->failed.load(std::memory_order_relaxed); }
+
+  void Write(const void* pData, size_t size);
+  void Printf(const char* format, ...);
+  // Hands the buffered data over to the I/O thread once DMDUTIL_DUMP_WRITER_FLUSH_SIZE or
+  // DMDUTIL_DUMP_WRITER_FLUSH_INTERVAL_MS is reached, so a dumper that catches up after every frame doesn't write
+  // every frame on its own. Zip entries are only handed over in full buffers. With force everything is handed over.
+  void Flush(bool force = false);
+
+ private:
+  struct ZipEntry;
+
+  bool OpenFile(const char* path, const char* mode);
+  void Deflate(bool finish);
+  void Submit(std::vector<uint8_t>& buffer, bool close);
+
+  DumpWriter& m_writer;
+  DumpWriter::File* m_pFile = nullptr;
+  std::vector<uint8_t> m_buffer;
+  // When the first byte of m_buffer was written.
+  std::chrono::steady_clock::time_point m_bufferStart;
+  std::unique_ptr<ZipEntry> m_pZip;
+};
+
+}  // namespace DMDUtil
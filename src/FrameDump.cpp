@@ -0,0 +1,510 @@
+#include "FrameDump.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "miniz/miniz.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+
+constexpr uint8_t kFileMagic[8] = {'D', 'M', 'D', 'D', 'U', 'M', 'P', 0};
+constexpr uint8_t kBlockMagic[4] = {'D', 'M', 'D', 'B'};
+constexpr uint8_t kIndexMagic[8] = {'D', 'M', 'D', 'I', 'N', 'D', 'E', 'X'};
+constexpr size_t kFileHeaderSize = 16;
+constexpr size_t kBlockHeaderSize = 20;
+constexpr size_t kIndexEntrySize = 16;
+constexpr size_t kFrameIndexEntrySize = 24;
+constexpr size_t kTrailerSize = 24;
+constexpr size_t kRecordHeaderSize = 28;
+constexpr size_t kFrameContextSize = 28;
+// Far more than a block of the largest frames.
+constexpr uint32_t kMaxBlockSize = 16 * 1024 * 1024;
+
+constexpr uint8_t kCompressionNone = 0;
+constexpr uint8_t kCompressionDeflate = 1;
+
+constexpr uint8_t kFlagHasData = 0x01;
+constexpr uint8_t kFlagHasSegData = 0x02;
+constexpr uint8_t kFlagHasSegData2 = 0x04;
+constexpr uint8_t kFlagHasFrameContext = 0x08;
+
+void Put16(std::vector<uint8_t>& buffer, uint16_t value)
+{
+  buffer.push_back((uint8_t)value);
+  buffer.push_back((uint8_t)(value >> 8));
+}
+
+void Put32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+  for (int i = 0; i < 4; i++) buffer.push_back((uint8_t)(value >> (i * 8)));
+}
+
+void Put64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+  for (int i = 0; i < 8; i++) buffer.push_back((uint8_t)(value >> (i * 8)));
+}
+
+uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+uint32_t Get32(const uint8_t* p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t Get64(const uint8_t* p) { return (uint64_t)Get32(p) | ((uint64_t)Get32(p + 4) << 32); }
+
+// Record headers and frame index entries start alike, only the payload sizes are at a different offset.
+void GetInfo(const uint8_t* p, const uint8_t* pSizes, FrameDumpInfo& info)
+{
+  info.timestampMs = Get32(p);
+  info.mode = (DMD::Mode)p[4];
+  info.depth = p[5];
+  const uint8_t flags = p[7];
+  info.hasData = flags & kFlagHasData;
+  info.hasSegData = flags & kFlagHasSegData;
+  info.hasSegData2 = flags & kFlagHasSegData2;
+  info.width = Get16(p + 8);
+  info.height = Get16(p + 10);
+  info.dataSize = Get32(pSizes);
+  info.segDataSize = Get32(pSizes + 4);
+  info.segData2Size = Get32(pSizes + 8);
+}
+
+bool Seek(FILE* pFile, uint64_t offset)
+{
+#ifdef _WIN32
+  return _fseeki64(pFile, (__int64)offset, SEEK_SET) == 0;
+#else
+  return fseeko(pFile, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+bool GetFileSize(FILE* pFile, uint64_t& size)
+{
+#ifdef _WIN32
+  if (_fseeki64(pFile, 0, SEEK_END) != 0) return false;
+  const __int64 end = _ftelli64(pFile);
+#else
+  if (fseeko(pFile, 0, SEEK_END) != 0) return false;
+  const off_t end = ftello(pFile);
+#endif
+  if (end < 0) return false;
+  size = (uint64_t)end;
+  return true;
+}
+
+bool ReadAt(FILE* pFile, uint64_t offset, uint8_t* pBuffer, size_t size)
+{
+  return Seek(pFile, offset) && fread(pBuffer, 1, size, pFile) == size;
+}
+
+}  // namespace
+
+bool FrameDumpWriter::Open(const char* path, bool compress, int compressionLevel)
+{
+  Close();
+
+  if (!m_file.Open(path, "wb")) return false;
+
+  m_compress = compress;
+  m_compressionLevel = std::clamp(compressionLevel, 0, 9);
+  m_frameCount = 0;
+  m_blockFrameCount = 0;
+  m_block.clear();
+  m_index.clear();
+  m_frameIndex.clear();
+
+  std::vector<uint8_t> header(kFileMagic, kFileMagic + sizeof(kFileMagic));
+  Put16(header, DMDUTIL_FRAME_DUMP_VERSION);
+  header.resize(kFileHeaderSize, 0);
+  m_file.Write(header.data(), header.size());
+  m_offset = header.size();
+
+  return true;
+}
+
+bool FrameDumpWriter::Write(const FrameDumpHeader& header, const uint8_t* pData, size_t dataSize,
+                            const uint16_t* pSegData, size_t segDataSize, const uint16_t* pSegData2,
+                            size_t segData2Size)
+{
+  if (!m_file.IsOpen() || m_file.HasFailed()) return false;
+
+  uint8_t flags = 0;
+  if (pData) flags |= kFlagHasData;
+  if (pSegData) flags |= kFlagHasSegData;
+  if (pSegData2) flags |= kFlagHasSegData2;
+  if (header.frameContext.valid) flags |= kFlagHasFrameContext;
+  if (!pData) dataSize = 0;
+  if (!pSegData) segDataSize = 0;
+  if (!pSegData2) segData2Size = 0;
+
+  Put32(m_frameIndex, header.timestampMs);
+  m_frameIndex.push_back((uint8_t)header.mode);
+  m_frameIndex.push_back(header.depth);
+  m_frameIndex.push_back(0);
+  m_frameIndex.push_back(flags);
+  Put16(m_frameIndex, header.width);
+  Put16(m_frameIndex, header.height);
+  Put32(m_frameIndex, (uint32_t)dataSize);
+  Put32(m_frameIndex, (uint32_t)segDataSize);
+  Put32(m_frameIndex, (uint32_t)segData2Size);
+
+  Put32(m_block, header.timestampMs);
+  m_block.push_back((uint8_t)header.mode);
+  m_block.push_back(header.depth);
+  m_block.push_back((uint8_t)header.layout);
+  m_block.push_back(flags);
+  Put16(m_block, header.width);
+  Put16(m_block, header.height);
+  m_block.push_back(header.r);
+  m_block.push_back(header.g);
+  m_block.push_back(header.b);
+  m_block.push_back(0);
+  Put32(m_block, (uint32_t)dataSize);
+  Put32(m_block, (uint32_t)segDataSize);
+  Put32(m_block, (uint32_t)segData2Size);
+
+  if (header.frameContext.valid)
+  {
+    Put64(m_block, header.frameContext.sourceOrdinal);
+    Put32(m_block, header.frameContext.sourceFrameIndex);
+    Put32(m_block, header.frameContext.originalFrameIndex);
+    Put32(m_block, header.frameContext.inputCrc32);
+    Put32(m_block, header.frameContext.inputTimestampMs);
+    Put32(m_block, header.frameContext.inputDurationMs);
+  }
+
+  m_block.insert(m_block.end(), pData, pData + dataSize);
+  for (size_t i = 0; i < segDataSize; i++) Put16(m_block, pSegData[i]);
+  for (size_t i = 0; i < segData2Size; i++) Put16(m_block, pSegData2[i]);
+
+  if (m_blockFrameCount == 0) m_blockStart = std::chrono::steady_clock::now();
+  m_frameCount++;
+  m_blockFrameCount++;
+
+  if (m_block.size() >= DMDUTIL_FRAME_DUMP_BLOCK_SIZE) return FlushBlock();
+  return true;
+}
+
+bool FrameDumpWriter::FlushBlock()
+{
+  if (m_blockFrameCount == 0) return true;
+
+  const uint8_t* pStored = m_block.data();
+  size_t storedSize = m_block.size();
+  uint8_t compression = kCompressionNone;
+  if (m_compress)
+  {
+    mz_ulong compressedSize = mz_compressBound((mz_ulong)m_block.size());
+    m_compressed.resize(compressedSize);
+    if (mz_compress2(m_compressed.data(), &compressedSize, m_block.data(), (mz_ulong)m_block.size(),
+                     m_compressionLevel) == MZ_OK &&
+        compressedSize < m_block.size())
+    {
+      pStored = m_compressed.data();
+      storedSize = compressedSize;
+      compression = kCompressionDeflate;
+    }
+  }
+
+  std::vector<uint8_t> header(kBlockMagic, kBlockMagic + sizeof(kBlockMagic));
+  Put32(header, m_blockFrameCount);
+  Put32(header, (uint32_t)m_block.size());
+  Put32(header, (uint32_t)storedSize);
+  header.push_back(compression);
+  header.resize(kBlockHeaderSize, 0);
+
+  m_file.Write(header.data(), header.size());
+  m_file.Write(pStored, storedSize);
+
+  m_index.push_back({m_offset, m_frameCount - m_blockFrameCount, m_blockFrameCount});
+  m_offset += header.size() + storedSize;
+  m_blockFrameCount = 0;
+  m_block.clear();
+  return !m_file.HasFailed();
+}
+
+bool FrameDumpWriter::Flush(bool force)
+{
+  if (!m_file.IsOpen()) return false;
+
+  bool ok = true;
+  if (force || (m_blockFrameCount > 0 && std::chrono::steady_clock::now() - m_blockStart >=
+                                             std::chrono::milliseconds(DMDUTIL_FRAME_DUMP_BLOCK_INTERVAL_MS)))
+    ok = FlushBlock();
+  m_file.Flush(true);
+  return ok;
+}
+
+bool FrameDumpWriter::Close()
+{
+  if (!m_file.IsOpen()) return false;
+
+  bool ok = FlushBlock();
+  if (ok)
+  {
+    std::vector<uint8_t> index;
+    for (const BlockIndex& block : m_index)
+    {
+      Put64(index, block.offset);
+      Put32(index, block.firstFrame);
+      Put32(index, block.frameCount);
+    }
+    index.insert(index.end(), m_frameIndex.begin(), m_frameIndex.end());
+    Put64(index, m_offset);
+    Put32(index, (uint32_t)m_index.size());
+    Put32(index, m_frameCount);
+    index.insert(index.end(), kIndexMagic, kIndexMagic + sizeof(kIndexMagic));
+    m_file.Write(index.data(), index.size());
+  }
+
+  // Write errors after this point are logged by the DumpWriter.
+  m_file.Close();
+  m_block.clear();
+  m_index.clear();
+  m_frameIndex.clear();
+  return ok;
+}
+
+bool FrameDumpReader::IsFrameDump(const uint8_t* pData, size_t size)
+{
+  return size >= sizeof(kFileMagic) && memcmp(pData, kFileMagic, sizeof(kFileMagic)) == 0;
+}
+
+bool FrameDumpReader::Open(const char* path)
+{
+  Close();
+
+  m_pFile = fopen(path, "rb");
+  if (!m_pFile) return false;
+
+  uint8_t header[kFileHeaderSize];
+  uint64_t fileSize = 0;
+  if (ReadAt(m_pFile, 0, header, sizeof(header)) && IsFrameDump(header, sizeof(header)))
+    m_version = Get16(header + 8);
+  if (m_version == 0 || m_version > DMDUTIL_FRAME_DUMP_VERSION || !GetFileSize(m_pFile, fileSize) ||
+      !(ReadIndex(fileSize) || ScanBlocks(fileSize)))
+  {
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+void FrameDumpReader::Close()
+{
+  if (m_pFile) fclose(m_pFile);
+  m_pFile = nullptr;
+  m_version = 0;
+  m_frameCount = 0;
+  m_index.clear();
+  m_frameInfos.clear();
+  m_block = SIZE_MAX;
+  m_blockData.clear();
+  m_frameOffsets.clear();
+}
+
+bool FrameDumpReader::ReadIndex(uint64_t fileSize)
+{
+  uint8_t trailer[kTrailerSize];
+  if (fileSize < kFileHeaderSize + kTrailerSize ||
+      !ReadAt(m_pFile, fileSize - kTrailerSize, trailer, sizeof(trailer)) ||
+      memcmp(trailer + 16, kIndexMagic, sizeof(kIndexMagic)) != 0)
+    return false;
+
+  const uint64_t indexOffset = Get64(trailer);
+  const uint32_t blockCount = Get32(trailer + 8);
+  const uint32_t frameCount = Get32(trailer + 12);
+  const uint64_t frameIndexSize = m_version >= 2 ? (uint64_t)frameCount * kFrameIndexEntrySize : 0;
+  if (indexOffset < kFileHeaderSize ||
+      indexOffset + (uint64_t)blockCount * kIndexEntrySize + frameIndexSize + kTrailerSize != fileSize)
+    return false;
+
+  std::vector<uint8_t> index((size_t)blockCount * kIndexEntrySize + (size_t)frameIndexSize);
+  if (!index.empty() && !ReadAt(m_pFile, indexOffset, index.data(), index.size())) return false;
+
+  uint32_t expectedFirstFrame = 0;
+  m_index.clear();
+  for (uint32_t i = 0; i < blockCount; i++)
+  {
+    const uint8_t* pEntry = &index[(size_t)i * kIndexEntrySize];
+    BlockIndex block = {Get64(pEntry), Get32(pEntry + 8), Get32(pEntry + 12)};
+    if (block.firstFrame != expectedFirstFrame || block.offset >= indexOffset) return false;
+    expectedFirstFrame += block.frameCount;
+    m_index.push_back(block);
+  }
+  if (expectedFirstFrame != frameCount) return false;
+
+  m_frameInfos.resize(frameIndexSize > 0 ? frameCount : 0);
+  const uint8_t* pFrameIndex = index.data() + (size_t)blockCount * kIndexEntrySize;
+  for (FrameDumpInfo& info : m_frameInfos)
+  {
+    GetInfo(pFrameIndex, pFrameIndex + 12, info);
+    pFrameIndex += kFrameIndexEntrySize;
+  }
+
+  m_frameCount = frameCount;
+  return true;
+}
+
+bool FrameDumpReader::ScanBlocks(uint64_t fileSize)
+{
+  m_index.clear();
+  m_frameInfos.clear();
+  m_frameCount = 0;
+
+  uint64_t offset = kFileHeaderSize;
+  uint8_t header[kBlockHeaderSize];
+  while (offset + kBlockHeaderSize <= fileSize && ReadAt(m_pFile, offset, header, sizeof(header)))
+  {
+    // Stops at the index or at a block that wasn't completely written.
+    const uint32_t frameCount = Get32(header + 4);
+    const uint32_t storedSize = Get32(header + 12);
+    if (memcmp(header, kBlockMagic, sizeof(kBlockMagic)) != 0 || frameCount == 0 || storedSize > kMaxBlockSize ||
+        offset + kBlockHeaderSize + storedSize > fileSize)
+      break;
+
+    m_index.push_back({offset, m_frameCount, frameCount});
+    m_frameCount += frameCount;
+    offset += kBlockHeaderSize + storedSize;
+  }
+
+  return true;
+}
+
+bool FrameDumpReader::LoadBlock(size_t block)
+{
+  if (m_block == block) return true;
+
+  m_block = SIZE_MAX;
+  m_frameOffsets.clear();
+
+  uint8_t header[kBlockHeaderSize];
+  if (!ReadAt(m_pFile, m_index[block].offset, header, sizeof(header))) return false;
+
+  const uint32_t frameCount = Get32(header + 4);
+  const uint32_t rawSize = Get32(header + 8);
+  const uint32_t storedSize = Get32(header + 12);
+  const uint8_t compression = header[16];
+  if (memcmp(header, kBlockMagic, sizeof(kBlockMagic)) != 0 || frameCount != m_index[block].frameCount ||
+      rawSize > kMaxBlockSize || storedSize > kMaxBlockSize)
+    return false;
+
+  std::vector<uint8_t> stored(storedSize);
+  if (!ReadAt(m_pFile, m_index[block].offset + kBlockHeaderSize, stored.data(), stored.size())) return false;
+
+  if (compression == kCompressionDeflate)
+  {
+    m_blockData.resize(rawSize);
+    mz_ulong size = rawSize;
+    if (mz_uncompress(m_blockData.data(), &size, stored.data(), storedSize) != MZ_OK || size != rawSize) return false;
+  }
+  else if (compression == kCompressionNone && storedSize == rawSize)
+  {
+    m_blockData = std::move(stored);
+  }
+  else
+  {
+    return false;
+  }
+
+  // Locate all records once, so reading a block frame by frame stays linear.
+  size_t offset = 0;
+  for (uint32_t i = 0; i < frameCount; i++)
+  {
+    if (offset + kRecordHeaderSize > m_blockData.size()) return false;
+
+    const uint8_t* pRecord = &m_blockData[offset];
+    size_t recordSize = kRecordHeaderSize + (size_t)Get32(pRecord + 16) + (size_t)Get32(pRecord + 20) * 2 +
+                        (size_t)Get32(pRecord + 24) * 2;
+    if (pRecord[7] & kFlagHasFrameContext) recordSize += kFrameContextSize;
+    if (offset + recordSize > m_blockData.size()) return false;
+
+    m_frameOffsets.push_back(offset);
+    offset += recordSize;
+  }
+
+  m_block = block;
+  return true;
+}
+
+const uint8_t* FrameDumpReader::GetRecord(uint32_t index)
+{
+  if (!m_pFile || index >= m_frameCount) return nullptr;
+
+  const auto it = std::upper_bound(m_index.begin(), m_index.end(), index,
+                                   [](uint32_t value, const BlockIndex& block) { return value < block.firstFrame; });
+  const size_t block = (size_t)(it - m_index.begin()) - 1;
+  if (!LoadBlock(block)) return nullptr;
+
+  return &m_blockData[m_frameOffsets[index - m_index[block].firstFrame]];
+}
+
+bool FrameDumpReader::ReadInfo(uint32_t index, FrameDumpInfo& info)
+{
+  if (!m_frameInfos.empty())
+  {
+    if (!m_pFile || index >= m_frameCount) return false;
+    info = m_frameInfos[index];
+    return true;
+  }
+
+  const uint8_t* p = GetRecord(index);
+  if (!p) return false;
+  GetInfo(p, p + 16, info);
+  return true;
+}
+
+bool FrameDumpReader::Read(uint32_t index, FrameDumpFrame& frame)
+{
+  const uint8_t* p = GetRecord(index);
+  if (!p) return false;
+
+  FrameDumpHeader& header = frame.header;
+  header.timestampMs = Get32(p);
+  header.mode = (DMD::Mode)p[4];
+  header.depth = p[5];
+  header.layout = (AlphaNumericLayout)p[6];
+  const uint8_t flags = p[7];
+  header.width = Get16(p + 8);
+  header.height = Get16(p + 10);
+  header.r = p[12];
+  header.g = p[13];
+  header.b = p[14];
+  const uint32_t dataSize = Get32(p + 16);
+  const uint32_t segDataSize = Get32(p + 20);
+  const uint32_t segData2Size = Get32(p + 24);
+  p += kRecordHeaderSize;
+
+  header.frameContext = DMD::FrameContext();
+  if (flags & kFlagHasFrameContext)
+  {
+    header.frameContext.valid = true;
+    header.frameContext.sourceOrdinal = Get64(p);
+    header.frameContext.sourceFrameIndex = Get32(p + 8);
+    header.frameContext.originalFrameIndex = Get32(p + 12);
+    header.frameContext.inputCrc32 = Get32(p + 16);
+    header.frameContext.inputTimestampMs = Get32(p + 20);
+    header.frameContext.inputDurationMs = Get32(p + 24);
+    p += kFrameContextSize;
+  }
+
+  frame.hasData = flags & kFlagHasData;
+  frame.hasSegData = flags & kFlagHasSegData;
+  frame.hasSegData2 = flags & kFlagHasSegData2;
+  frame.data.assign(p, p + dataSize);
+  p += dataSize;
+  frame.segData.resize(segDataSize);
+  for (uint32_t i = 0; i < segDataSize; i++, p += 2) frame.segData[i] = Get16(p);
+  frame.segData2.resize(segData2Size);
+  for (uint32_t i = 0; i < segData2Size; i++, p += 2) frame.segData2[i] = Get16(p);
+
+  return true;
+}
+
+}  // namespace DMDUtil
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DMDUtil/DMD.h"
+#include "DumpWriter.h"
+
+#define DMDUTIL_FRAME_DUMP_VERSION 2
+#define DMDUTIL_FRAME_DUMP_BLOCK_SIZE (256 * 1024)
+// A block that isn't full is closed by Flush() once its first frame is this old.
+#define DMDUTIL_FRAME_DUMP_BLOCK_INTERVAL_MS 1000
+
+namespace DMDUtil
+{
+
+// Binary frame dump, the lossless counterpart of the text dumps.
+//
+// All values are little-endian. The file starts with the magic "DMDDUMP\0", a 16-bit version and 6 reserved bytes,
+// followed by blocks of frames. Each block has a header (magic "DMDB", frame count, raw size, stored size,
+// compression) and holds the frame records, deflated if that makes the block smaller. Closing the writer appends an
+// index of all blocks and a trailer pointing at it, so frames can be read in any order. Since version 2 the index also
+// holds the timestamp, mode, size and payload sizes of every frame, so a player can list the frames without
+// inflating a single block. A dump that wasn't closed is read by scanning its blocks.
+//
+// Each frame record has a fixed header followed by the payload. Only the payload parts the frame has are stored, and
+// only as many bytes as its mode uses.
+struct FrameDumpHeader
+{
+  uint32_t timestampMs = 0;
+  DMD::Mode mode = DMD::Mode::Unknown;
+  AlphaNumericLayout layout = AlphaNumericLayout::NoLayout;
+  uint8_t depth = 0;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint8_t r = 255;
+  uint8_t g = 255;
+  uint8_t b = 255;
+  DMD::FrameContext frameContext;
+};
+
+// A frame without its payload.
+struct FrameDumpInfo
+{
+  uint32_t timestampMs = 0;
+  DMD::Mode mode = DMD::Mode::Unknown;
+  uint8_t depth = 0;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  bool hasData = false;
+  bool hasSegData = false;
+  bool hasSegData2 = false;
+  uint32_t dataSize = 0;
+  uint32_t segDataSize = 0;
+  uint32_t segData2Size = 0;
+};
+
+struct FrameDumpFrame
+{
+  FrameDumpHeader header;
+  bool hasData = false;
+  bool hasSegData = false;
+  bool hasSegData2 = false;
+  std::vector<uint8_t> data;
+  std::vector<uint16_t> segData;
+  std::vector<uint16_t> segData2;
+};
+
+// Writes through the DumpWriter, so the frames are written by its I/O thread.
+class FrameDumpWriter
+{
+ public:
+  explicit FrameDumpWriter(DumpWriter& writer) : m_file(writer) {}
+  ~FrameDumpWriter() { Close(); }
+
+  bool Open(const char* path, bool compress, int compressionLevel = 6);
+  // Payload parts that are nullptr are not stored.
+  bool Write(const FrameDumpHeader& header, const uint8_t* pData, size_t dataSize, const uint16_t* pSegData,
+             size_t segDataSize, const uint16_t* pSegData2, size_t segData2Size);
+  // Hands the closed blocks over to the I/O thread. The pending block is only closed once it reaches
+  // DMDUTIL_FRAME_DUMP_BLOCK_INTERVAL_MS, so it still collects the frames of a slow stream, or with force.
+  bool Flush(bool force = false);
+  // Writes the pending block and the index.
+  bool Close();
+  bool IsOpen() const { return m_file.IsOpen(); }
+
+ private:
+  struct BlockIndex
+  {
+    uint64_t offset;
+    uint32_t firstFrame;
+    uint32_t frameCount;
+  };
+
+  bool FlushBlock();
+
+  DumpFile m_file;
+  bool m_compress = false;
+  int m_compressionLevel = 6;
+  uint64_t m_offset = 0;
+  uint32_t m_frameCount = 0;
+  uint32_t m_blockFrameCount = 0;
+  std::chrono::steady_clock::time_point m_blockStart;
+  std::vector<uint8_t> m_block;
+  std::vector<uint8_t> m_compressed;
+  std::vector<BlockIndex> m_index;
+  std::vector<uint8_t> m_frameIndex;
+};
+
+class FrameDumpReader
+{
+ public:
+  FrameDumpReader() {}
+  ~FrameDumpReader() { Close(); }
+
+  // Returns true if the file starts with the frame dump magic.
+  static bool IsFrameDump(const uint8_t* pData, size_t size);
+
+  bool Open(const char* path);
+  void Close();
+  uint32_t GetFrameCount() const { return m_frameCount; }
+  bool Read(uint32_t index, FrameDumpFrame& frame);
+  // Comes from the index if the dump has one with frame infos, otherwise the block of the frame is inflated.
+  bool ReadInfo(uint32_t index, FrameDumpInfo& info);
+
+ private:
+  struct BlockIndex
+  {
+    uint64_t offset;
+    uint32_t firstFrame;
+    uint32_t frameCount;
+  };
+
+  bool ReadIndex(uint64_t fileSize);
+  bool ScanBlocks(uint64_t fileSize);
+  bool LoadBlock(size_t block);
+  const uint8_t* GetRecord(uint32_t index);
+
+  FILE* m_pFile = nullptr;
+  uint16_t m_version = 0;
+  uint32_t m_frameCount = 0;
+  std::vector<BlockIndex> m_index;
+  // Empty if the index has no frame infos.
+  std::vector<FrameDumpInfo> m_frameInfos;
+  // The last decoded block and where its frames start.
+  size_t m_block = SIZE_MAX;
+  std::vector<uint8_t> m_blockData;
+  std::vector<size_t> m_frameOffsets;
+};
+
+}  // namespace DMDUtil
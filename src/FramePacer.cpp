@@ -0,0 +1,112 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "DMDUtil/Logger.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+// Re-anchor if a frame is that late or far ahead, for example after a pause or if a new stream started.
+constexpr int64_t kMaxLateMs = 250;
+constexpr int64_t kMaxAheadMs = 1000;
+constexpr int64_t kMaxSleepMs = 10;
+// Frames queued for a device should be rendered within that time, slower devices skip earlier.
+constexpr uint32_t kTargetLatencyUs = 100000;
+}  // namespace
+
+FramePacer::~FramePacer()
+{
+  if (m_presented > 0 || m_dropped > 0)
+    Log(DMDUtil_LogLevel_INFO, "%s: Paced %llu frames, dropped %llu, average jitter %llu us, max jitter %llu us",
+        m_name, (unsigned long long)m_presented, (unsigned long long)m_dropped,
+        (unsigned long long)(m_presented > 0 ? m_jitterSumUs / m_presented : 0), (unsigned long long)m_jitterMaxUs);
+
+  if (m_renderTimeUsX8 > 0)
+    Log(DMDUtil_LogLevel_INFO,
+        "%s: Average render time %u us (%u fps sustainable), max frames behind %u, skipped %llu frames, %llu of them "
+        "near-duplicates",
+        m_name, GetRenderTimeUs(), 1000000 / GetRenderTimeUs(), GetMaxFramesBehind(), (unsigned long long)m_skipped,
+        (unsigned long long)m_skippedNearDuplicates);
+}
+
+uint16_t FramePacer::GetMaxFramesBehind() const
+{
+  if (m_renderTimeUsX8 == 0) return DMDUTIL_MAX_FRAMES_BEHIND;
+
+  const uint32_t frames = kTargetLatencyUs * 8 / m_renderTimeUsX8;
+  return (uint16_t)std::clamp<uint32_t>(frames, DMDUTIL_MIN_FRAMES_BEHIND * 2, DMDUTIL_MAX_FRAMES_BEHIND);
+}
+
+void FramePacer::AddSkippedFrames(uint16_t frames, bool nearDuplicate)
+{
+  m_skipped += frames;
+  if (nearDuplicate) m_skippedNearDuplicates += frames;
+}
+
+void FramePacer::AddRenderTime(std::chrono::steady_clock::duration renderTime)
+{
+  const int64_t renderTimeUs = std::clamp<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(renderTime).count(), 1, kTargetLatencyUs);
+  // avg += (sample - avg) / 8, with avg scaled by 8.
+  if (m_renderTimeUsX8 == 0)
+    m_renderTimeUsX8 = (uint32_t)renderTimeUs * 8;
+  else
+    m_renderTimeUsX8 = m_renderTimeUsX8 - m_renderTimeUsX8 / 8 + (uint32_t)renderTimeUs;
+}
+
+std::chrono::steady_clock::time_point FramePacer::GetDeadline(uint32_t timestampMs) const
+{
+  return m_anchorTime + std::chrono::milliseconds((int32_t)(timestampMs - m_anchorTimestampMs));
+}
+
+bool FramePacer::Schedule(bool hasTimestamp, uint32_t timestampMs, bool hasNextTimestamp, uint32_t nextTimestampMs)
+{
+  m_hasDeadline = false;
+  if (!hasTimestamp) return true;
+
+  const auto now = std::chrono::steady_clock::now();
+  auto deadline = GetDeadline(timestampMs);
+  if (!m_anchored || timestampMs < m_lastTimestampMs || deadline < now - std::chrono::milliseconds(kMaxLateMs) ||
+      deadline > now + std::chrono::milliseconds(kMaxAheadMs))
+  {
+    m_anchored = true;
+    m_anchorTimestampMs = timestampMs;
+    m_anchorTime = now;
+    deadline = now;
+  }
+  m_lastTimestampMs = timestampMs;
+
+  if (hasNextTimestamp && nextTimestampMs >= timestampMs && GetDeadline(nextTimestampMs) <= now)
+  {
+    m_dropped++;
+    return false;
+  }
+
+  m_deadline = deadline;
+  m_hasDeadline = true;
+  return true;
+}
+
+void FramePacer::WaitForDeadline(const std::atomic<bool>& stopFlag)
+{
+  if (!m_hasDeadline) return;
+
+  auto now = std::chrono::steady_clock::now();
+  while (now < m_deadline && !stopFlag.load(std::memory_order_relaxed))
+  {
+    std::this_thread::sleep_until(std::min(m_deadline, now + std::chrono::milliseconds(kMaxSleepMs)));
+    now = std::chrono::steady_clock::now();
+  }
+
+  const uint64_t jitterUs =
+      now > m_deadline ? (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - m_deadline).count() : 0;
+  m_jitterSumUs += jitterUs;
+  if (jitterUs > m_jitterMaxUs) m_jitterMaxUs = jitterUs;
+  m_presented++;
+}
+
+}  // namespace DMDUtil
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "DMDUtil/DMD.h"
+
+namespace DMDUtil
+{
+
+// Presents timestamped frames of one device at their intended time. The first timestamp is mapped to the local
+// clock, later frames get a deadline relative to it. Frames without timestamp are presented immediately.
+// It also measures how long the device needs to render a frame to decide how far it may fall behind the queue.
+class FramePacer
+{
+ public:
+  // Measures the render time from construction until the end of the enclosing scope. Create it right before the device
+  // call, so frames which are skipped without rendering don't count.
+  class RenderScope
+  {
+   public:
+    explicit RenderScope(FramePacer& pacer) : m_pacer(pacer), m_start(std::chrono::steady_clock::now()) {}
+    ~RenderScope() { m_pacer.AddRenderTime(std::chrono::steady_clock::now() - m_start); }
+
+   private:
+    FramePacer& m_pacer;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  explicit FramePacer(const char* name) : m_name(name) {}
+  ~FramePacer();
+
+  // Returns false if the frame should be dropped because the following frame is due already.
+  bool Schedule(bool hasTimestamp, uint32_t timestampMs, bool hasNextTimestamp, uint32_t nextTimestampMs);
+  void WaitForDeadline(const std::atomic<bool>& stopFlag);
+
+  // Number of queued frames the device could render within the latency target, based on its measured render time.
+  uint16_t GetMaxFramesBehind() const;
+  void AddSkippedFrames(uint16_t frames, bool nearDuplicate);
+
+ private:
+  std::chrono::steady_clock::time_point GetDeadline(uint32_t timestampMs) const;
+  void AddRenderTime(std::chrono::steady_clock::duration renderTime);
+  uint32_t GetRenderTimeUs() const { return (m_renderTimeUsX8 + 4) / 8; }
+
+  const char* m_name;
+  bool m_anchored = false;
+  uint32_t m_anchorTimestampMs = 0;
+  uint32_t m_lastTimestampMs = 0;
+  std::chrono::steady_clock::time_point m_anchorTime;
+  std::chrono::steady_clock::time_point m_deadline;
+  bool m_hasDeadline = false;
+
+  uint64_t m_presented = 0;
+  uint64_t m_dropped = 0;
+  uint64_t m_jitterSumUs = 0;
+  uint64_t m_jitterMaxUs = 0;
+
+  // Exponential moving average of the render time, scaled by 8 to keep the fraction. 0 until the first frame got
+  // rendered.
+  uint32_t m_renderTimeUsX8 = 0;
+  uint64_t m_skipped = 0;
+  uint64_t m_skippedNearDuplicates = 0;
+};
+
+}  // namespace DMDUtil
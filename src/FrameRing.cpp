@@ -0,0 +1,220 @@
+#include "FrameRing.h"
+
+#include <chrono>
+#include <thread>
+
+#include "DMDUtil/Logger.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+constexpr uint32_t kSlotWriter = 0x80000000;
+}  // namespace
+
+FrameRing::Subscription::Subscription(FrameRing& ring, Interest interest, bool signalable) : m_ring(ring)
+{
+  for (Consumer& consumer : m_ring.m_consumers)
+  {
+    bool inUse = false;
+    if (consumer.inUse.compare_exchange_strong(inUse, true, std::memory_order_acq_rel))
+    {
+      std::lock_guard<std::mutex> lock(consumer.mutex);
+      consumer.sleeping.store(false, std::memory_order_relaxed);
+      consumer.signaled = false;
+      consumer.signalable = signalable;
+      consumer.interest = std::move(interest);
+      m_pConsumer = &consumer;
+      return;
+    }
+  }
+
+  Log(DMDUtil_LogLevel_ERROR, "FrameRing: More than %d consumers, falling back to polling",
+      DMDUTIL_FRAME_RING_MAX_CONSUMERS);
+}
+
+FrameRing::Subscription::~Subscription()
+{
+  if (!m_pConsumer) return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_pConsumer->mutex);
+    m_pConsumer->sleeping.store(false, std::memory_order_relaxed);
+    m_pConsumer->signalable = false;
+    m_pConsumer->interest = nullptr;
+  }
+  m_pConsumer->inUse.store(false, std::memory_order_release);
+}
+
+void FrameRing::Subscription::Wait(uint16_t& position, const std::atomic<bool>& stopFlag)
+{
+  if (!m_pConsumer)
+  {
+    while (!stopFlag.load(std::memory_order_relaxed) && m_ring.GetPosition() == position)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return;
+  }
+
+  Consumer& consumer = *m_pConsumer;
+  std::unique_lock<std::mutex> lock(consumer.mutex);
+  consumer.position = position;
+  consumer.sleeping.store(true, std::memory_order_relaxed);
+  // Pairs with the fence in Publish(): either the publisher sees the consumer sleeping or the consumer sees the new
+  // position.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  consumer.cv.wait(lock,
+                   [&]()
+                   {
+                     return stopFlag.load(std::memory_order_relaxed) || consumer.signaled ||
+                            m_ring.GetPosition() != consumer.position;
+                   });
+  position = consumer.position;
+  consumer.signaled = false;
+  consumer.sleeping.store(false, std::memory_order_relaxed);
+}
+
+FrameRing::FrameRing(const std::shared_ptr<FrameSlot>& emptyFrame)
+{
+  for (Slot& slot : m_slots) slot.frame = emptyFrame;
+}
+
+uint16_t FrameRing::Publish(const std::shared_ptr<FrameSlot>& frame, bool hasTimestamp, uint32_t timestampMs,
+                            const DMD::FrameContext& frameContext)
+{
+  const uint16_t position = m_position.load(std::memory_order_relaxed) + 1;  // 65535 + 1 = 0
+  Slot& slot = m_slots[position % DMDUTIL_FRAME_BUFFER_SIZE];
+
+  // Only this thread replaces frames, so the last one can be read without locking its slot.
+  const uint64_t changedRows =
+      frame->GetChangedRows(*m_slots[(uint16_t)(position - 1) % DMDUTIL_FRAME_BUFFER_SIZE].frame);
+
+  // Release the previous frame outside of the slot lock, it returns to the pool.
+  std::shared_ptr<FrameSlot> previousFrame;
+  Lock(slot);
+  previousFrame = std::move(slot.frame);
+  slot.frame = frame;
+  slot.hasTimestamp = hasTimestamp;
+  slot.timestampMs = timestampMs;
+  slot.frameContext = frameContext;
+  slot.changedRows = changedRows;
+  Unlock(slot);
+
+  m_position.store(position, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  for (Consumer& consumer : m_consumers)
+  {
+    if (!consumer.inUse.load(std::memory_order_relaxed) || !consumer.sleeping.load(std::memory_order_relaxed))
+      continue;
+
+    std::lock_guard<std::mutex> lock(consumer.mutex);
+    if (!consumer.sleeping.load(std::memory_order_relaxed) || consumer.signaled) continue;
+
+    if (consumer.interest && !consumer.interest(*frame))
+    {
+      // The consumer has seen everything before, so it can skip this frame as well.
+      consumer.position = position;
+      continue;
+    }
+
+    consumer.signaled = true;
+    consumer.cv.notify_one();
+  }
+
+  return position;
+}
+
+std::shared_ptr<FrameSlot> FrameRing::GetFrame(uint8_t bufferPositionMod) const
+{
+  const Slot& slot = m_slots[bufferPositionMod];
+  LockShared(slot);
+  std::shared_ptr<FrameSlot> frame = slot.frame;
+  UnlockShared(slot);
+  return frame;
+}
+
+bool FrameRing::GetTimestamp(uint8_t bufferPositionMod, uint32_t& timestampMs) const
+{
+  const Slot& slot = m_slots[bufferPositionMod];
+  LockShared(slot);
+  const bool hasTimestamp = slot.hasTimestamp;
+  timestampMs = slot.timestampMs;
+  UnlockShared(slot);
+  return hasTimestamp;
+}
+
+bool FrameRing::GetFrameContext(uint8_t bufferPositionMod, DMD::FrameContext& frameContext) const
+{
+  const Slot& slot = m_slots[bufferPositionMod];
+  LockShared(slot);
+  frameContext = slot.frameContext;
+  UnlockShared(slot);
+  return frameContext.valid;
+}
+
+uint64_t FrameRing::GetChangedRows(uint8_t bufferPositionMod) const
+{
+  const Slot& slot = m_slots[bufferPositionMod];
+  LockShared(slot);
+  const uint64_t changedRows = slot.changedRows;
+  UnlockShared(slot);
+  return changedRows;
+}
+
+void FrameRing::WakeAll()
+{
+  for (Consumer& consumer : m_consumers)
+  {
+    if (!consumer.inUse.load(std::memory_order_acquire)) continue;
+
+    std::lock_guard<std::mutex> lock(consumer.mutex);
+    consumer.cv.notify_all();
+  }
+}
+
+void FrameRing::Signal()
+{
+  for (Consumer& consumer : m_consumers)
+  {
+    if (!consumer.inUse.load(std::memory_order_acquire)) continue;
+
+    std::lock_guard<std::mutex> lock(consumer.mutex);
+    if (!consumer.signalable) continue;
+    consumer.signaled = true;
+    consumer.cv.notify_one();
+  }
+}
+
+void FrameRing::LockShared(const Slot& slot)
+{
+  while (true)
+  {
+    if ((slot.state.fetch_add(1, std::memory_order_acquire) & kSlotWriter) == 0) return;
+
+    slot.state.fetch_sub(1, std::memory_order_relaxed);
+    while (slot.state.load(std::memory_order_relaxed) & kSlotWriter) std::this_thread::yield();
+  }
+}
+
+void FrameRing::UnlockShared(const Slot& slot) { slot.state.fetch_sub(1, std::memory_order_release); }
+
+void FrameRing::Lock(Slot& slot)
+{
+  slot.state.fetch_or(kSlotWriter, std::memory_order_acquire);
+  while ((slot.state.load(std::memory_order_acquire) & ~kSlotWriter) != 0) std::this_thread::yield();
+}
+
+void FrameRing::Unlock(Slot& slot) { slot.state.fetch_and(~kSlotWriter, std::memory_order_release); }
+
+uint64_t FrameChangeTracker::Track(uint16_t bufferPosition)
+{
+  const bool previousProcessed = m_valid && bufferPosition == (uint16_t)(m_lastPosition + 1);
+  m_valid = true;
+  m_lastPosition = bufferPosition;
+  if (!previousProcessed) return FrameSlot::kAllRowsChanged;
+
+  return m_ring.GetChangedRows(bufferPosition % DMDUTIL_FRAME_BUFFER_SIZE);
+}
+
+}  // namespace DMDUtil
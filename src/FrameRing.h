@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "DMDUtil/DMD.h"
+#include "FrameSlotPool.h"
+
+#define DMDUTIL_FRAME_RING_MAX_CONSUMERS 32
+
+namespace DMDUtil
+{
+
+// The last DMDUTIL_FRAME_BUFFER_SIZE published frames. Only the ingest thread publishes, each consumer thread follows
+// with its own position. There is no lock shared by the writer and the readers, a slot is only guarded while its frame
+// pointer gets copied or replaced. Consumers sleep on their own condition variable and are only woken for frames they
+// are interested in.
+class FrameRing
+{
+ private:
+  struct Consumer;
+
+ public:
+  typedef std::function<bool(const FrameSlot& frame)> Interest;
+
+  class Subscription
+  {
+   public:
+    // Without an interest the consumer is woken for every frame. The interest is called by the publishing thread. A
+    // signalable consumer is also woken by Signal().
+    explicit Subscription(FrameRing& ring, Interest interest = nullptr, bool signalable = false);
+    ~Subscription();
+
+    // Returns as soon as frames after position are available. Frames published while the consumer was sleeping that
+    // it isn't interested in are skipped by advancing position.
+    void Wait(uint16_t& position, const std::atomic<bool>& stopFlag);
+
+   private:
+    FrameRing& m_ring;
+    Consumer* m_pConsumer = nullptr;
+  };
+
+  explicit FrameRing(const std::shared_ptr<FrameSlot>& emptyFrame);
+
+  // Must only be called by one thread.
+  uint16_t Publish(const std::shared_ptr<FrameSlot>& frame, bool hasTimestamp, uint32_t timestampMs,
+                   const DMD::FrameContext& frameContext);
+  uint16_t GetPosition() const { return m_position.load(std::memory_order_acquire); }
+  std::shared_ptr<FrameSlot> GetFrame(uint8_t bufferPositionMod) const;
+  bool GetTimestamp(uint8_t bufferPositionMod, uint32_t& timestampMs) const;
+  bool GetFrameContext(uint8_t bufferPositionMod, DMD::FrameContext& frameContext) const;
+  // Rows that differ from the frame published before, see FrameSlot::GetChangedRows().
+  uint64_t GetChangedRows(uint8_t bufferPositionMod) const;
+  // Wakes all consumers, for example to let them check their stop flag.
+  void WakeAll();
+  // Lets Wait() of the signalable consumers return once without a new frame.
+  void Signal();
+
+ private:
+  struct Slot
+  {
+    // Writer bit and number of readers.
+    mutable std::atomic<uint32_t> state{0};
+    std::shared_ptr<FrameSlot> frame;
+    bool hasTimestamp = false;
+    uint32_t timestampMs = 0;
+    DMD::FrameContext frameContext;
+    uint64_t changedRows = FrameSlot::kAllRowsChanged;
+  };
+
+  struct Consumer
+  {
+    std::atomic<bool> inUse{false};
+    std::atomic<bool> sleeping{false};
+    // Guarded by mutex.
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool signaled = false;
+    bool signalable = false;
+    uint16_t position = 0;
+    Interest interest;
+  };
+
+  static void LockShared(const Slot& slot);
+  static void UnlockShared(const Slot& slot);
+  static void Lock(Slot& slot);
+  static void Unlock(Slot& slot);
+
+  Slot m_slots[DMDUTIL_FRAME_BUFFER_SIZE];
+  Consumer m_consumers[DMDUTIL_FRAME_RING_MAX_CONSUMERS];
+  alignas(64) std::atomic<uint16_t> m_position{0};
+};
+
+// Remembers the last frame an output thread processed. The changed rows of a frame are only meaningful for a thread
+// that processed the frame published right before it.
+class FrameChangeTracker
+{
+ public:
+  explicit FrameChangeTracker(const FrameRing& ring) : m_ring(ring) {}
+
+  // Must be called for every frame the thread processes. Returns the rows that differ from the last processed frame,
+  // 0 if the frame is the same.
+  uint64_t Track(uint16_t bufferPosition);
+  void Reset() { m_valid = false; }
+
+ private:
+  const FrameRing& m_ring;
+  bool m_valid = false;
+  uint16_t m_lastPosition = 0;
+};
+
+}  // namespace DMDUtil
@@ -0,0 +1,275 @@
+#include "FrameSlotPool.h"
+
+#include <cstring>
+
+#include "komihash/komihash.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+constexpr size_t kMinSlotBytes = 1024;
+
+size_t AlignPayloadOffset(size_t offset) { return (offset + 15) & ~(size_t)15; }
+
+template <typename T>
+size_t CountDifferences(const T* a, const T* b, size_t size, size_t maxDifferences)
+{
+  size_t differences = 0;
+  for (size_t i = 0; i < size && differences <= maxDifferences; i++)
+  {
+    if (a[i] != b[i]) differences++;
+  }
+  return differences;
+}
+
+// Compares rows of equal size. Payloads that aren't made of rows are compared as a whole.
+uint64_t CompareRows(const void* a, const void* b, size_t bytes, uint16_t rows)
+{
+  if (rows == 0 || rows > 64 || bytes % rows != 0)
+    return memcmp(a, b, bytes) != 0 ? FrameSlot::kAllRowsChanged : 0;
+
+  const size_t rowBytes = bytes / rows;
+  const uint8_t* pA = (const uint8_t*)a;
+  const uint8_t* pB = (const uint8_t*)b;
+  uint64_t changedRows = 0;
+  for (uint16_t y = 0; y < rows; y++, pA += rowBytes, pB += rowBytes)
+  {
+    if (memcmp(pA, pB, rowBytes) != 0) changedRows |= (uint64_t)1 << y;
+  }
+  return changedRows;
+}
+}  // namespace
+
+void FrameSlot::CopyFrom(const DMD::Update& update)
+{
+  mode = update.mode;
+  layout = update.layout;
+  depth = update.depth;
+  hasData = update.hasData;
+  hasSegData = update.hasSegData;
+  hasSegData2 = update.hasSegData2;
+  r = update.r;
+  g = update.g;
+  b = update.b;
+  width = update.width;
+  height = update.height;
+
+  if (dataSize > 0) memcpy(data, update.data, dataSize);
+  if (segDataSize > 0) memcpy(segData, update.segData, segDataSize * sizeof(uint16_t));
+  if (segData2Size > 0) memcpy(segData2, update.segData2, segData2Size * sizeof(uint16_t));
+}
+
+void FrameSlot::CopyTo(DMD::Update& update) const
+{
+  update.mode = mode;
+  update.layout = layout;
+  update.depth = depth;
+  update.hasData = hasData;
+  update.hasSegData = hasSegData;
+  update.hasSegData2 = hasSegData2;
+  update.r = r;
+  update.g = g;
+  update.b = b;
+  update.width = width;
+  update.height = height;
+
+  if (dataSize > 0) memcpy(update.data, data, dataSize);
+  if (segDataSize > 0) memcpy(update.segData, segData, segDataSize * sizeof(uint16_t));
+  if (segData2Size > 0) memcpy(update.segData2, segData2, segData2Size * sizeof(uint16_t));
+}
+
+void FrameSlot::ClearMissingPayload()
+{
+  if (dataSize > 0 && !hasData) memset(data, 0, dataSize);
+  if (segDataSize > 0 && !hasData && !hasSegData) memset(segData, 0, segDataSize * sizeof(uint16_t));
+  if (segData2Size > 0 && !hasData && !hasSegData2) memset(segData2, 0, segData2Size * sizeof(uint16_t));
+}
+
+void FrameSlot::ComputeHash()
+{
+  hash = komihash(data, dataSize, 0);
+  if (segDataSize > 0) hash = komihash(segData, segDataSize * sizeof(uint16_t), hash);
+  if (segData2Size > 0) hash = komihash(segData2, segData2Size * sizeof(uint16_t), hash);
+  hashed = true;
+}
+
+bool FrameSlot::HasSameFormat(const FrameSlot& other) const
+{
+  return mode == other.mode && layout == other.layout && depth == other.depth && width == other.width &&
+         height == other.height && hasData == other.hasData && hasSegData == other.hasSegData &&
+         hasSegData2 == other.hasSegData2 && r == other.r && g == other.g && b == other.b &&
+         dataSize == other.dataSize && segDataSize == other.segDataSize && segData2Size == other.segData2Size;
+}
+
+bool FrameSlot::IsNearDuplicate(const FrameSlot& other) const
+{
+  if (!HasSameFormat(other)) return false;
+
+  const size_t maxDifferences = (dataSize + segDataSize + segData2Size) / 256;
+  size_t differences = CountDifferences(data, other.data, dataSize, maxDifferences);
+  if (differences > maxDifferences) return false;
+  differences += CountDifferences(segData, other.segData, segDataSize, maxDifferences - differences);
+  if (differences > maxDifferences) return false;
+  differences += CountDifferences(segData2, other.segData2, segData2Size, maxDifferences - differences);
+  return differences <= maxDifferences;
+}
+
+uint64_t FrameSlot::GetChangedRows(const FrameSlot& previous) const
+{
+  if (this == &previous) return 0;
+  if (!HasSameFormat(previous)) return kAllRowsChanged;
+  if (hashed && previous.hashed && hash == previous.hash) return 0;
+
+  if (segData2Size > 0 && memcmp(segData2, previous.segData2, segData2Size * sizeof(uint16_t)) != 0)
+    return kAllRowsChanged;
+
+  uint64_t changedRows = 0;
+  if (dataSize > 0) changedRows |= CompareRows(data, previous.data, dataSize, height);
+  // Only RGB16 and Serum v2 frames carry pixels in segData, otherwise it holds segments or a palette.
+  if (segDataSize > 0)
+    changedRows |= CompareRows(segData, previous.segData, segDataSize * sizeof(uint16_t),
+                               segDataSize == (size_t)width * height ? height : 0);
+  return changedRows;
+}
+
+FrameSlotPool::~FrameSlotPool()
+{
+  for (uint8_t i = 0; i < DMDUTIL_FRAME_SLOT_SIZE_CLASSES; i++)
+  {
+    for (FrameSlot* pSlot : m_free[i]) delete pSlot;
+    m_free[i].clear();
+  }
+}
+
+void FrameSlotPool::GetPayloadSize(DMD::Mode mode, uint16_t width, uint16_t height, size_t& dataSize,
+                                   size_t& segDataSize, size_t& segData2Size)
+{
+  const size_t pixels = (size_t)width * height;
+  dataSize = 0;
+  segDataSize = 0;
+  segData2Size = 0;
+
+  switch (mode)
+  {
+    case DMD::Mode::RGB24:
+      dataSize = pixels * 3;
+      break;
+
+    case DMD::Mode::RGB16:
+    case DMD::Mode::SerumV2_32:
+    case DMD::Mode::SerumV2_32_64:
+    case DMD::Mode::SerumV2_64:
+    case DMD::Mode::SerumV2_64_32:
+      segDataSize = pixels;
+      break;
+
+    case DMD::Mode::SerumV1:
+    case DMD::Mode::Vni:
+      // Index data plus a palette of up to 256 RGB entries.
+      dataSize = pixels;
+      segDataSize = 256 * 3 / 2;
+      break;
+
+    case DMD::Mode::AlphaNumeric:
+      segDataSize = 128;
+      segData2Size = 128;
+      break;
+
+    case DMD::Mode::SerumCommand:
+      // Source and value in data, event in segData.
+      dataSize = 2;
+      segDataSize = 1;
+      break;
+
+    default:
+      dataSize = pixels;
+      break;
+  }
+}
+
+std::shared_ptr<FrameSlot> FrameSlotPool::Acquire(DMD::Mode mode, uint16_t width, uint16_t height)
+{
+  if (mode != DMD::Mode::AlphaNumeric && mode != DMD::Mode::SerumCommand && (size_t)width * height > 256 * 64)
+    return nullptr;
+
+  size_t dataSize;
+  size_t segDataSize;
+  size_t segData2Size;
+  GetPayloadSize(mode, width, height, dataSize, segDataSize, segData2Size);
+
+  const size_t segDataOffset = AlignPayloadOffset(dataSize);
+  const size_t segData2Offset = AlignPayloadOffset(segDataOffset + segDataSize * sizeof(uint16_t));
+  const size_t payloadBytes = segData2Offset + segData2Size * sizeof(uint16_t);
+
+  uint8_t sizeClass = 0;
+  while ((kMinSlotBytes << sizeClass) < payloadBytes) sizeClass++;
+  if (sizeClass >= DMDUTIL_FRAME_SLOT_SIZE_CLASSES) return nullptr;
+
+  FrameSlot* pSlot = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_free[sizeClass].empty())
+    {
+      pSlot = m_free[sizeClass].back();
+      m_free[sizeClass].pop_back();
+    }
+  }
+
+  if (!pSlot)
+  {
+    pSlot = new FrameSlot();
+    pSlot->m_pPayload = new uint8_t[kMinSlotBytes << sizeClass];
+    pSlot->m_sizeClass = sizeClass;
+  }
+
+  pSlot->mode = mode;
+  pSlot->indexedState = FrameSlot::RenderState::Pending;
+  pSlot->rgb888State = FrameSlot::RenderState::Pending;
+  pSlot->pRenderIndexed = nullptr;
+  pSlot->layout = AlphaNumericLayout::NoLayout;
+  pSlot->depth = 2;
+  pSlot->hasData = false;
+  pSlot->hasSegData = false;
+  pSlot->hasSegData2 = false;
+  pSlot->r = 255;
+  pSlot->g = 255;
+  pSlot->b = 255;
+  pSlot->width = width;
+  pSlot->height = height;
+  pSlot->dataSize = dataSize;
+  pSlot->segDataSize = segDataSize;
+  pSlot->segData2Size = segData2Size;
+  pSlot->hashed = false;
+  pSlot->data = dataSize > 0 ? pSlot->m_pPayload : nullptr;
+  pSlot->segData = segDataSize > 0 ? (uint16_t*)(pSlot->m_pPayload + segDataOffset) : nullptr;
+  pSlot->segData2 = segData2Size > 0 ? (uint16_t*)(pSlot->m_pPayload + segData2Offset) : nullptr;
+
+  // Palettes, segment data and commands are small and often only partially written.
+  if (mode == DMD::Mode::SerumV1 || mode == DMD::Mode::Vni || mode == DMD::Mode::AlphaNumeric ||
+      mode == DMD::Mode::SerumCommand)
+  {
+    memset(pSlot->segData, 0, segDataSize * sizeof(uint16_t));
+    if (segData2Size > 0) memset(pSlot->segData2, 0, segData2Size * sizeof(uint16_t));
+    if (mode == DMD::Mode::SerumCommand) memset(pSlot->data, 0, dataSize);
+  }
+
+  return std::shared_ptr<FrameSlot>(pSlot, [this](FrameSlot* pReleased) { Release(pReleased); });
+}
+
+void FrameSlotPool::Release(FrameSlot* pSlot)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_free[pSlot->m_sizeClass].size() < DMDUTIL_FRAME_SLOT_MAX_FREE)
+    {
+      m_free[pSlot->m_sizeClass].push_back(pSlot);
+      return;
+    }
+  }
+
+  delete pSlot;
+}
+
+}  // namespace DMDUtil
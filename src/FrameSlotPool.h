@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "DMDUtil/DMD.h"
+
+#define DMDUTIL_FRAME_SLOT_SIZE_CLASSES 8  // 1 KB ... 128 KB
+#define DMDUTIL_FRAME_SLOT_MAX_FREE 64     // Per size class
+
+namespace DMDUtil
+{
+
+class FrameSlotPool;
+
+// A queued frame. It carries the same fields as DMD::Update, but data, segData and segData2 only point to as many
+// bytes as the mode and the dimensions require. A slot must not be modified after it has been queued.
+class FrameSlot
+{
+ public:
+  DMD::Mode mode = DMD::Mode::Data;
+  AlphaNumericLayout layout = AlphaNumericLayout::NoLayout;
+  int depth = 2;
+  uint8_t* data = nullptr;
+  uint16_t* segData = nullptr;
+  uint16_t* segData2 = nullptr;
+  bool hasData = false;
+  bool hasSegData = false;
+  bool hasSegData2 = false;
+  uint8_t r = 255;
+  uint8_t g = 255;
+  uint8_t b = 255;
+  uint16_t width = 128;
+  uint16_t height = 32;
+
+  // Number of elements available in data, segData and segData2.
+  size_t dataSize = 0;
+  size_t segDataSize = 0;
+  size_t segData2Size = 0;
+
+  // komihash of data, segData and segData2, in this order. Set by the ingest thread before the frame is queued.
+  // Frames with only data have the same hash as their data.
+  uint64_t hash = 0;
+  bool hashed = false;
+
+  void CopyFrom(const DMD::Update& update);
+  void CopyTo(DMD::Update& update) const;
+  // Zeroes the payload parts the frame wasn't given, so hashing and comparing it doesn't read what an earlier frame
+  // left in the slot. RGB16, Serum and VNI frames keep pixels or a palette in segData with only hasData set.
+  void ClearMissingPayload();
+  void ComputeHash();
+  // True if both frames have the same format and differ in at most 1/256 of their payload elements.
+  bool IsNearDuplicate(const FrameSlot& other) const;
+  // Returns a bit per row that differs from previous, 0 if both frames are equal. All bits are set if the format, the
+  // tint, the segment data or the palette changed, or if the frame has more than 64 rows.
+  uint64_t GetChangedRows(const FrameSlot& previous) const;
+
+  static constexpr uint64_t kAllRowsChanged = ~(uint64_t)0;
+
+  enum class RenderState : uint8_t
+  {
+    Pending,
+    Done,
+    Unavailable
+  };
+
+  // Render cache shared by all output threads, see DMD::RenderIndexed() and DMD::RenderRgb888().
+  // Guarded by renderMutex.
+  std::mutex renderMutex;
+  RenderState indexedState = RenderState::Pending;
+  RenderState rgb888State = RenderState::Pending;
+  const uint8_t* pRenderIndexed = nullptr;
+  uint8_t renderPalette[256 * 3] = {0};
+  uint8_t* pRenderAlphaNumeric = nullptr;
+  uint8_t* pRenderRgb888 = nullptr;
+
+ private:
+  friend class FrameSlotPool;
+
+  bool HasSameFormat(const FrameSlot& other) const;
+
+  FrameSlot() {}
+  ~FrameSlot()
+  {
+    delete[] m_pPayload;
+    delete[] pRenderAlphaNumeric;
+    delete[] pRenderRgb888;
+  }
+
+  uint8_t* m_pPayload = nullptr;
+  uint8_t m_sizeClass = 0;
+};
+
+class FrameSlotPool
+{
+ public:
+  FrameSlotPool() {}
+  ~FrameSlotPool();
+
+  // Reserves a slot sized for mode, width and height. Returns nullptr if the frame exceeds 256x64.
+  // The header is reset, data and RGB16 payloads are not initialized and need to be written by the producer.
+  std::shared_ptr<FrameSlot> Acquire(DMD::Mode mode, uint16_t width, uint16_t height);
+
+  static void GetPayloadSize(DMD::Mode mode, uint16_t width, uint16_t height, size_t& dataSize, size_t& segDataSize,
+                             size_t& segData2Size);
+
+ private:
+  void Release(FrameSlot* pSlot);
+
+  std::mutex m_mutex;
+  std::vector<FrameSlot*> m_free[DMDUTIL_FRAME_SLOT_SIZE_CLASSES];
+};
+
+}  // namespace DMDUtil
@@ -0,0 +1,89 @@
+#include "IngestQueue.h"
+
+namespace DMDUtil
+{
+
+IngestQueue::IngestQueue(size_t capacity)
+{
+  size_t size = 2;
+  while (size < capacity) size <<= 1;
+
+  m_pCells = new Cell[size];
+  m_mask = size - 1;
+  for (size_t i = 0; i < size; i++)
+  {
+    m_pCells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  m_enqueuePos.store(0, std::memory_order_relaxed);
+  m_dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+IngestQueue::~IngestQueue() { delete[] m_pCells; }
+
+bool IngestQueue::TryPush(IngestItem& item)
+{
+  Cell* pCell;
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  while (true)
+  {
+    pCell = &m_pCells[pos & m_mask];
+    const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+    if (diff == 0)
+    {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    }
+    else if (diff < 0)
+    {
+      // Full.
+      return false;
+    }
+    else
+    {
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  pCell->item = std::move(item);
+  pCell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool IngestQueue::TryPop(IngestItem& item)
+{
+  Cell* pCell;
+  size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+  while (true)
+  {
+    pCell = &m_pCells[pos & m_mask];
+    const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+    if (diff == 0)
+    {
+      if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    }
+    else if (diff < 0)
+    {
+      // Empty.
+      return false;
+    }
+    else
+    {
+      pos = m_dequeuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  item = std::move(pCell->item);
+  pCell->item.frame.reset();
+  pCell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+  return true;
+}
+
+bool IngestQueue::IsEmpty() const
+{
+  const size_t pos = m_dequeuePos.load(std::memory_order_acquire);
+  const size_t sequence = m_pCells[pos & m_mask].sequence.load(std::memory_order_acquire);
+  return (intptr_t)sequence - (intptr_t)(pos + 1) < 0;
+}
+
+}  // namespace DMDUtil
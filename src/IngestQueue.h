@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "DMDUtil/DMD.h"
+#include "FrameSlotPool.h"
+
+namespace DMDUtil
+{
+
+struct IngestItem
+{
+  std::shared_ptr<FrameSlot> frame;
+  bool buffered = false;
+  bool hasTimestamp = false;
+  uint32_t timestampMs = 0;
+  DMD::FrameContext frameContext;
+};
+
+// Bounded queue with per-cell sequence numbers. Producers never take a lock and entries are popped in the order
+// their push succeeded. TryPop() may also be called by a producer to evict the oldest entry.
+class IngestQueue
+{
+ public:
+  explicit IngestQueue(size_t capacity);
+  ~IngestQueue();
+
+  // On success the item is moved into the queue, otherwise it is left untouched.
+  bool TryPush(IngestItem& item);
+  bool TryPop(IngestItem& item);
+  bool IsEmpty() const;
+  size_t GetCapacity() const { return m_mask + 1; }
+
+ private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    IngestItem item;
+  };
+
+  Cell* m_pCells;
+  size_t m_mask;
+  alignas(64) std::atomic<size_t> m_enqueuePos;
+  alignas(64) std::atomic<size_t> m_dequeuePos;
+};
+
+}  // namespace DMDUtil
@@ -0,0 +1,71 @@
+#include "PaletteCache.h"
+
+#include <mutex>
+
+#include "FrameUtil.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+
+struct Entry
+{
+  std::shared_ptr<const TintPalette> palette;
+  uint64_t lastUse = 0;
+};
+
+std::mutex s_mutex;
+Entry s_entries[DMDUTIL_PALETTE_CACHE_SIZE];
+uint64_t s_useCounter = 0;
+uint32_t s_generation = 0;
+
+std::shared_ptr<const TintPalette> CreatePalette(uint8_t depth, uint8_t r, uint8_t g, uint8_t b)
+{
+  std::shared_ptr<TintPalette> palette = std::make_shared<TintPalette>();
+  palette->generation = ++s_generation;
+  if (palette->generation == 0) palette->generation = ++s_generation;
+  palette->depth = depth;
+  palette->r = r;
+  palette->g = g;
+  palette->b = b;
+  palette->colors = (depth == 2) ? 4 : 16;
+
+  uint8_t pos = 0;
+  for (uint8_t i = 0; i < palette->colors; i++)
+  {
+    float perc = FrameUtil::Helper::CalcBrightness((float)i / (float)(palette->colors - 1));
+    palette->rgb888[pos++] = (uint8_t)((float)r * perc);
+    palette->rgb888[pos++] = (uint8_t)((float)g * perc);
+    palette->rgb888[pos++] = (uint8_t)((float)b * perc);
+  }
+
+  return palette;
+}
+
+}  // namespace
+
+std::shared_ptr<const TintPalette> PaletteCache::Get(uint8_t depth, uint8_t r, uint8_t g, uint8_t b)
+{
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_useCounter++;
+
+  Entry* pOldest = &s_entries[0];
+  for (Entry& entry : s_entries)
+  {
+    const TintPalette* pPalette = entry.palette.get();
+    if (pPalette && pPalette->depth == depth && pPalette->r == r && pPalette->g == g && pPalette->b == b)
+    {
+      entry.lastUse = s_useCounter;
+      return entry.palette;
+    }
+    if (entry.lastUse < pOldest->lastUse) pOldest = &entry;
+  }
+
+  pOldest->palette = CreatePalette(depth, r, g, b);
+  pOldest->lastUse = s_useCounter;
+  return pOldest->palette;
+}
+
+}  // namespace DMDUtil
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#define DMDUTIL_PALETTE_CACHE_SIZE 8
+
+namespace DMDUtil
+{
+
+// A 4 or 16 color palette shading from black to a tint color.
+struct TintPalette
+{
+  // Unique per computed palette, never 0.
+  uint32_t generation = 0;
+  uint8_t depth = 0;
+  uint8_t r = 0;
+  uint8_t g = 0;
+  uint8_t b = 0;
+  uint8_t colors = 0;
+  uint8_t rgb888[16 * 3] = {0};
+};
+
+// Tint palettes shared by all threads. The tint rarely changes during a game, so the last few palettes are kept and
+// the least recently used one gets replaced.
+class PaletteCache
+{
+ public:
+  // Depth must be 2 or 4.
+  static std::shared_ptr<const TintPalette> Get(uint8_t depth, uint8_t r, uint8_t g, uint8_t b);
+};
+
+}  // namespace DMDUtil
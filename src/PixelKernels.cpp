@@ -0,0 +1,765 @@
+#include "PixelKernels.h"
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DMDUTIL_PIXEL_KERNELS_SSSE3
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DMDUTIL_TARGET_SSSE3
+#else
+#define DMDUTIL_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DMDUTIL_PIXEL_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DMDUtil
+{
+
+namespace
+{
+
+typedef void (*IndexedToRgb888Func)(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint8_t* pDst,
+                                    size_t pixels);
+typedef void (*IndexedToRgb565Func)(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint16_t* pDst,
+                                    size_t pixels);
+typedef void (*Rgb565ToRgb888Func)(const uint16_t* pSrc, uint8_t* pDst, size_t pixels);
+typedef void (*Rgb888ToRgb565Func)(const uint8_t* pSrc, uint16_t* pDst, size_t pixels);
+typedef void (*SwapBytes16Func)(const uint8_t* pSrc, uint8_t* pDst, size_t count);
+typedef void (*QuantizeRgb888Func)(const uint8_t* pSrc, const uint8_t* pPalette, int shift, uint8_t* pDst,
+                                   size_t pixels);
+typedef size_t (*FormatHexFunc)(const uint8_t* pSrc, char* pDst, size_t count);
+typedef void (*FormatHex8Func)(const uint8_t* pSrc, char* pDst, size_t count);
+typedef void (*FormatHex16Func)(const uint16_t* pSrc, char* pDst, size_t count);
+
+struct Kernels
+{
+  const char* name;
+  IndexedToRgb888Func indexedToRgb888;
+  IndexedToRgb565Func indexedToRgb565;
+  Rgb565ToRgb888Func rgb565ToRgb888;
+  Rgb888ToRgb565Func rgb888ToRgb565;
+  SwapBytes16Func swapBytes16;
+  QuantizeRgb888Func quantizeRgb888;
+  FormatHexFunc formatHex;
+  FormatHex8Func formatHex8;
+  FormatHex16Func formatHex16;
+};
+
+constexpr int kLumaShift = PixelKernels::kLumaShift;
+constexpr uint16_t kLumaRed = PixelKernels::kLumaRed;
+constexpr uint16_t kLumaGreen = PixelKernels::kLumaGreen;
+constexpr uint16_t kLumaBlue = PixelKernels::kLumaBlue;
+
+inline uint16_t ToRgb565(const uint8_t* pColor)
+{
+  return (uint16_t)(((pColor[0] & 0xF8u) << 8) | ((pColor[1] & 0xFCu) << 3) | (pColor[2] >> 3));
+}
+
+void IndexedToRgb888Scalar(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint8_t* pDst,
+                           size_t pixels)
+{
+  (void)colors;
+  for (size_t i = 0; i < pixels; i++)
+  {
+    const uint8_t* pColor = &pPalette[pIndexed[i] * 3];
+    *pDst++ = pColor[0];
+    *pDst++ = pColor[1];
+    *pDst++ = pColor[2];
+  }
+}
+
+void IndexedToRgb565Scalar(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint16_t* pDst,
+                           size_t pixels)
+{
+  (void)colors;
+  for (size_t i = 0; i < pixels; i++) pDst[i] = ToRgb565(&pPalette[pIndexed[i] * 3]);
+}
+
+void Rgb565ToRgb888Scalar(const uint16_t* pSrc, uint8_t* pDst, size_t pixels)
+{
+  for (size_t i = 0; i < pixels; i++)
+  {
+    const uint16_t value = pSrc[i];
+    const uint8_t r = (uint8_t)((value >> 11) & 0x1F);
+    const uint8_t g = (uint8_t)((value >> 5) & 0x3F);
+    const uint8_t b = (uint8_t)(value & 0x1F);
+    *pDst++ = (uint8_t)((r << 3) | (r >> 2));
+    *pDst++ = (uint8_t)((g << 2) | (g >> 4));
+    *pDst++ = (uint8_t)((b << 3) | (b >> 2));
+  }
+}
+
+void Rgb888ToRgb565Scalar(const uint8_t* pSrc, uint16_t* pDst, size_t pixels)
+{
+  for (size_t i = 0; i < pixels; i++) pDst[i] = ToRgb565(&pSrc[i * 3]);
+}
+
+void SwapBytes16Scalar(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint8_t high = pSrc[i * 2];
+    pDst[i * 2] = pSrc[i * 2 + 1];
+    pDst[i * 2 + 1] = high;
+  }
+}
+
+void QuantizeRgb888Scalar(const uint8_t* pSrc, const uint8_t* pPalette, int shift, uint8_t* pDst, size_t pixels)
+{
+  for (size_t i = 0; i < pixels; i++, pSrc += 3)
+  {
+    const uint8_t* pColor = &pPalette[(PixelKernels::GetLuminance(pSrc[0], pSrc[1], pSrc[2]) >> shift) * 3];
+    *pDst++ = pColor[0];
+    *pDst++ = pColor[1];
+    *pDst++ = pColor[2];
+  }
+}
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// The two hex digits of every byte value.
+struct HexPairs
+{
+  char pairs[256][2] = {};
+
+  constexpr HexPairs()
+  {
+    for (int i = 0; i < 256; i++)
+    {
+      pairs[i][0] = kHexDigits[i >> 4];
+      pairs[i][1] = kHexDigits[i & 0xF];
+    }
+  }
+};
+
+constexpr HexPairs kHexPairs;
+
+size_t FormatHexScalar(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  char* p = pDst;
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint8_t value = pSrc[i];
+    if (value > 0xF) *p++ = kHexDigits[value >> 4];
+    *p++ = kHexDigits[value & 0xF];
+  }
+  return (size_t)(p - pDst);
+}
+
+void FormatHex8Scalar(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  for (size_t i = 0; i < count; i++) memcpy(pDst + i * 2, kHexPairs.pairs[pSrc[i]], 2);
+}
+
+void FormatHex16Scalar(const uint16_t* pSrc, char* pDst, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    memcpy(pDst + i * 4, kHexPairs.pairs[pSrc[i] >> 8], 2);
+    memcpy(pDst + i * 4 + 2, kHexPairs.pairs[pSrc[i] & 0xFF], 2);
+  }
+}
+
+// Splits a palette of up to 16 colors into one lookup table per channel.
+void SplitPalette(const uint8_t* pPalette, uint16_t colors, uint8_t* pRed, uint8_t* pGreen, uint8_t* pBlue)
+{
+  for (uint16_t i = 0; i < 16; i++)
+  {
+    const bool valid = i < colors;
+    pRed[i] = valid ? pPalette[i * 3] : 0;
+    pGreen[i] = valid ? pPalette[i * 3 + 1] : 0;
+    pBlue[i] = valid ? pPalette[i * 3 + 2] : 0;
+  }
+}
+
+void SplitPalette565(const uint8_t* pPalette, uint16_t colors, uint8_t* pLow, uint8_t* pHigh)
+{
+  for (uint16_t i = 0; i < 16; i++)
+  {
+    const uint16_t value = i < colors ? ToRgb565(&pPalette[i * 3]) : 0;
+    pLow[i] = (uint8_t)(value & 0xFF);
+    pHigh[i] = (uint8_t)(value >> 8);
+  }
+}
+
+#if defined(DMDUTIL_PIXEL_KERNELS_SSSE3)
+// Shuffle masks to interleave 16 R, G and B bytes into 48 RGB bytes and back. 0x80 clears the byte.
+struct RgbShuffleMasks
+{
+  alignas(16) uint8_t interleave[3][3][16] = {};
+  alignas(16) uint8_t deinterleave[3][3][16] = {};
+
+  constexpr RgbShuffleMasks()
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      for (int k = 0; k < 16; k++)
+      {
+        for (int channel = 0; channel < 3; channel++)
+        {
+          // Byte k of output block j holds channel (16 * j + k) % 3 of pixel (16 * j + k) / 3.
+          const int position = 16 * j + k;
+          interleave[j][channel][k] = (position % 3 == channel) ? (uint8_t)(position / 3) : 0x80;
+          // Pixel k of a channel comes from byte (3 * k + channel) % 16 of input block (3 * k + channel) / 16.
+          const int source = 3 * k + channel;
+          deinterleave[j][channel][k] = (source / 16 == j) ? (uint8_t)(source % 16) : 0x80;
+        }
+      }
+    }
+  }
+};
+
+constexpr RgbShuffleMasks kRgbShuffleMasks;
+
+DMDUTIL_TARGET_SSSE3 inline void StoreRgbSsse3(uint8_t* pDst, __m128i r, __m128i g, __m128i b)
+{
+  for (int j = 0; j < 3; j++)
+  {
+    const __m128i rgb = _mm_or_si128(
+        _mm_or_si128(_mm_shuffle_epi8(r, _mm_load_si128((const __m128i*)kRgbShuffleMasks.interleave[j][0])),
+                     _mm_shuffle_epi8(g, _mm_load_si128((const __m128i*)kRgbShuffleMasks.interleave[j][1]))),
+        _mm_shuffle_epi8(b, _mm_load_si128((const __m128i*)kRgbShuffleMasks.interleave[j][2])));
+    _mm_storeu_si128((__m128i*)(pDst + j * 16), rgb);
+  }
+}
+
+DMDUTIL_TARGET_SSSE3 inline __m128i LoadChannelSsse3(const __m128i* pBlocks, int channel)
+{
+  __m128i value = _mm_setzero_si128();
+  for (int j = 0; j < 3; j++)
+    value = _mm_or_si128(
+        value, _mm_shuffle_epi8(pBlocks[j], _mm_load_si128((const __m128i*)kRgbShuffleMasks.deinterleave[j][channel])));
+  return value;
+}
+
+DMDUTIL_TARGET_SSSE3 void IndexedToRgb888Ssse3(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors,
+                                               uint8_t* pDst, size_t pixels)
+{
+  alignas(16) uint8_t channels[3][16];
+  SplitPalette(pPalette, colors, channels[0], channels[1], channels[2]);
+
+  const __m128i red = _mm_load_si128((const __m128i*)channels[0]);
+  const __m128i green = _mm_load_si128((const __m128i*)channels[1]);
+  const __m128i blue = _mm_load_si128((const __m128i*)channels[2]);
+  const __m128i indexMask = _mm_set1_epi8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const __m128i index = _mm_and_si128(_mm_loadu_si128((const __m128i*)(pIndexed + i)), indexMask);
+    StoreRgbSsse3(pDst + i * 3, _mm_shuffle_epi8(red, index), _mm_shuffle_epi8(green, index),
+                  _mm_shuffle_epi8(blue, index));
+  }
+
+  IndexedToRgb888Scalar(pIndexed + i, pPalette, colors, pDst + i * 3, pixels - i);
+}
+
+DMDUTIL_TARGET_SSSE3 void IndexedToRgb565Ssse3(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors,
+                                               uint16_t* pDst, size_t pixels)
+{
+  alignas(16) uint8_t bytes[2][16];
+  SplitPalette565(pPalette, colors, bytes[0], bytes[1]);
+
+  const __m128i low = _mm_load_si128((const __m128i*)bytes[0]);
+  const __m128i high = _mm_load_si128((const __m128i*)bytes[1]);
+  const __m128i indexMask = _mm_set1_epi8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const __m128i index = _mm_and_si128(_mm_loadu_si128((const __m128i*)(pIndexed + i)), indexMask);
+    const __m128i l = _mm_shuffle_epi8(low, index);
+    const __m128i h = _mm_shuffle_epi8(high, index);
+    _mm_storeu_si128((__m128i*)(pDst + i), _mm_unpacklo_epi8(l, h));
+    _mm_storeu_si128((__m128i*)(pDst + i + 8), _mm_unpackhi_epi8(l, h));
+  }
+
+  IndexedToRgb565Scalar(pIndexed + i, pPalette, colors, pDst + i, pixels - i);
+}
+
+// Expands 8 RGB565 values to one 8-bit channel each, stored in 16-bit lanes.
+DMDUTIL_TARGET_SSSE3 inline void ExpandRgb565Ssse3(__m128i value, __m128i& r, __m128i& g, __m128i& b)
+{
+  const __m128i mask5 = _mm_set1_epi16(0x1F);
+  const __m128i mask6 = _mm_set1_epi16(0x3F);
+  const __m128i r5 = _mm_srli_epi16(value, 11);
+  const __m128i g6 = _mm_and_si128(_mm_srli_epi16(value, 5), mask6);
+  const __m128i b5 = _mm_and_si128(value, mask5);
+  r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+  g = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+  b = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+}
+
+DMDUTIL_TARGET_SSSE3 void Rgb565ToRgb888Ssse3(const uint16_t* pSrc, uint8_t* pDst, size_t pixels)
+{
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    __m128i rLow, gLow, bLow, rHigh, gHigh, bHigh;
+    ExpandRgb565Ssse3(_mm_loadu_si128((const __m128i*)(pSrc + i)), rLow, gLow, bLow);
+    ExpandRgb565Ssse3(_mm_loadu_si128((const __m128i*)(pSrc + i + 8)), rHigh, gHigh, bHigh);
+    StoreRgbSsse3(pDst + i * 3, _mm_packus_epi16(rLow, rHigh), _mm_packus_epi16(gLow, gHigh),
+                  _mm_packus_epi16(bLow, bHigh));
+  }
+
+  Rgb565ToRgb888Scalar(pSrc + i, pDst + i * 3, pixels - i);
+}
+
+DMDUTIL_TARGET_SSSE3 void Rgb888ToRgb565Ssse3(const uint8_t* pSrc, uint16_t* pDst, size_t pixels)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i maskR = _mm_set1_epi16(0xF8);
+  const __m128i maskG = _mm_set1_epi16(0xFC);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const __m128i blocks[3] = {_mm_loadu_si128((const __m128i*)(pSrc + i * 3)),
+                               _mm_loadu_si128((const __m128i*)(pSrc + i * 3 + 16)),
+                               _mm_loadu_si128((const __m128i*)(pSrc + i * 3 + 32))};
+    const __m128i r = LoadChannelSsse3(blocks, 0);
+    const __m128i g = LoadChannelSsse3(blocks, 1);
+    const __m128i b = LoadChannelSsse3(blocks, 2);
+
+    for (int half = 0; half < 2; half++)
+    {
+      const __m128i r16 = half == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+      const __m128i g16 = half == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+      const __m128i b16 = half == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+      const __m128i value = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r16, maskR), 8),
+                                                      _mm_slli_epi16(_mm_and_si128(g16, maskG), 3)),
+                                         _mm_srli_epi16(b16, 3));
+      _mm_storeu_si128((__m128i*)(pDst + i + half * 8), value);
+    }
+  }
+
+  Rgb888ToRgb565Scalar(pSrc + i * 3, pDst + i, pixels - i);
+}
+
+// Luminance of 4 pixels given as 16-bit (r, g) pairs and 16-bit b values in the low halves of 32-bit lanes.
+DMDUTIL_TARGET_SSSE3 inline __m128i LumaSsse3(__m128i rg, __m128i b)
+{
+  const __m128i weightsRg = _mm_set1_epi32((kLumaGreen << 16) | kLumaRed);
+  const __m128i weightsB = _mm_set1_epi32(kLumaBlue);
+  return _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(rg, weightsRg), _mm_madd_epi16(b, weightsB)), kLumaShift);
+}
+
+DMDUTIL_TARGET_SSSE3 void QuantizeRgb888Ssse3(const uint8_t* pSrc, const uint8_t* pPalette, int shift, uint8_t* pDst,
+                                              size_t pixels)
+{
+  alignas(16) uint8_t channels[3][16];
+  SplitPalette(pPalette, (uint16_t)(256 >> shift), channels[0], channels[1], channels[2]);
+
+  const __m128i red = _mm_load_si128((const __m128i*)channels[0]);
+  const __m128i green = _mm_load_si128((const __m128i*)channels[1]);
+  const __m128i blue = _mm_load_si128((const __m128i*)channels[2]);
+  const __m128i levelShift = _mm_cvtsi32_si128(shift);
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const __m128i blocks[3] = {_mm_loadu_si128((const __m128i*)(pSrc + i * 3)),
+                               _mm_loadu_si128((const __m128i*)(pSrc + i * 3 + 16)),
+                               _mm_loadu_si128((const __m128i*)(pSrc + i * 3 + 32))};
+    const __m128i r = LoadChannelSsse3(blocks, 0);
+    const __m128i g = LoadChannelSsse3(blocks, 1);
+    const __m128i b = LoadChannelSsse3(blocks, 2);
+
+    __m128i levels[2];
+    for (int half = 0; half < 2; half++)
+    {
+      const __m128i r16 = half == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+      const __m128i g16 = half == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+      const __m128i b16 = half == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+      const __m128i lumaLow = LumaSsse3(_mm_unpacklo_epi16(r16, g16), _mm_unpacklo_epi16(b16, zero));
+      const __m128i lumaHigh = LumaSsse3(_mm_unpackhi_epi16(r16, g16), _mm_unpackhi_epi16(b16, zero));
+      levels[half] = _mm_srl_epi16(_mm_packs_epi32(lumaLow, lumaHigh), levelShift);
+    }
+
+    const __m128i index = _mm_packus_epi16(levels[0], levels[1]);
+    StoreRgbSsse3(pDst + i * 3, _mm_shuffle_epi8(red, index), _mm_shuffle_epi8(green, index),
+                  _mm_shuffle_epi8(blue, index));
+  }
+
+  QuantizeRgb888Scalar(pSrc + i * 3, pPalette, shift, pDst + i * 3, pixels - i);
+}
+
+DMDUTIL_TARGET_SSSE3 void SwapBytes16Ssse3(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i value = _mm_loadu_si128((const __m128i*)(pSrc + i * 2));
+    _mm_storeu_si128((__m128i*)(pDst + i * 2), _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8)));
+  }
+
+  SwapBytes16Scalar(pSrc + i * 2, pDst + i * 2, count - i);
+}
+
+// Writes the two hex digits of each of the 16 bytes, 32 chars.
+DMDUTIL_TARGET_SSSE3 inline void StoreHexSsse3(char* pDst, __m128i value)
+{
+  const __m128i digits = _mm_loadu_si128((const __m128i*)kHexDigits);
+  const __m128i mask = _mm_set1_epi8(0xF);
+  const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(value, 4), mask));
+  const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(value, mask));
+  _mm_storeu_si128((__m128i*)pDst, _mm_unpacklo_epi8(high, low));
+  _mm_storeu_si128((__m128i*)(pDst + 16), _mm_unpackhi_epi8(high, low));
+}
+
+DMDUTIL_TARGET_SSSE3 size_t FormatHexSsse3(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  const __m128i digits = _mm_loadu_si128((const __m128i*)kHexDigits);
+  const __m128i highMask = _mm_set1_epi8((char)0xF0);
+  char* p = pDst;
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const __m128i value = _mm_loadu_si128((const __m128i*)(pSrc + i));
+    // Indices of up to 16 colors are single digits, anything else takes the scalar path.
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(value, highMask), _mm_setzero_si128())) == 0xFFFF)
+    {
+      _mm_storeu_si128((__m128i*)p, _mm_shuffle_epi8(digits, value));
+      p += 16;
+    }
+    else
+      p += FormatHexScalar(pSrc + i, p, 16);
+  }
+
+  p += FormatHexScalar(pSrc + i, p, count - i);
+  return (size_t)(p - pDst);
+}
+
+DMDUTIL_TARGET_SSSE3 void FormatHex8Ssse3(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) StoreHexSsse3(pDst + i * 2, _mm_loadu_si128((const __m128i*)(pSrc + i)));
+
+  FormatHex8Scalar(pSrc + i, pDst + i * 2, count - i);
+}
+
+DMDUTIL_TARGET_SSSE3 void FormatHex16Ssse3(const uint16_t* pSrc, char* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // The high byte comes first in the text.
+    const __m128i value = _mm_loadu_si128((const __m128i*)(pSrc + i));
+    StoreHexSsse3(pDst + i * 4, _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8)));
+  }
+
+  FormatHex16Scalar(pSrc + i, pDst + i * 4, count - i);
+}
+
+bool HasSsse3()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 9)) != 0;
+#else
+  return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+#if defined(DMDUTIL_PIXEL_KERNELS_NEON)
+void IndexedToRgb888Neon(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint8_t* pDst,
+                         size_t pixels)
+{
+  uint8_t channels[3][16];
+  SplitPalette(pPalette, colors, channels[0], channels[1], channels[2]);
+
+  const uint8x16_t red = vld1q_u8(channels[0]);
+  const uint8x16_t green = vld1q_u8(channels[1]);
+  const uint8x16_t blue = vld1q_u8(channels[2]);
+  const uint8x16_t indexMask = vdupq_n_u8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const uint8x16_t index = vandq_u8(vld1q_u8(pIndexed + i), indexMask);
+    uint8x16x3_t rgb;
+    rgb.val[0] = vqtbl1q_u8(red, index);
+    rgb.val[1] = vqtbl1q_u8(green, index);
+    rgb.val[2] = vqtbl1q_u8(blue, index);
+    vst3q_u8(pDst + i * 3, rgb);
+  }
+
+  IndexedToRgb888Scalar(pIndexed + i, pPalette, colors, pDst + i * 3, pixels - i);
+}
+
+void IndexedToRgb565Neon(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint16_t* pDst,
+                         size_t pixels)
+{
+  uint8_t bytes[2][16];
+  SplitPalette565(pPalette, colors, bytes[0], bytes[1]);
+
+  const uint8x16_t low = vld1q_u8(bytes[0]);
+  const uint8x16_t high = vld1q_u8(bytes[1]);
+  const uint8x16_t indexMask = vdupq_n_u8(0x0F);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const uint8x16_t index = vandq_u8(vld1q_u8(pIndexed + i), indexMask);
+    uint8x16x2_t value;
+    value.val[0] = vqtbl1q_u8(low, index);
+    value.val[1] = vqtbl1q_u8(high, index);
+    // Interleaving low and high bytes gives little endian uint16_t values.
+    vst2q_u8((uint8_t*)(pDst + i), value);
+  }
+
+  IndexedToRgb565Scalar(pIndexed + i, pPalette, colors, pDst + i, pixels - i);
+}
+
+void Rgb565ToRgb888Neon(const uint16_t* pSrc, uint8_t* pDst, size_t pixels)
+{
+  const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+  const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    uint8x8_t channels[3][2];
+    for (int half = 0; half < 2; half++)
+    {
+      const uint16x8_t value = vld1q_u16(pSrc + i + half * 8);
+      const uint16x8_t r5 = vshrq_n_u16(value, 11);
+      const uint16x8_t g6 = vandq_u16(vshrq_n_u16(value, 5), mask6);
+      const uint16x8_t b5 = vandq_u16(value, mask5);
+      channels[0][half] = vmovn_u16(vorrq_u16(vshlq_n_u16(r5, 3), vshrq_n_u16(r5, 2)));
+      channels[1][half] = vmovn_u16(vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4)));
+      channels[2][half] = vmovn_u16(vorrq_u16(vshlq_n_u16(b5, 3), vshrq_n_u16(b5, 2)));
+    }
+
+    uint8x16x3_t rgb;
+    for (int channel = 0; channel < 3; channel++)
+      rgb.val[channel] = vcombine_u8(channels[channel][0], channels[channel][1]);
+    vst3q_u8(pDst + i * 3, rgb);
+  }
+
+  Rgb565ToRgb888Scalar(pSrc + i, pDst + i * 3, pixels - i);
+}
+
+void Rgb888ToRgb565Neon(const uint8_t* pSrc, uint16_t* pDst, size_t pixels)
+{
+  const uint8x16_t maskR = vdupq_n_u8(0xF8);
+  const uint8x16_t maskG = vdupq_n_u8(0xFC);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const uint8x16x3_t rgb = vld3q_u8(pSrc + i * 3);
+    const uint8x16_t r = vandq_u8(rgb.val[0], maskR);
+    const uint8x16_t g = vandq_u8(rgb.val[1], maskG);
+    const uint8x16_t b = vshrq_n_u8(rgb.val[2], 3);
+
+    vst1q_u16(pDst + i, vorrq_u16(vorrq_u16(vshll_n_u8(vget_low_u8(r), 8), vshll_n_u8(vget_low_u8(g), 3)),
+                                  vmovl_u8(vget_low_u8(b))));
+    vst1q_u16(pDst + i + 8, vorrq_u16(vorrq_u16(vshll_n_u8(vget_high_u8(r), 8), vshll_n_u8(vget_high_u8(g), 3)),
+                                      vmovl_u8(vget_high_u8(b))));
+  }
+
+  Rgb888ToRgb565Scalar(pSrc + i * 3, pDst + i, pixels - i);
+}
+
+void QuantizeRgb888Neon(const uint8_t* pSrc, const uint8_t* pPalette, int shift, uint8_t* pDst, size_t pixels)
+{
+  uint8_t channels[3][16];
+  SplitPalette(pPalette, (uint16_t)(256 >> shift), channels[0], channels[1], channels[2]);
+
+  const uint8x16_t red = vld1q_u8(channels[0]);
+  const uint8x16_t green = vld1q_u8(channels[1]);
+  const uint8x16_t blue = vld1q_u8(channels[2]);
+  const int16x8_t levelShift = vdupq_n_s16((int16_t)-shift);
+
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16)
+  {
+    const uint8x16x3_t rgb = vld3q_u8(pSrc + i * 3);
+
+    uint8x8_t levels[2];
+    for (int half = 0; half < 2; half++)
+    {
+      const uint16x8_t r = vmovl_u8(half == 0 ? vget_low_u8(rgb.val[0]) : vget_high_u8(rgb.val[0]));
+      const uint16x8_t g = vmovl_u8(half == 0 ? vget_low_u8(rgb.val[1]) : vget_high_u8(rgb.val[1]));
+      const uint16x8_t b = vmovl_u8(half == 0 ? vget_low_u8(rgb.val[2]) : vget_high_u8(rgb.val[2]));
+
+      uint32x4_t lumaLow = vmull_n_u16(vget_low_u16(r), kLumaRed);
+      lumaLow = vmlal_n_u16(lumaLow, vget_low_u16(g), kLumaGreen);
+      lumaLow = vmlal_n_u16(lumaLow, vget_low_u16(b), kLumaBlue);
+      uint32x4_t lumaHigh = vmull_n_u16(vget_high_u16(r), kLumaRed);
+      lumaHigh = vmlal_n_u16(lumaHigh, vget_high_u16(g), kLumaGreen);
+      lumaHigh = vmlal_n_u16(lumaHigh, vget_high_u16(b), kLumaBlue);
+
+      const uint16x8_t luma = vcombine_u16(vshrn_n_u32(lumaLow, kLumaShift), vshrn_n_u32(lumaHigh, kLumaShift));
+      levels[half] = vmovn_u16(vshlq_u16(luma, levelShift));
+    }
+
+    const uint8x16_t index = vcombine_u8(levels[0], levels[1]);
+    uint8x16x3_t out;
+    out.val[0] = vqtbl1q_u8(red, index);
+    out.val[1] = vqtbl1q_u8(green, index);
+    out.val[2] = vqtbl1q_u8(blue, index);
+    vst3q_u8(pDst + i * 3, out);
+  }
+
+  QuantizeRgb888Scalar(pSrc + i * 3, pPalette, shift, pDst + i * 3, pixels - i);
+}
+
+void SwapBytes16Neon(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) vst1q_u8(pDst + i * 2, vrev16q_u8(vld1q_u8(pSrc + i * 2)));
+
+  SwapBytes16Scalar(pSrc + i * 2, pDst + i * 2, count - i);
+}
+
+inline void StoreHexNeon(char* pDst, uint8x16_t value)
+{
+  const uint8x16_t digits = vld1q_u8((const uint8_t*)kHexDigits);
+  uint8x16x2_t out;
+  out.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(value, 4));
+  out.val[1] = vqtbl1q_u8(digits, vandq_u8(value, vdupq_n_u8(0xF)));
+  vst2q_u8((uint8_t*)pDst, out);
+}
+
+size_t FormatHexNeon(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  const uint8x16_t digits = vld1q_u8((const uint8_t*)kHexDigits);
+  char* p = pDst;
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const uint8x16_t value = vld1q_u8(pSrc + i);
+    if (vmaxvq_u8(value) <= 0xF)
+    {
+      vst1q_u8((uint8_t*)p, vqtbl1q_u8(digits, value));
+      p += 16;
+    }
+    else
+      p += FormatHexScalar(pSrc + i, p, 16);
+  }
+
+  p += FormatHexScalar(pSrc + i, p, count - i);
+  return (size_t)(p - pDst);
+}
+
+void FormatHex8Neon(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) StoreHexNeon(pDst + i * 2, vld1q_u8(pSrc + i));
+
+  FormatHex8Scalar(pSrc + i, pDst + i * 2, count - i);
+}
+
+void FormatHex16Neon(const uint16_t* pSrc, char* pDst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) StoreHexNeon(pDst + i * 4, vrev16q_u8(vld1q_u8((const uint8_t*)(pSrc + i))));
+
+  FormatHex16Scalar(pSrc + i, pDst + i * 4, count - i);
+}
+#endif
+
+constexpr Kernels kScalarKernels = {"scalar", IndexedToRgb888Scalar, IndexedToRgb565Scalar, Rgb565ToRgb888Scalar,
+                                    Rgb888ToRgb565Scalar, SwapBytes16Scalar, QuantizeRgb888Scalar, FormatHexScalar,
+                                    FormatHex8Scalar, FormatHex16Scalar};
+
+Kernels SelectKernels()
+{
+#if defined(DMDUTIL_PIXEL_KERNELS_SSSE3)
+  if (HasSsse3())
+    return {"SSSE3", IndexedToRgb888Ssse3, IndexedToRgb565Ssse3, Rgb565ToRgb888Ssse3, Rgb888ToRgb565Ssse3,
+            SwapBytes16Ssse3, QuantizeRgb888Ssse3, FormatHexSsse3, FormatHex8Ssse3, FormatHex16Ssse3};
+#elif defined(DMDUTIL_PIXEL_KERNELS_NEON)
+  return {"NEON", IndexedToRgb888Neon, IndexedToRgb565Neon, Rgb565ToRgb888Neon, Rgb888ToRgb565Neon,
+          SwapBytes16Neon, QuantizeRgb888Neon, FormatHexNeon, FormatHex8Neon, FormatHex16Neon};
+#endif
+  return kScalarKernels;
+}
+
+std::atomic<bool> s_scalarOnly{false};
+
+const Kernels& GetKernels()
+{
+  static const Kernels kernels = SelectKernels();
+  return s_scalarOnly.load(std::memory_order_relaxed) ? kScalarKernels : kernels;
+}
+
+}  // namespace
+
+void PixelKernels::IndexedToRgb888(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint8_t* pDst,
+                                   size_t pixels)
+{
+  if (colors <= 16)
+    GetKernels().indexedToRgb888(pIndexed, pPalette, colors, pDst, pixels);
+  else
+    IndexedToRgb888Scalar(pIndexed, pPalette, colors, pDst, pixels);
+}
+
+void PixelKernels::IndexedToRgb565(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint16_t* pDst,
+                                   size_t pixels)
+{
+  if (colors <= 16)
+    GetKernels().indexedToRgb565(pIndexed, pPalette, colors, pDst, pixels);
+  else
+    IndexedToRgb565Scalar(pIndexed, pPalette, colors, pDst, pixels);
+}
+
+void PixelKernels::Rgb565ToRgb888(const uint16_t* pSrc, uint8_t* pDst, size_t pixels)
+{
+  GetKernels().rgb565ToRgb888(pSrc, pDst, pixels);
+}
+
+void PixelKernels::Rgb888ToRgb565(const uint8_t* pSrc, uint16_t* pDst, size_t pixels)
+{
+  GetKernels().rgb888ToRgb565(pSrc, pDst, pixels);
+}
+
+void PixelKernels::ConvertByteOrder16(const void* pSrc, void* pDst, size_t count)
+{
+  if constexpr (std::endian::native == std::endian::big)
+  {
+    if (pSrc != pDst) memmove(pDst, pSrc, count * sizeof(uint16_t));
+  }
+  else
+    GetKernels().swapBytes16((const uint8_t*)pSrc, (uint8_t*)pDst, count);
+}
+
+void PixelKernels::QuantizeRgb888(const uint8_t* pSrc, const uint8_t* pPalette, uint8_t depth, uint8_t* pDst,
+                                  size_t pixels)
+{
+  GetKernels().quantizeRgb888(pSrc, pPalette, depth == 2 ? 6 : 4, pDst, pixels);
+}
+
+size_t PixelKernels::FormatHex(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  return GetKernels().formatHex(pSrc, pDst, count);
+}
+
+size_t PixelKernels::FormatHex8(const uint8_t* pSrc, char* pDst, size_t count)
+{
+  GetKernels().formatHex8(pSrc, pDst, count);
+  return count * 2;
+}
+
+size_t PixelKernels::FormatHex16(const uint16_t* pSrc, char* pDst, size_t count)
+{
+  GetKernels().formatHex16(pSrc, pDst, count);
+  return count * 4;
+}
+
+void PixelKernels::SetScalarOnly(bool scalarOnly) { s_scalarOnly.store(scalarOnly, std::memory_order_relaxed); }
+
+const char* PixelKernels::GetImplementationName() { return GetKernels().name; }
+
+}  // namespace DMDUtil
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DMDUtil
+{
+
+// Pixel format conversions used by the output threads. The implementation is selected once at runtime: SSSE3 on x86,
+// NEON on aarch64, otherwise a scalar loop.
+class PixelKernels
+{
+ public:
+  // Looks up each index in an RGB888 palette of the given number of colors. All indices must be below colors.
+  // Palettes of up to 16 colors are vectorized.
+  static void IndexedToRgb888(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint8_t* pDst,
+                              size_t pixels);
+  static void IndexedToRgb565(const uint8_t* pIndexed, const uint8_t* pPalette, uint16_t colors, uint16_t* pDst,
+                              size_t pixels);
+
+  // RGB565 to RGB888 replicates the high bits into the low bits, so white stays white.
+  static void Rgb565ToRgb888(const uint16_t* pSrc, uint8_t* pDst, size_t pixels);
+  static void Rgb888ToRgb565(const uint8_t* pSrc, uint16_t* pDst, size_t pixels);
+
+  // Converts count 16-bit values between host and network byte order. pSrc and pDst may be the same buffer and don't
+  // need to be aligned.
+  static void ConvertByteOrder16(const void* pSrc, void* pDst, size_t count);
+
+  // Replaces each RGB888 pixel by the palette color of its luminance level, 4 levels for depth 2, otherwise 16. The
+  // luminance uses BT.709 weights in 15-bit fixed point, it is at most 1 below or above the previous float calculation.
+  static void QuantizeRgb888(const uint8_t* pSrc, const uint8_t* pPalette, uint8_t depth, uint8_t* pDst,
+                             size_t pixels);
+
+  // BT.709 luminance weights scaled by 1 << 15. They add up to exactly 32768, so gray and white keep their value.
+  static constexpr int kLumaShift = 15;
+  static constexpr uint16_t kLumaRed = 6966;
+  static constexpr uint16_t kLumaGreen = 23436;
+  static constexpr uint16_t kLumaBlue = 2366;
+
+  // Luminance 0 - 255 as used by QuantizeRgb888().
+  static uint8_t GetLuminance(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return (uint8_t)((kLumaRed * r + kLumaGreen * g + kLumaBlue * b) >> kLumaShift);
+  }
+
+  // Lowercase hex text for the dumps, byte-identical to printf. pDst is not terminated. Return the number of chars
+  // written.
+  // "%x" per value, values above 15 take 2 chars.
+  static size_t FormatHex(const uint8_t* pSrc, char* pDst, size_t count);
+  // "%02x" per value, 2 * count chars.
+  static size_t FormatHex8(const uint8_t* pSrc, char* pDst, size_t count);
+  // "%04x" per value, 4 * count chars.
+  static size_t FormatHex16(const uint16_t* pSrc, char* pDst, size_t count);
+
+  // Uses the scalar loops instead of the selected implementation, to compare both in dmdutil-benchmark.
+  static void SetScalarOnly(bool scalarOnly);
+  static const char* GetImplementationName();
+};
+
+}  // namespace DMDUtil
@@ -0,0 +1,50 @@
+#include "TextDump.h"
+
+#include <cstdio>
+
+#include "PixelKernels.h"
+
+namespace DMDUtil
+{
+
+namespace
+{
+// charsPerValue is the maximum, formatRow returns the chars it actually wrote.
+template <typename T, typename FormatRow>
+size_t FormatFrame(std::vector<char>& text, uint32_t timestampMs, const T* pFrame, uint32_t rowLength,
+                   uint32_t height, size_t charsPerValue, FormatRow formatRow)
+{
+  text.resize(16 + (size_t)height * (rowLength * charsPerValue + 2) + 2);
+  size_t size = (size_t)snprintf(text.data(), text.size(), "0x%08x\r\n", timestampMs);
+  for (uint32_t y = 0; y < height; y++)
+  {
+    size += formatRow(&pFrame[(size_t)y * rowLength], &text[size], rowLength);
+    text[size++] = '\r';
+    text[size++] = '\n';
+  }
+  text[size++] = '\r';
+  text[size++] = '\n';
+  return size;
+}
+}  // namespace
+
+size_t TextDump::FormatIndexedFrame(std::vector<char>& text, uint32_t timestampMs, const uint8_t* pFrame,
+                                    uint32_t width, uint32_t height)
+{
+  // Values above 15 take two chars.
+  return FormatFrame(text, timestampMs, pFrame, width, height, 2, PixelKernels::FormatHex);
+}
+
+size_t TextDump::FormatRgb565Frame(std::vector<char>& text, uint32_t timestampMs, const uint16_t* pFrame,
+                                   uint32_t width, uint32_t height)
+{
+  return FormatFrame(text, timestampMs, pFrame, width, height, 4, PixelKernels::FormatHex16);
+}
+
+size_t TextDump::FormatRgb888Frame(std::vector<char>& text, uint32_t timestampMs, const uint8_t* pFrame,
+                                   uint32_t width, uint32_t height)
+{
+  return FormatFrame(text, timestampMs, pFrame, width * 3, height, 2, PixelKernels::FormatHex8);
+}
+
+}  // namespace DMDUtil
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DMDUtil
+{
+
+// Formats one frame of the txt, rgb565 and rgb888 dumps: the timestamp as "0x%08x", one line of hex values per row
+// and an empty line, each terminated by "\r\n". text is resized as needed, returns the number of chars.
+class TextDump
+{
+ public:
+  // "%x" per pixel.
+  static size_t FormatIndexedFrame(std::vector<char>& text, uint32_t timestampMs, const uint8_t* pFrame,
+                                   uint32_t width, uint32_t height);
+  // "%04x" per pixel.
+  static size_t FormatRgb565Frame(std::vector<char>& text, uint32_t timestampMs, const uint16_t* pFrame,
+                                  uint32_t width, uint32_t height);
+  // "%02x" per color component.
+  static size_t FormatRgb888Frame(std::vector<char>& text, uint32_t timestampMs, const uint8_t* pFrame,
+                                  uint32_t width, uint32_t height);
+};
+
+}  // namespace DMDUtil
@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DumpWriter.h"
+#include "FrameDump.h"
+#include "PixelKernels.h"
+#include "TextDump.h"
+#include "cargs.h"
+
+using namespace DMDUtil;
+
+namespace
+{
+struct FrameSize
+{
+  uint16_t width;
+  uint16_t height;
+};
+
+constexpr FrameSize kFrameSizes[] = {{128, 32}, {256, 64}};
+constexpr uint8_t kDepths[] = {2, 4};
+// Every length up to this is checked, which covers all tails the vector loops leave to the scalar loop.
+constexpr size_t kMaxTailLength = 67;
+
+uint32_t s_durationMs = 200;
+std::mt19937 s_random(4711);
+
+std::vector<uint8_t> RandomBytes(size_t size, uint32_t modulo = 256)
+{
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) byte = (uint8_t)(s_random() % modulo);
+  return bytes;
+}
+
+// Runs kernel(pDst) with the scalar loops and with the selected implementation and compares the output.
+template <typename T, typename Kernel>
+bool CheckScalar(const char* name, size_t size, Kernel kernel)
+{
+  std::vector<T> expected(size);
+  std::vector<T> actual(size);
+  PixelKernels::SetScalarOnly(true);
+  kernel(expected.data());
+  PixelKernels::SetScalarOnly(false);
+  kernel(actual.data());
+  if (expected == actual) return true;
+
+  printf("FAILED: %s differs from the scalar implementation\n", name);
+  return false;
+}
+
+// Checks a full frame and all short lengths, starting at an odd offset.
+template <typename T, typename Kernel>
+bool CheckScalarLengths(const char* name, size_t pixels, size_t dstPerPixel, Kernel kernel)
+{
+  bool ok = CheckScalar<T>(name, pixels * dstPerPixel, [&](T* pDst) { kernel(0, pDst, pixels); });
+  for (size_t length = 1; length <= kMaxTailLength && ok; length++)
+    ok = CheckScalar<T>(name, length * dstPerPixel, [&](T* pDst) { kernel(1, pDst, length); });
+  return ok;
+}
+
+template <typename Kernel>
+double MeasurePixelsPerNs(size_t pixels, Kernel kernel)
+{
+  kernel();
+  uint64_t runs = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto now = start;
+  do
+  {
+    for (int i = 0; i < 64; i++) kernel();
+    runs += 64;
+    now = std::chrono::steady_clock::now();
+  } while (now - start < std::chrono::milliseconds(s_durationMs));
+
+  return (double)(runs * pixels) / std::chrono::duration<double, std::nano>(now - start).count();
+}
+
+template <typename Kernel>
+void Benchmark(const char* name, size_t pixels, Kernel kernel)
+{
+  PixelKernels::SetScalarOnly(true);
+  const double scalar = MeasurePixelsPerNs(pixels, kernel);
+  PixelKernels::SetScalarOnly(false);
+  const double selected = MeasurePixelsPerNs(pixels, kernel);
+  printf("%-36s %8.3f %8.3f %7.2fx\n", name, scalar, selected, selected / scalar);
+}
+
+bool CheckIndexed()
+{
+  const std::vector<uint8_t> palette = RandomBytes(16 * 3);
+  bool ok = true;
+  for (const FrameSize& size : kFrameSizes)
+  {
+    const size_t pixels = (size_t)size.width * size.height;
+    for (uint8_t depth : kDepths)
+    {
+      const uint16_t colors = (uint16_t)(1 << depth);
+      const std::vector<uint8_t> indexed = RandomBytes(pixels + 1, colors);
+      ok &= CheckScalarLengths<uint8_t>("IndexedToRgb888", pixels, 3,
+                                        [&](size_t offset, uint8_t* pDst, size_t length)
+                                        {
+                                          PixelKernels::IndexedToRgb888(&indexed[offset], palette.data(), colors,
+                                                                        pDst, length);
+                                        });
+      ok &= CheckScalarLengths<uint16_t>("IndexedToRgb565", pixels, 1,
+                                         [&](size_t offset, uint16_t* pDst, size_t length)
+                                         {
+                                           PixelKernels::IndexedToRgb565(&indexed[offset], palette.data(), colors,
+                                                                         pDst, length);
+                                         });
+    }
+  }
+  return ok;
+}
+
+void BenchmarkIndexed()
+{
+  const std::vector<uint8_t> palette = RandomBytes(16 * 3);
+  std::vector<uint8_t> rgb888(256 * 64 * 3);
+  std::vector<uint16_t> rgb565(256 * 64);
+  char name[64];
+  for (const FrameSize& size : kFrameSizes)
+  {
+    const size_t pixels = (size_t)size.width * size.height;
+    for (uint8_t depth : kDepths)
+    {
+      const uint16_t colors = (uint16_t)(1 << depth);
+      const std::vector<uint8_t> indexed = RandomBytes(pixels, colors);
+      snprintf(name, sizeof(name), "IndexedToRgb888 %ux%u %u bit", size.width, size.height, depth);
+      Benchmark(name, pixels,
+                [&]()
+                { PixelKernels::IndexedToRgb888(indexed.data(), palette.data(), colors, rgb888.data(), pixels); });
+      snprintf(name, sizeof(name), "IndexedToRgb565 %ux%u %u bit", size.width, size.height, depth);
+      Benchmark(name, pixels,
+                [&]()
+                { PixelKernels::IndexedToRgb565(indexed.data(), palette.data(), colors, rgb565.data(), pixels); });
+    }
+  }
+}
+
+bool CheckConversions()
+{
+  // Every RGB565 value.
+  std::vector<uint16_t> rgb565(65536 + 1);
+  for (size_t i = 0; i < rgb565.size(); i++) rgb565[i] = (uint16_t)i;
+  const std::vector<uint8_t> rgb888 = RandomBytes((65536 + 1) * 3);
+
+  bool ok = CheckScalarLengths<uint8_t>("Rgb565ToRgb888", 65536, 3,
+                                        [&](size_t offset, uint8_t* pDst, size_t length)
+                                        { PixelKernels::Rgb565ToRgb888(&rgb565[offset], pDst, length); });
+  ok &= CheckScalarLengths<uint16_t>("Rgb888ToRgb565", 65536, 1,
+                                     [&](size_t offset, uint16_t* pDst, size_t length)
+                                     { PixelKernels::Rgb888ToRgb565(&rgb888[offset * 3], pDst, length); });
+  ok &= CheckScalarLengths<uint16_t>("SwapBytes16", 65536, 1,
+                                     [&](size_t offset, uint16_t* pDst, size_t length)
+                                     { PixelKernels::ConvertByteOrder16(&rgb565[offset], pDst, length); });
+  // In place, as used for the network byte order.
+  ok &= CheckScalarLengths<uint16_t>("SwapBytes16 in place", 65536, 1,
+                                     [&](size_t offset, uint16_t* pDst, size_t length)
+                                     {
+                                       memcpy(pDst, &rgb565[offset], length * sizeof(uint16_t));
+                                       PixelKernels::ConvertByteOrder16(pDst, pDst, length);
+                                     });
+  return ok;
+}
+
+void BenchmarkConversions()
+{
+  std::vector<uint8_t> rgb888 = RandomBytes(256 * 64 * 3);
+  std::vector<uint16_t> rgb565(256 * 64);
+  std::vector<uint16_t> swapped(256 * 64);
+  PixelKernels::Rgb888ToRgb565(rgb888.data(), rgb565.data(), rgb565.size());
+  char name[64];
+  for (const FrameSize& size : kFrameSizes)
+  {
+    const size_t pixels = (size_t)size.width * size.height;
+    snprintf(name, sizeof(name), "Rgb565ToRgb888 %ux%u", size.width, size.height);
+    Benchmark(name, pixels, [&]() { PixelKernels::Rgb565ToRgb888(rgb565.data(), rgb888.data(), pixels); });
+    snprintf(name, sizeof(name), "Rgb888ToRgb565 %ux%u", size.width, size.height);
+    Benchmark(name, pixels, [&]() { PixelKernels::Rgb888ToRgb565(rgb888.data(), rgb565.data(), pixels); });
+    snprintf(name, sizeof(name), "SwapBytes16 %ux%u", size.width, size.height);
+    Benchmark(name, pixels, [&]() { PixelKernels::ConvertByteOrder16(rgb565.data(), swapped.data(), pixels); });
+  }
+}
+
+// The float calculation DMD::AdjustRGB24Depth() used before the fixed-point kernels.
+uint8_t GetFloatLuminance(uint8_t r, uint8_t g, uint8_t b)
+{
+  int v = (int)(0.2126f * (float)r + 0.7152f * (float)g + 0.0722f * (float)b);
+  if (v > 255) v = 255;
+  return (uint8_t)v;
+}
+
+bool CheckQuantize()
+{
+  // The fixed-point luminance may differ by 1, so a level may differ by 1 at its boundaries.
+  constexpr int kMaxDiff = 1;
+  // Level i is rendered as gray i, so the level can be read from the output.
+  std::vector<uint8_t> palette(16 * 3);
+  for (size_t i = 0; i < palette.size(); i++) palette[i] = (uint8_t)(i / 3);
+
+  bool ok = true;
+  uint64_t lumaDiffs = 0;
+  uint64_t levelDiffs = 0;
+  std::vector<uint8_t> plane(256 * 256 * 3);
+  // Every RGB888 color, one red plane at a time.
+  for (int r = 0; r < 256 && ok; r++)
+  {
+    uint8_t* p = plane.data();
+    for (int g = 0; g < 256; g++)
+    {
+      for (int b = 0; b < 256; b++)
+      {
+        *p++ = (uint8_t)r;
+        *p++ = (uint8_t)g;
+        *p++ = (uint8_t)b;
+        const int diff = abs(PixelKernels::GetLuminance(r, g, b) - GetFloatLuminance(r, g, b));
+        if (diff > 0) lumaDiffs++;
+        ok &= diff <= kMaxDiff;
+      }
+    }
+    if (!ok) printf("FAILED: GetLuminance differs by more than %d from the float calculation\n", kMaxDiff);
+
+    for (uint8_t depth : kDepths)
+    {
+      std::vector<uint8_t> levels(plane.size());
+      // Lengths from 1 to kMaxTailLength, so the plane ends in every possible tail.
+      ok &= CheckScalar<uint8_t>("QuantizeRgb888", plane.size(),
+                                 [&](uint8_t* pDst)
+                                 {
+                                   size_t length = 0;
+                                   for (size_t offset = 0; offset < 65536; offset += length)
+                                   {
+                                     length = std::min(length % kMaxTailLength + 1, 65536 - offset);
+                                     PixelKernels::QuantizeRgb888(&plane[offset * 3], palette.data(), depth,
+                                                                  pDst + offset * 3, length);
+                                   }
+                                   memcpy(levels.data(), pDst, levels.size());
+                                 });
+
+      const int shift = depth == 2 ? 6 : 4;
+      for (size_t i = 0; i < 65536 && ok; i++)
+      {
+        const int level = GetFloatLuminance(plane[i * 3], plane[i * 3 + 1], plane[i * 3 + 2]) >> shift;
+        const int diff = abs(levels[i * 3] - level);
+        if (diff > 0) levelDiffs++;
+        if (diff > kMaxDiff)
+        {
+          printf("FAILED: QuantizeRgb888 level differs by more than %d from the float calculation\n", kMaxDiff);
+          ok = false;
+        }
+      }
+    }
+  }
+
+  if (ok)
+    printf("Luminance differs from the float calculation for %llu colors, the level for %llu colors and depths\n",
+           (unsigned long long)lumaDiffs, (unsigned long long)levelDiffs);
+  return ok;
+}
+
+void BenchmarkQuantize()
+{
+  const std::vector<uint8_t> palette = RandomBytes(16 * 3);
+  const std::vector<uint8_t> rgb888 = RandomBytes(256 * 64 * 3);
+  std::vector<uint8_t> quantized(256 * 64 * 3);
+  char name[64];
+  for (const FrameSize& size : kFrameSizes)
+  {
+    const size_t pixels = (size_t)size.width * size.height;
+    snprintf(name, sizeof(name), "QuantizeRgb888 %ux%u", size.width, size.height);
+    Benchmark(name, pixels,
+              [&]() { PixelKernels::QuantizeRgb888(rgb888.data(), palette.data(), 4, quantized.data(), pixels); });
+  }
+}
+
+// Formats values with printf, as the dumps did before the hex kernels.
+template <typename T>
+std::string Printf(const char* format, const T* pValues, size_t count)
+{
+  std::string text;
+  char value[8];
+  for (size_t i = 0; i < count; i++) text.append(value, snprintf(value, sizeof(value), format, pValues[i]));
+  return text;
+}
+
+template <typename T, typename Format>
+bool CheckHex(const char* name, const char* format, const std::vector<T>& values, Format formatHex)
+{
+  std::vector<char> text(values.size() * 4);
+  bool ok = true;
+  for (bool scalarOnly : {true, false})
+  {
+    PixelKernels::SetScalarOnly(scalarOnly);
+    // All values at once, then every length up to kMaxTailLength at an odd offset.
+    for (size_t length = 0; length <= kMaxTailLength && ok; length++)
+    {
+      const size_t offset = length == 0 ? 0 : 1;
+      const size_t count = length == 0 ? values.size() - 1 : length;
+      const size_t size = formatHex(&values[offset], text.data(), count);
+      ok = std::string(text.data(), size) == Printf(format, &values[offset], count);
+    }
+  }
+  PixelKernels::SetScalarOnly(false);
+  if (!ok) printf("FAILED: %s differs from printf(\"%s\")\n", name, format);
+  return ok;
+}
+
+bool CheckHex()
+{
+  // Every value, shuffled so each vector mixes short and long values.
+  std::vector<uint8_t> bytes(256 + 1);
+  for (size_t i = 0; i < bytes.size(); i++) bytes[i] = (uint8_t)i;
+  std::shuffle(bytes.begin(), bytes.end(), s_random);
+  std::vector<uint16_t> words(65536 + 1);
+  for (size_t i = 0; i < words.size(); i++) words[i] = (uint16_t)i;
+  std::shuffle(words.begin(), words.end(), s_random);
+
+  bool ok = CheckHex("FormatHex", "%x", bytes, PixelKernels::FormatHex);
+  ok &= CheckHex("FormatHex8", "%02x", bytes, PixelKernels::FormatHex8);
+  ok &= CheckHex("FormatHex16", "%04x", words, PixelKernels::FormatHex16);
+  // Only values below 16 take the vectorized path of FormatHex.
+  ok &= CheckHex("FormatHex", "%x", RandomBytes(4096 + 1, 16), PixelKernels::FormatHex);
+  return ok;
+}
+
+// Writes frames until the time is up, including the time to write everything to the disk.
+template <typename Open, typename WriteFrame>
+void BenchmarkDump(const char* name, Open open, WriteFrame writeFrame)
+{
+  uint32_t frames = 0;
+  const auto start = std::chrono::steady_clock::now();
+  {
+    DumpWriter writer;
+    DumpFile file(writer);
+    FrameDumpWriter frameDump(writer);
+    open(file, frameDump);
+    do
+    {
+      for (int i = 0; i < 16; i++) writeFrame(file, frameDump, frames++);
+    } while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(s_durationMs));
+    file.Close();
+    frameDump.Close();
+    writer.WaitUntilWritten(std::chrono::steady_clock::time_point::max());
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%-36s %10.0f frames/s\n", name, frames / seconds);
+}
+
+void BenchmarkDumps()
+{
+  constexpr uint16_t kWidth = 128;
+  constexpr uint16_t kHeight = 32;
+  constexpr size_t kPixels = kWidth * kHeight;
+  constexpr uint32_t kFrameCount = 16;
+  constexpr int kZipLevel = 6;
+  const std::vector<uint8_t> indexed = RandomBytes(kPixels * kFrameCount, 16);
+  const std::vector<uint8_t> rgb888 = RandomBytes(kPixels * 3 * kFrameCount);
+  std::vector<uint16_t> rgb565(kPixels * kFrameCount);
+  PixelKernels::Rgb888ToRgb565(rgb888.data(), rgb565.data(), rgb565.size());
+  std::vector<char> text;
+
+  const std::string path = (std::filesystem::temp_directory_path() / "dmdutil-benchmark").string();
+  const std::string zipPath = path + ".zip";
+
+  printf("Dumps 128x32\n");
+  for (bool zip : {false, true})
+  {
+    auto openText = [&](DumpFile& file, FrameDumpWriter&)
+    { zip ? file.OpenZip(zipPath.c_str(), "dump.txt", kZipLevel) : file.Open(path.c_str(), "w"); };
+    const char* suffix = zip ? " zipped" : "";
+    std::string name = std::string("txt") + suffix;
+    BenchmarkDump(name.c_str(), openText,
+                  [&](DumpFile& file, FrameDumpWriter&, uint32_t frame)
+                  {
+                    const uint8_t* pFrame = &indexed[(frame % kFrameCount) * kPixels];
+                    file.Write(text.data(), TextDump::FormatIndexedFrame(text, frame, pFrame, kWidth, kHeight));
+                  });
+    name = std::string("rgb565 txt") + suffix;
+    BenchmarkDump(name.c_str(), openText,
+                  [&](DumpFile& file, FrameDumpWriter&, uint32_t frame)
+                  {
+                    const uint16_t* pFrame = &rgb565[(frame % kFrameCount) * kPixels];
+                    file.Write(text.data(), TextDump::FormatRgb565Frame(text, frame, pFrame, kWidth, kHeight));
+                  });
+    name = std::string("rgb888 txt") + suffix;
+    BenchmarkDump(name.c_str(), openText,
+                  [&](DumpFile& file, FrameDumpWriter&, uint32_t frame)
+                  {
+                    const uint8_t* pFrame = &rgb888[(frame % kFrameCount) * kPixels * 3];
+                    file.Write(text.data(), TextDump::FormatRgb888Frame(text, frame, pFrame, kWidth, kHeight));
+                  });
+    name = std::string("dmdump") + (zip ? " compressed" : "");
+    BenchmarkDump(
+        name.c_str(), [&](DumpFile&, FrameDumpWriter& frameDump) { frameDump.Open(path.c_str(), zip, kZipLevel); },
+        [&](DumpFile&, FrameDumpWriter& frameDump, uint32_t frame)
+        {
+          FrameDumpHeader header;
+          header.timestampMs = frame;
+          header.mode = DMD::Mode::Data;
+          header.depth = 4;
+          header.width = kWidth;
+          header.height = kHeight;
+          frameDump.Write(header, &indexed[(frame % kFrameCount) * kPixels], kPixels, nullptr, 0, nullptr, 0);
+        });
+  }
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+  std::filesystem::remove(zipPath, error);
+}
+}  // namespace
+
+static struct cag_option options[] = {
+    {.identifier = 'c', .access_letters = "c", .access_name = "check", .description = "Only run the checks"},
+    {.identifier = 'd',
+     .access_letters = "d",
+     .access_name = "duration",
+     .value_name = "MS",
+     .description = "Time per benchmark and implementation in ms (default: 200)"},
+    {.identifier = 'h', .access_letters = "h", .access_name = "help", .description = "Show help"}};
+
+int main(int argc, char* argv[])
+{
+  bool checkOnly = false;
+
+  cag_option_context cagContext;
+  cag_option_init(&cagContext, options, CAG_ARRAY_SIZE(options), argc, argv);
+  while (cag_option_fetch(&cagContext))
+  {
+    const char id = cag_option_get_identifier(&cagContext);
+    switch (id)
+    {
+      case 'c':
+        checkOnly = true;
+        break;
+      case 'd':
+      {
+        const char* valueStr = cag_option_get_value(&cagContext);
+        if (valueStr && atoi(valueStr) > 0) s_durationMs = (uint32_t)atoi(valueStr);
+        break;
+      }
+      case 'h':
+        printf("Usage: %s [options]\n", argv[0]);
+        cag_option_print(options, CAG_ARRAY_SIZE(options), stdout);
+        return 0;
+      default:
+        break;
+    }
+  }
+
+  PixelKernels::SetScalarOnly(false);
+  printf("Pixel kernels: %s\n", PixelKernels::GetImplementationName());
+
+  // The selected implementation has to produce exactly the same output as the scalar loops.
+  bool ok = CheckIndexed();
+  ok &= CheckConversions();
+  ok &= CheckQuantize();
+  ok &= CheckHex();
+  printf("Checks %s\n", ok ? "passed" : "FAILED");
+  if (!ok) return 1;
+  if (checkOnly) return 0;
+
+  printf("%-36s %8s %8s %8s\n", "pixels/ns", "scalar", PixelKernels::GetImplementationName(), "speedup");
+  BenchmarkIndexed();
+  BenchmarkConversions();
+  BenchmarkQuantize();
+  BenchmarkDumps();
+
+  return 0;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -6,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "FrameDump.h"
 #include "cargs.h"
 
 namespace
@@ -67,6 +69,73 @@ static bool ParseBoolField(const std::string& object, const char* key, bool& out
   return false;
 }
 
+static uint64_t HashBytesFNV1a64(const uint8_t* bytes, size_t byteCount)
+{
+  uint64_t hash = 1469598103934665603ull;
+  for (size_t i = 0; i < byteCount; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  hash ^= byteCount;
+  hash *= 1099511628211ull;
+  return hash;
+}
+
+// A frame dump (.dmdump) written by the raw dumper. The hash covers the same bytes as the outputHashFNV1a64 of the
+// live JSON dumps of dmdutil-play-dump, so both can be compared.
+static bool LoadFrameDumpFrames(const std::string& path, std::vector<DumpFrame>& outFrames)
+{
+  using Mode = DMDUtil::DMD::Mode;
+
+  DMDUtil::FrameDumpReader reader;
+  if (!reader.Open(path.c_str()))
+  {
+    return false;
+  }
+
+  DMDUtil::FrameDumpFrame dumpFrame;
+  bool previousHasDuration = true;
+  for (uint32_t i = 0; i < reader.GetFrameCount(); ++i)
+  {
+    if (!reader.Read(i, dumpFrame))
+    {
+      return false;
+    }
+
+    const DMDUtil::FrameDumpHeader& header = dumpFrame.header;
+    const size_t pixels = static_cast<size_t>(header.width) * header.height;
+    DumpFrame frame{};
+    frame.index = i;
+    frame.timestampMs = header.timestampMs;
+    frame.width = header.width;
+    frame.height = header.height;
+    if (header.mode == Mode::RGB24)
+    {
+      frame.hash = HashBytesFNV1a64(dumpFrame.data.data(), std::min(dumpFrame.data.size(), pixels * 3));
+    }
+    else if (header.mode == Mode::SerumV1 || header.mode == Mode::Data || header.mode == Mode::NotColorized ||
+             header.mode == Mode::Vni)
+    {
+      frame.hash = HashBytesFNV1a64(dumpFrame.data.data(), std::min(dumpFrame.data.size(), pixels));
+    }
+    else
+    {
+      frame.hash = HashBytesFNV1a64(reinterpret_cast<const uint8_t*>(dumpFrame.segData.data()),
+                                    std::min(dumpFrame.segData.size(), pixels) * sizeof(uint16_t));
+    }
+    // Like inputDurationMs of the live JSON dumps, otherwise the time until the next frame.
+    frame.durationMs = header.frameContext.inputDurationMs;
+    if (!previousHasDuration && frame.timestampMs >= outFrames.back().timestampMs)
+    {
+      outFrames.back().durationMs = frame.timestampMs - outFrames.back().timestampMs;
+    }
+    previousHasDuration = header.frameContext.valid;
+    outFrames.push_back(frame);
+  }
+  return true;
+}
+
 static bool LoadDumpFrames(const std::string& path, std::vector<DumpFrame>& outFrames)
 {
   std::ifstream in(path, std::ios::binary);
@@ -74,6 +143,14 @@ static bool LoadDumpFrames(const std::string& path, std::vector<DumpFrame>& outF
   {
     return false;
   }
+  uint8_t magic[16] = {0};
+  in.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  if (DMDUtil::FrameDumpReader::IsFrameDump(magic, static_cast<size_t>(in.gcount())))
+  {
+    return LoadFrameDumpFrames(path, outFrames);
+  }
+  in.clear();
+  in.seekg(0);
   const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
   size_t pos = 0;
   while (true)
@@ -143,8 +220,8 @@ static bool LoadDumpFrames(const std::string& path, std::vector<DumpFrame>& outF
 }  // namespace
 
 static struct cag_option options[] = {
-    {.identifier = 'e', .access_letters = "e", .access_name = "expected", .value_name = "FILE", .description = "Expected JSON dump"},
-    {.identifier = 'a', .access_letters = "a", .access_name = "actual", .value_name = "FILE", .description = "Actual JSON dump"},
+    {.identifier = 'e', .access_letters = "e", .access_name = "expected", .value_name = "FILE", .description = "Expected JSON or frame dump"},
+    {.identifier = 'a', .access_letters = "a", .access_name = "actual", .value_name = "FILE", .description = "Actual JSON or frame dump"},
     {.identifier = 'm',
      .access_letters = "m",
      .access_name = "max-diffs",
@@ -199,7 +276,7 @@ int main(int argc, char* argv[])
         ignoreTimestamp = true;
         break;
       case 'h':
-        std::cerr << "Usage: " << argv[0] << " --expected A.json --actual B.json [options]\n";
+        std::cerr << "Usage: " << argv[0] << " --expected A.json|A.dmdump --actual B.json|B.dmdump [options]\n";
         cag_option_print(options, CAG_ARRAY_SIZE(options), stdout);
         return 0;
       default:
@@ -217,12 +294,12 @@ int main(int argc, char* argv[])
   std::vector<DumpFrame> actualFrames;
   if (!LoadDumpFrames(expectedPath, expectedFrames))
   {
-    std::cerr << "Error: failed to parse expected JSON dump " << expectedPath << "\n";
+    std::cerr << "Error: failed to read expected dump " << expectedPath << "\n";
     return 2;
   }
   if (!LoadDumpFrames(actualPath, actualFrames))
   {
-    std::cerr << "Error: failed to parse actual JSON dump " << actualPath << "\n";
+    std::cerr << "Error: failed to read actual dump " << actualPath << "\n";
     return 2;
   }
 
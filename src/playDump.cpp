@@ -1,16 +1,21 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <csignal>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -33,9 +38,17 @@
 #include <execinfo.h>
 #include <unistd.h>
 #endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 // clang-format on
 
 #include "DMDUtil/DMDUtil.h"
+#include "FrameDump.h"
+#include "PixelKernels.h"
 #include "cargs.h"
 #include "miniz/miniz.h"
 #include "serum.h"
@@ -127,13 +140,14 @@ enum class InputFormat
 {
   Txt,
   Raw,
+  FrameDump,
   Rgb565,
   Rgb888,
   Zip,
   Unknown
 };
 
-struct Frame
+struct FrameInfo
 {
   uint32_t timestampMs = 0;
   uint32_t originalTimestampMs = 0;
@@ -141,10 +155,23 @@ struct Frame
   uint16_t width = 0;
   uint16_t height = 0;
   FrameFormat format = FrameFormat::Indexed;
+};
+
+struct Frame : FrameInfo
+{
   std::vector<uint8_t> data;
   std::vector<uint16_t> data16;
 };
 
+// Where a frame is stored in the dump, its pixels are decoded on demand.
+struct FrameEntry : FrameInfo
+{
+  // The first row of text dumps, the update of raw dumps, the frame number of frame dumps.
+  size_t offset = 0;
+  // Depth of the txt dump values.
+  uint8_t inDepth = 0;
+};
+
 struct LiveJsonFrameRecord
 {
   uint32_t index = 0;
@@ -247,421 +274,11 @@ static uint8_t ScaleIndex(uint8_t value, uint8_t inDepth, uint8_t outDepth)
 
 static uint8_t QuantizeToDepth(uint8_t r, uint8_t g, uint8_t b, uint8_t depth)
 {
-  int v = (int)(0.2126f * (float)r + 0.7152f * (float)g + 0.0722f * (float)b);
-  if (v > 255) v = 255;
+  const uint8_t v = DMDUtil::PixelKernels::GetLuminance(r, g, b);
   return (depth == 2) ? (uint8_t)(v >> 6) : (uint8_t)(v >> 4);
 }
 
-static bool LoadTxtDumpStream(std::istream& file, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  std::string line;
-  Frame current;
-  bool inFrame = false;
-  uint16_t width = 0;
-  uint16_t height = 0;
-  int maxValue = 0;
-
-  auto finalizeFrame = [&]()
-  {
-    if (!inFrame) return;
-    if (width == 0 || height == 0)
-    {
-      inFrame = false;
-      return;
-    }
-
-    uint8_t inDepth = (maxValue <= 3) ? 2 : 4;
-    if (maxValue > 15)
-    {
-      std::cerr << "Error: Invalid pixel value in txt dump\n";
-      inFrame = false;
-      return;
-    }
-
-    if (inDepth != outDepth)
-    {
-      for (size_t i = 0; i < current.data.size(); ++i)
-      {
-        current.data[i] = ScaleIndex(current.data[i], inDepth, outDepth);
-      }
-    }
-
-    current.width = width;
-    current.height = height;
-    frames.push_back(current);
-    current = Frame();
-    inFrame = false;
-  };
-
-  while (std::getline(file, line))
-  {
-    if (!line.empty() && line.back() == '\r') line.pop_back();
-
-    if (line.empty())
-    {
-      finalizeFrame();
-      width = 0;
-      height = 0;
-      maxValue = 0;
-      continue;
-    }
-
-    if (!inFrame)
-    {
-      if (line.rfind("0x", 0) != 0 && line.rfind("0X", 0) != 0)
-      {
-        continue;
-      }
-      current = Frame();
-      current.timestampMs = (uint32_t)strtoul(line.c_str(), nullptr, 16);
-      current.originalTimestampMs = current.timestampMs;
-      inFrame = true;
-      width = 0;
-      height = 0;
-      maxValue = 0;
-      continue;
-    }
-
-    if (width == 0)
-    {
-      width = (uint16_t)line.size();
-    }
-    else if (line.size() != width)
-    {
-      std::cerr << "Error: Inconsistent line width in txt dump\n";
-      return false;
-    }
-
-    for (char ch : line)
-    {
-      int value = HexToInt(ch);
-      if (value < 0)
-      {
-        std::cerr << "Error: Invalid hex digit in txt dump\n";
-        return false;
-      }
-      current.data.push_back((uint8_t)value);
-      if (value > maxValue) maxValue = value;
-    }
-    height++;
-  }
-
-  finalizeFrame();
-
-  if (frames.empty())
-  {
-    std::cerr << "Error: No frames found in txt dump\n";
-    return false;
-  }
-
-  return true;
-}
-
-static bool LoadTxtDump(const std::string& path, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  std::ifstream file(path);
-  if (!file)
-  {
-    std::cerr << "Error: Unable to open input file: " << path << "\n";
-    return false;
-  }
-
-  return LoadTxtDumpStream(file, outDepth, frames);
-}
-
-static bool ParseHexUint16(const std::string& line, size_t pos, uint16_t& value)
-{
-  if (pos + 4 > line.size()) return false;
-  int h0 = HexToInt(line[pos]);
-  int h1 = HexToInt(line[pos + 1]);
-  int h2 = HexToInt(line[pos + 2]);
-  int h3 = HexToInt(line[pos + 3]);
-  if (h0 < 0 || h1 < 0 || h2 < 0 || h3 < 0) return false;
-  value = (uint16_t)((h0 << 12) | (h1 << 8) | (h2 << 4) | h3);
-  return true;
-}
-
-static bool ParseHexRgb24(const std::string& line, size_t pos, uint8_t& r, uint8_t& g, uint8_t& b)
-{
-  if (pos + 6 > line.size()) return false;
-  int h0 = HexToInt(line[pos]);
-  int h1 = HexToInt(line[pos + 1]);
-  int h2 = HexToInt(line[pos + 2]);
-  int h3 = HexToInt(line[pos + 3]);
-  int h4 = HexToInt(line[pos + 4]);
-  int h5 = HexToInt(line[pos + 5]);
-  if (h0 < 0 || h1 < 0 || h2 < 0 || h3 < 0 || h4 < 0 || h5 < 0) return false;
-  r = (uint8_t)((h0 << 4) | h1);
-  g = (uint8_t)((h2 << 4) | h3);
-  b = (uint8_t)((h4 << 4) | h5);
-  return true;
-}
-
-static bool LoadRgb565DumpStream(std::istream& file, uint8_t outDepth, std::vector<Frame>& frames,
-                                 bool strictMode = true)
-{
-  (void)outDepth;
-  std::string line;
-  Frame current;
-  bool inFrame = false;
-  uint16_t width = 0;
-  uint16_t height = 0;
-
-  auto finalizeFrame = [&]()
-  {
-    if (!inFrame) return;
-    if (width == 0 || height == 0)
-    {
-      inFrame = false;
-      return;
-    }
-
-    current.width = width;
-    current.height = height;
-    current.format = FrameFormat::RGB565;
-    frames.push_back(current);
-    current = Frame();
-    inFrame = false;
-  };
-
-  while (std::getline(file, line))
-  {
-    if (!line.empty() && line.back() == '\r') line.pop_back();
-
-    if (line.empty())
-    {
-      finalizeFrame();
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    if (!inFrame)
-    {
-      if (line.rfind("0x", 0) != 0 && line.rfind("0X", 0) != 0)
-      {
-        continue;
-      }
-      current = Frame();
-      current.timestampMs = (uint32_t)strtoul(line.c_str(), nullptr, 16);
-      current.originalTimestampMs = current.timestampMs;
-      inFrame = true;
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    // Recover when a new timestamp header appears without a separating blank line.
-    if (line.rfind("0x", 0) == 0 || line.rfind("0X", 0) == 0)
-    {
-      if (strictMode)
-      {
-        std::cerr << "Error: Missing blank separator in rgb565 dump\n";
-        return false;
-      }
-      finalizeFrame();
-      current = Frame();
-      current.timestampMs = (uint32_t)strtoul(line.c_str(), nullptr, 16);
-      current.originalTimestampMs = current.timestampMs;
-      inFrame = true;
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    if ((line.size() % 4) != 0)
-    {
-      if (strictMode)
-      {
-        std::cerr << "Error: Invalid line width in rgb565 dump\n";
-        return false;
-      }
-      // Drop malformed frame and wait for next frame separator/header.
-      current = Frame();
-      inFrame = false;
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    uint16_t lineWidth = (uint16_t)(line.size() / 4);
-    if (width == 0)
-    {
-      width = lineWidth;
-    }
-    else if (lineWidth != width)
-    {
-      if (strictMode)
-      {
-        std::cerr << "Error: Inconsistent line width in rgb565 dump\n";
-        return false;
-      }
-      current = Frame();
-      inFrame = false;
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    for (size_t pos = 0; pos < line.size(); pos += 4)
-    {
-      uint16_t value = 0;
-      if (!ParseHexUint16(line, pos, value))
-      {
-        if (strictMode)
-        {
-          std::cerr << "Error: Invalid hex digit in rgb565 dump\n";
-          return false;
-        }
-        current = Frame();
-        inFrame = false;
-        width = 0;
-        height = 0;
-        break;
-      }
-      current.data16.push_back(value);
-    }
-    if (!inFrame)
-    {
-      continue;
-    }
-    height++;
-  }
-
-  finalizeFrame();
-
-  if (frames.empty())
-  {
-    std::cerr << "Error: No frames found in rgb565 dump\n";
-    return false;
-  }
-
-  return true;
-}
-
-static bool LoadRgb565Dump(const std::string& path, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  std::ifstream file(path);
-  if (!file)
-  {
-    std::cerr << "Error: Unable to open input file: " << path << "\n";
-    return false;
-  }
-
-  return LoadRgb565DumpStream(file, outDepth, frames);
-}
-
-static bool LoadRgb888DumpStream(std::istream& file, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  (void)outDepth;
-  std::string line;
-  Frame current;
-  bool inFrame = false;
-  uint16_t width = 0;
-  uint16_t height = 0;
-
-  auto finalizeFrame = [&]()
-  {
-    if (!inFrame) return;
-    if (width == 0 || height == 0)
-    {
-      inFrame = false;
-      return;
-    }
-
-    current.width = width;
-    current.height = height;
-    current.format = FrameFormat::RGB888;
-    frames.push_back(current);
-    current = Frame();
-    inFrame = false;
-  };
-
-  while (std::getline(file, line))
-  {
-    if (!line.empty() && line.back() == '\r') line.pop_back();
-
-    if (line.empty())
-    {
-      finalizeFrame();
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    if (!inFrame)
-    {
-      if (line.rfind("0x", 0) != 0 && line.rfind("0X", 0) != 0)
-      {
-        continue;
-      }
-      current = Frame();
-      current.timestampMs = (uint32_t)strtoul(line.c_str(), nullptr, 16);
-      current.originalTimestampMs = current.timestampMs;
-      inFrame = true;
-      width = 0;
-      height = 0;
-      continue;
-    }
-
-    if ((line.size() % 6) != 0)
-    {
-      std::cerr << "Error: Invalid line width in rgb888 dump\n";
-      return false;
-    }
-
-    uint16_t lineWidth = (uint16_t)(line.size() / 6);
-    if (width == 0)
-    {
-      width = lineWidth;
-    }
-    else if (lineWidth != width)
-    {
-      std::cerr << "Error: Inconsistent line width in rgb888 dump\n";
-      return false;
-    }
-
-    for (size_t pos = 0; pos < line.size(); pos += 6)
-    {
-      uint8_t r = 0;
-      uint8_t g = 0;
-      uint8_t b = 0;
-      if (!ParseHexRgb24(line, pos, r, g, b))
-      {
-        std::cerr << "Error: Invalid hex digit in rgb888 dump\n";
-        return false;
-      }
-      current.data.push_back(r);
-      current.data.push_back(g);
-      current.data.push_back(b);
-    }
-    height++;
-  }
-
-  finalizeFrame();
-
-  if (frames.empty())
-  {
-    std::cerr << "Error: No frames found in rgb888 dump\n";
-    return false;
-  }
-
-  return true;
-}
-
-static bool LoadRgb888Dump(const std::string& path, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  std::ifstream file(path);
-  if (!file)
-  {
-    std::cerr << "Error: Unable to open input file: " << path << "\n";
-    return false;
-  }
-
-  return LoadRgb888DumpStream(file, outDepth, frames);
-}
-
-static void FinalizeFrameDurations(std::vector<Frame>& frames)
+static void FinalizeFrameDurations(std::vector<FrameEntry>& frames)
 {
   if (frames.empty()) return;
 
@@ -678,7 +295,7 @@ static void FinalizeFrameDurations(std::vector<Frame>& frames)
   if (!monotonic)
   {
     uint32_t accumulated = 0;
-    for (Frame& frame : frames)
+    for (FrameEntry& frame : frames)
     {
       frame.durationMs = frame.timestampMs;
       frame.originalTimestampMs = accumulated;
@@ -702,6 +319,32 @@ static void FinalizeFrameDurations(std::vector<Frame>& frames)
   frames.back().originalTimestampMs = frames.back().timestampMs;
 }
 
+// The checks of ConvertUpdateToIndexed, so frames can be indexed without converting them.
+static bool CanConvertUpdate(DMDUtil::DMD::Mode mode, bool hasData, int depth, uint16_t width, uint16_t height)
+{
+  using Mode = DMDUtil::DMD::Mode;
+  if (width == 0 || height == 0) return false;
+
+  switch (mode)
+  {
+    case Mode::Data:
+    case Mode::NotColorized:
+    case Mode::SerumV1:
+    case Mode::Vni:
+      return hasData && depth > 0 && depth <= 8;
+    case Mode::RGB24:
+      return hasData;
+    case Mode::RGB16:
+    case Mode::SerumV2_32:
+    case Mode::SerumV2_32_64:
+    case Mode::SerumV2_64:
+    case Mode::SerumV2_64_32:
+      return true;
+    default:
+      return false;
+  }
+}
+
 static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t outDepth, Frame& frame)
 {
   using Mode = DMDUtil::DMD::Mode;
@@ -709,7 +352,7 @@ static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t o
   frame.height = update.height;
   frame.format = FrameFormat::Indexed;
   frame.data16.clear();
-  if (frame.width == 0 || frame.height == 0) return false;
+  if (!CanConvertUpdate(update.mode, update.hasData, update.depth, update.width, update.height)) return false;
 
   const int length = (int)frame.width * frame.height;
   frame.data.assign(length, 0);
@@ -719,9 +362,7 @@ static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t o
     case Mode::Data:
     case Mode::NotColorized:
     {
-      if (!update.hasData) return false;
       uint8_t inDepth = (uint8_t)update.depth;
-      if (inDepth == 0 || inDepth > 8) return false;
       for (int i = 0; i < length; ++i)
       {
         frame.data[i] = ScaleIndex(update.data[i], inDepth, outDepth);
@@ -730,7 +371,6 @@ static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t o
     }
     case Mode::RGB24:
     {
-      if (!update.hasData) return false;
       for (int i = 0; i < length; ++i)
       {
         int pos = i * 3;
@@ -741,32 +381,10 @@ static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t o
       }
       return true;
     }
-    case Mode::RGB16:
-    case Mode::SerumV2_32:
-    case Mode::SerumV2_32_64:
-    case Mode::SerumV2_64:
-    case Mode::SerumV2_64_32:
-    {
-      const uint16_t* src = update.segData;
-      for (int i = 0; i < length; ++i)
-      {
-        uint16_t value = src[i];
-        uint8_t r = (uint8_t)((value >> 11) & 0x1F);
-        uint8_t g = (uint8_t)((value >> 5) & 0x3F);
-        uint8_t b = (uint8_t)(value & 0x1F);
-        r = (uint8_t)((r << 3) | (r >> 2));
-        g = (uint8_t)((g << 2) | (g >> 4));
-        b = (uint8_t)((b << 3) | (b >> 2));
-        frame.data[i] = QuantizeToDepth(r, g, b, outDepth);
-      }
-      return true;
-    }
     case Mode::SerumV1:
     case Mode::Vni:
     {
-      if (!update.hasData) return false;
       uint8_t inDepth = (uint8_t)update.depth;
-      if (inDepth == 0 || inDepth > 8) return false;
       int colors = 1 << inDepth;
       const uint8_t* palette = reinterpret_cast<const uint8_t*>(update.segData);
       for (int i = 0; i < length; ++i)
@@ -782,114 +400,197 @@ static bool ConvertUpdateToIndexed(const DMDUtil::DMD::Update& update, uint8_t o
       return true;
     }
     default:
-      return false;
+    {
+      // RGB16 and Serum v2.
+      const uint16_t* src = update.segData;
+      for (int i = 0; i < length; ++i)
+      {
+        uint16_t value = src[i];
+        uint8_t r = (uint8_t)((value >> 11) & 0x1F);
+        uint8_t g = (uint8_t)((value >> 5) & 0x3F);
+        uint8_t b = (uint8_t)(value & 0x1F);
+        r = (uint8_t)((r << 3) | (r >> 2));
+        g = (uint8_t)((g << 2) | (g >> 4));
+        b = (uint8_t)((b << 3) | (b >> 2));
+        frame.data[i] = QuantizeToDepth(r, g, b, outDepth);
+      }
+      return true;
+    }
   }
 }
 
-static bool LoadRawDump(const std::string& path, uint8_t outDepth, std::vector<Frame>& frames)
+static bool FitsIntoUpdate(size_t dataSize, size_t segDataSize, size_t segData2Size)
 {
-  std::ifstream file(path, std::ios::binary);
-  if (!file)
-  {
-    std::cerr << "Error: Unable to open input file: " << path << "\n";
-    return false;
-  }
+  using Update = DMDUtil::DMD::Update;
+  return dataSize <= sizeof(Update::data) && segDataSize <= sizeof(Update::segData) / sizeof(uint16_t) &&
+         segData2Size <= sizeof(Update::segData2) / sizeof(uint16_t);
+}
 
-  while (true)
-  {
-    uint32_t timestamp = 0;
-    uint32_t size = 0;
-    if (!file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp))) break;
-    if (!file.read(reinterpret_cast<char*>(&size), sizeof(size))) break;
+static InputFormat DetectFormatFromName(const std::string& name)
+{
+  if (EndsWithCaseInsensitive(name, ".565.txt")) return InputFormat::Rgb565;
+  if (EndsWithCaseInsensitive(name, ".888.txt")) return InputFormat::Rgb888;
+  if (EndsWithCaseInsensitive(name, ".raw")) return InputFormat::Raw;
+  if (EndsWithCaseInsensitive(name, ".txt")) return InputFormat::Txt;
+  return InputFormat::Unknown;
+}
 
-    if (size < sizeof(DMDUtil::DMD::Update))
-    {
-      std::cerr << "Error: Raw dump frame size is too small\n";
-      return false;
-    }
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+ public:
+  MappedFile() {}
+  ~MappedFile() { Close(); }
 
-    std::vector<uint8_t> buffer(size);
-    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) break;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
 
-    DMDUtil::DMD::Update update;
-    memcpy(&update, buffer.data(), sizeof(update));
+  bool Open(const std::string& path);
+  void Close();
+  const uint8_t* GetData() const { return m_pData; }
+  size_t GetSize() const { return m_size; }
 
-    Frame frame;
-    frame.timestampMs = timestamp;
-    frame.originalTimestampMs = timestamp;
-    if (ConvertUpdateToIndexed(update, outDepth, frame))
-    {
-      frames.push_back(std::move(frame));
-    }
-  }
+ private:
+  const uint8_t* m_pData = nullptr;
+  size_t m_size = 0;
+#if defined(_WIN32)
+  HANDLE m_hMapping = nullptr;
+#endif
+};
 
-  if (frames.empty())
+bool MappedFile::Open(const std::string& path)
+{
+  Close();
+
+#if defined(_WIN32)
+  HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (hFile == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(hFile, &size) || (uint64_t)size.QuadPart > std::numeric_limits<size_t>::max())
   {
-    std::cerr << "Error: No frames found in raw dump\n";
+    CloseHandle(hFile);
     return false;
   }
-
-  return true;
-}
-
-static bool LoadRawDumpFromBuffer(const uint8_t* data, size_t size, uint8_t outDepth, std::vector<Frame>& frames)
-{
-  size_t offset = 0;
-  while (offset + sizeof(uint32_t) * 2 <= size)
+  m_size = (size_t)size.QuadPart;
+  if (m_size > 0)
   {
-    uint32_t timestamp = 0;
-    uint32_t frameSize = 0;
-    memcpy(&timestamp, data + offset, sizeof(timestamp));
-    offset += sizeof(timestamp);
-    memcpy(&frameSize, data + offset, sizeof(frameSize));
-    offset += sizeof(frameSize);
-
-    if (frameSize < sizeof(DMDUtil::DMD::Update))
-    {
-      std::cerr << "Error: Raw dump frame size is too small\n";
-      return false;
-    }
-
-    if (offset + frameSize > size)
-    {
-      break;
-    }
-
-    std::vector<uint8_t> buffer(frameSize);
-    memcpy(buffer.data(), data + offset, frameSize);
-    offset += frameSize;
-
-    DMDUtil::DMD::Update update;
-    memcpy(&update, buffer.data(), sizeof(update));
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping) m_pData = (const uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  CloseHandle(hFile);
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
 
-    Frame frame;
-    frame.timestampMs = timestamp;
-    frame.originalTimestampMs = timestamp;
-    if (ConvertUpdateToIndexed(update, outDepth, frame))
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (uint64_t)st.st_size > std::numeric_limits<size_t>::max())
+  {
+    close(fd);
+    return false;
+  }
+  m_size = (size_t)st.st_size;
+  if (m_size > 0)
+  {
+    void* pData = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pData != MAP_FAILED)
     {
-      frames.push_back(std::move(frame));
+      // Playback reads the frames in order.
+      madvise(pData, m_size, MADV_SEQUENTIAL);
+      m_pData = (const uint8_t*)pData;
     }
   }
+  close(fd);
+#endif
 
-  if (frames.empty())
+  if (m_size > 0 && !m_pData)
   {
-    std::cerr << "Error: No frames found in raw dump\n";
+    Close();
     return false;
   }
-
   return true;
 }
 
-static InputFormat DetectFormatFromName(const std::string& name)
+void MappedFile::Close()
 {
-  if (EndsWithCaseInsensitive(name, ".565.txt")) return InputFormat::Rgb565;
-  if (EndsWithCaseInsensitive(name, ".888.txt")) return InputFormat::Rgb888;
-  if (EndsWithCaseInsensitive(name, ".raw")) return InputFormat::Raw;
-  if (EndsWithCaseInsensitive(name, ".txt")) return InputFormat::Txt;
-  return InputFormat::Unknown;
+#if defined(_WIN32)
+  if (m_pData) UnmapViewOfFile(m_pData);
+  if (m_hMapping) CloseHandle(m_hMapping);
+  m_hMapping = nullptr;
+#else
+  if (m_pData) munmap((void*)m_pData, m_size);
+#endif
+  m_pData = nullptr;
+  m_size = 0;
+}
+
+// Maps a dump and indexes its frames in one pass, the pixels are only decoded when a frame is needed. Zip entries are
+// extracted to memory first. Decode() must not be called by more than one thread at a time.
+class DumpFrameSource
+{
+ public:
+  DumpFrameSource() {}
+
+  // Text dumps that are not strict skip malformed frames instead of failing.
+  bool Open(const std::string& path, InputFormat format, uint8_t outDepth, bool strictMode = true);
+  std::vector<FrameEntry>& GetEntries() { return m_entries; }
+  bool Decode(size_t index, Frame& frame);
+
+ private:
+  bool OpenZip(const std::string& path, bool strictMode);
+  bool Index(InputFormat format, bool strictMode);
+  bool IndexText(FrameFormat format, bool strictMode);
+  bool IndexRaw();
+  bool IndexFrameDump();
+  void DecodeText(const FrameEntry& entry, Frame& frame) const;
+  bool FillUpdateFromFrameDump();
+
+  InputFormat m_format = InputFormat::Unknown;
+  uint8_t m_outDepth = 2;
+  MappedFile m_file;
+  std::vector<uint8_t> m_buffer;
+  const uint8_t* m_pData = nullptr;
+  size_t m_size = 0;
+  DMDUtil::FrameDumpReader m_reader;
+  DMDUtil::FrameDumpFrame m_dumpFrame;
+  std::unique_ptr<DMDUtil::DMD::Update> m_pUpdate;
+  std::vector<FrameEntry> m_entries;
+};
+
+bool DumpFrameSource::Open(const std::string& path, InputFormat format, uint8_t outDepth, bool strictMode)
+{
+  m_outDepth = outDepth;
+  m_entries.clear();
+  if (!m_pUpdate) m_pUpdate = std::make_unique<DMDUtil::DMD::Update>();
+
+  if (format == InputFormat::Zip)
+  {
+    return OpenZip(path, strictMode);
+  }
+
+  if (format == InputFormat::FrameDump)
+  {
+    m_format = format;
+    if (!m_reader.Open(path.c_str()))
+    {
+      std::cerr << "Error: Unable to open frame dump: " << path << "\n";
+      return false;
+    }
+    return IndexFrameDump();
+  }
+
+  if (!m_file.Open(path))
+  {
+    std::cerr << "Error: Unable to open input file: " << path << "\n";
+    return false;
+  }
+  m_pData = m_file.GetData();
+  m_size = m_file.GetSize();
+  return Index(format, strictMode);
 }
 
-static bool LoadZipDump(const std::string& path, uint8_t outDepth, std::vector<Frame>& frames)
+bool DumpFrameSource::OpenZip(const std::string& path, bool strictMode)
 {
   mz_zip_archive zip;
   mz_zip_zero_struct(&zip);
@@ -977,8 +678,8 @@ static bool LoadZipDump(const std::string& path, uint8_t outDepth, std::vector<F
     return false;
   }
 
-  std::vector<uint8_t> buffer(static_cast<size_t>(stat.m_uncomp_size));
-  if (!mz_zip_reader_extract_to_mem(&zip, (mz_uint)bestIndex, buffer.data(), buffer.size(), 0))
+  m_buffer.resize(static_cast<size_t>(stat.m_uncomp_size));
+  if (!mz_zip_reader_extract_to_mem(&zip, (mz_uint)bestIndex, m_buffer.data(), m_buffer.size(), 0))
   {
     mz_zip_reader_end(&zip);
     std::cerr << "Error: Unable to extract zip entry\n";
@@ -990,32 +691,441 @@ static bool LoadZipDump(const std::string& path, uint8_t outDepth, std::vector<F
     bestFormat = DetectFormatFromName(stat.m_filename);
   }
 
-  bool ok = false;
-  if (bestFormat == InputFormat::Rgb565)
+  mz_zip_reader_end(&zip);
+  m_pData = m_buffer.data();
+  m_size = m_buffer.size();
+  return Index(bestFormat, strictMode);
+}
+
+bool DumpFrameSource::Index(InputFormat format, bool strictMode)
+{
+  switch (format)
+  {
+    case InputFormat::Raw:
+      m_format = InputFormat::Raw;
+      return IndexRaw();
+    case InputFormat::Rgb565:
+      m_format = InputFormat::Rgb565;
+      return IndexText(FrameFormat::RGB565, strictMode);
+    case InputFormat::Rgb888:
+      m_format = InputFormat::Rgb888;
+      return IndexText(FrameFormat::RGB888, strictMode);
+    default:
+      m_format = InputFormat::Txt;
+      return IndexText(FrameFormat::Indexed, strictMode);
+  }
+}
+
+bool DumpFrameSource::IndexText(FrameFormat format, bool strictMode)
+{
+  const char* name = (format == FrameFormat::RGB565) ? "rgb565" : (format == FrameFormat::RGB888) ? "rgb888" : "txt";
+  const size_t charsPerPixel = (format == FrameFormat::RGB565) ? 4 : (format == FrameFormat::RGB888) ? 6 : 1;
+  const char* pText = reinterpret_cast<const char*>(m_pData);
+  FrameEntry current;
+  bool inFrame = false;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  int maxValue = 0;
+  size_t pos = 0;
+
+  auto finalizeFrame = [&]()
+  {
+    if (!inFrame) return;
+    inFrame = false;
+    if (width == 0 || height == 0) return;
+
+    current.width = width;
+    current.height = height;
+    current.format = format;
+    current.inDepth = (maxValue <= 3) ? 2 : 4;
+    m_entries.push_back(current);
+  };
+
+  // The rows of the frame start at the line after the header.
+  auto startFrame = [&](const char* pLine, size_t length)
+  {
+    current = FrameEntry();
+    current.timestampMs = (uint32_t)strtoul(std::string(pLine, length).c_str(), nullptr, 16);
+    current.originalTimestampMs = current.timestampMs;
+    current.offset = pos;
+    inFrame = true;
+    width = 0;
+    height = 0;
+    maxValue = 0;
+  };
+
+  auto dropFrame = [&]()
+  {
+    inFrame = false;
+    width = 0;
+    height = 0;
+  };
+
+  while (pos < m_size)
+  {
+    const char* pLine = pText + pos;
+    const char* pEnd = static_cast<const char*>(memchr(pLine, '\n', m_size - pos));
+    size_t length = pEnd ? (size_t)(pEnd - pLine) : m_size - pos;
+    pos += pEnd ? length + 1 : length;
+    if (length > 0 && pLine[length - 1] == '\r') length--;
+
+    if (length == 0)
+    {
+      finalizeFrame();
+      width = 0;
+      height = 0;
+      maxValue = 0;
+      continue;
+    }
+
+    const bool header = length >= 2 && pLine[0] == '0' && (pLine[1] == 'x' || pLine[1] == 'X');
+    if (!inFrame)
+    {
+      if (header) startFrame(pLine, length);
+      continue;
+    }
+
+    // Recover when a new timestamp header appears without a separating blank line.
+    if (format == FrameFormat::RGB565 && header)
+    {
+      if (strictMode)
+      {
+        std::cerr << "Error: Missing blank separator in rgb565 dump\n";
+        return false;
+      }
+      finalizeFrame();
+      startFrame(pLine, length);
+      continue;
+    }
+
+    if ((length % charsPerPixel) != 0)
+    {
+      if (strictMode)
+      {
+        std::cerr << "Error: Invalid line width in " << name << " dump\n";
+        return false;
+      }
+      // Drop malformed frame and wait for next frame separator/header.
+      dropFrame();
+      continue;
+    }
+
+    uint16_t lineWidth = (uint16_t)(length / charsPerPixel);
+    if (width == 0)
+    {
+      width = lineWidth;
+    }
+    else if (lineWidth != width)
+    {
+      if (strictMode)
+      {
+        std::cerr << "Error: Inconsistent line width in " << name << " dump\n";
+        return false;
+      }
+      dropFrame();
+      continue;
+    }
+
+    for (size_t i = 0; i < length; ++i)
+    {
+      int value = HexToInt(pLine[i]);
+      if (value < 0)
+      {
+        if (strictMode)
+        {
+          std::cerr << "Error: Invalid hex digit in " << name << " dump\n";
+          return false;
+        }
+        dropFrame();
+        break;
+      }
+      if (value > maxValue) maxValue = value;
+    }
+    if (!inFrame)
+    {
+      continue;
+    }
+    height++;
+  }
+
+  finalizeFrame();
+
+  if (m_entries.empty())
+  {
+    std::cerr << "Error: No frames found in " << name << " dump\n";
+    return false;
+  }
+
+  return true;
+}
+
+bool DumpFrameSource::IndexRaw()
+{
+  using Update = DMDUtil::DMD::Update;
+  size_t offset = 0;
+  while (offset + sizeof(uint32_t) * 2 <= m_size)
+  {
+    uint32_t timestamp = 0;
+    uint32_t frameSize = 0;
+    memcpy(&timestamp, m_pData + offset, sizeof(timestamp));
+    offset += sizeof(timestamp);
+    memcpy(&frameSize, m_pData + offset, sizeof(frameSize));
+    offset += sizeof(frameSize);
+
+    if (frameSize < sizeof(Update))
+    {
+      std::cerr << "Error: Raw dump frame size is too small\n";
+      return false;
+    }
+
+    if (frameSize > m_size - offset)
+    {
+      break;
+    }
+
+    // Only the header fields are read here, the update is copied when the frame is decoded.
+    const uint8_t* pUpdate = m_pData + offset;
+    DMDUtil::DMD::Mode mode;
+    int depth = 0;
+    uint8_t hasData = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    memcpy(&mode, pUpdate + offsetof(Update, mode), sizeof(mode));
+    memcpy(&depth, pUpdate + offsetof(Update, depth), sizeof(depth));
+    memcpy(&hasData, pUpdate + offsetof(Update, hasData), sizeof(hasData));
+    memcpy(&width, pUpdate + offsetof(Update, width), sizeof(width));
+    memcpy(&height, pUpdate + offsetof(Update, height), sizeof(height));
+
+    if (CanConvertUpdate(mode, hasData != 0, depth, width, height))
+    {
+      FrameEntry entry;
+      entry.timestampMs = timestamp;
+      entry.originalTimestampMs = timestamp;
+      entry.width = width;
+      entry.height = height;
+      entry.offset = offset;
+      m_entries.push_back(entry);
+    }
+    offset += frameSize;
+  }
+
+  if (m_entries.empty())
   {
-    std::string content(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    std::istringstream stream(content);
-    ok = LoadRgb565DumpStream(stream, outDepth, frames);
+    std::cerr << "Error: No frames found in raw dump\n";
+    return false;
   }
-  else if (bestFormat == InputFormat::Rgb888)
+
+  return true;
+}
+
+bool DumpFrameSource::IndexFrameDump()
+{
+  // Dumps since version 2 list the frames in their index, older ones are inflated block by block.
+  const uint32_t frameCount = m_reader.GetFrameCount();
+  DMDUtil::FrameDumpInfo info;
+  for (uint32_t i = 0; i < frameCount; ++i)
   {
-    std::string content(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    std::istringstream stream(content);
-    ok = LoadRgb888DumpStream(stream, outDepth, frames);
+    if (!m_reader.ReadInfo(i, info))
+    {
+      std::cerr << "Error: Frame dump is corrupt at frame " << i << "\n";
+      break;
+    }
+
+    if (!FitsIntoUpdate(info.dataSize, info.segDataSize, info.segData2Size) ||
+        !CanConvertUpdate(info.mode, info.hasData, info.depth, info.width, info.height))
+    {
+      continue;
+    }
+
+    FrameEntry entry;
+    entry.timestampMs = info.timestampMs;
+    entry.originalTimestampMs = info.timestampMs;
+    entry.width = info.width;
+    entry.height = info.height;
+    entry.offset = i;
+    m_entries.push_back(entry);
   }
-  else if (bestFormat == InputFormat::Raw)
+
+  if (m_entries.empty())
   {
-    ok = LoadRawDumpFromBuffer(buffer.data(), buffer.size(), outDepth, frames);
+    std::cerr << "Error: No frames found in frame dump\n";
+    return false;
   }
+
+  return true;
+}
+
+bool DumpFrameSource::FillUpdateFromFrameDump()
+{
+  if (!FitsIntoUpdate(m_dumpFrame.data.size(), m_dumpFrame.segData.size(), m_dumpFrame.segData2.size()))
+    return false;
+
+  const DMDUtil::FrameDumpHeader& header = m_dumpFrame.header;
+  DMDUtil::DMD::Update* update = m_pUpdate.get();
+  update->mode = header.mode;
+  update->layout = header.layout;
+  update->depth = header.depth;
+  update->width = header.width;
+  update->height = header.height;
+  update->r = header.r;
+  update->g = header.g;
+  update->b = header.b;
+  update->hasData = m_dumpFrame.hasData;
+  update->hasSegData = m_dumpFrame.hasSegData;
+  update->hasSegData2 = m_dumpFrame.hasSegData2;
+  memcpy(update->data, m_dumpFrame.data.data(), m_dumpFrame.data.size());
+  memcpy(update->segData, m_dumpFrame.segData.data(), m_dumpFrame.segData.size() * sizeof(uint16_t));
+  memcpy(update->segData2, m_dumpFrame.segData2.data(), m_dumpFrame.segData2.size() * sizeof(uint16_t));
+  return true;
+}
+
+void DumpFrameSource::DecodeText(const FrameEntry& entry, Frame& frame) const
+{
+  const char* pText = reinterpret_cast<const char*>(m_pData);
+  const size_t pixels = (size_t)entry.width * entry.height;
+  if (entry.format == FrameFormat::RGB565)
+    frame.data16.resize(pixels);
   else
+    frame.data.resize(entry.format == FrameFormat::RGB888 ? pixels * 3 : pixels);
+
+  // The rows were validated when the dump was indexed.
+  size_t pos = entry.offset;
+  size_t i = 0;
+  for (uint16_t y = 0; y < entry.height; ++y)
   {
-    std::string content(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    std::istringstream stream(content);
-    ok = LoadTxtDumpStream(stream, outDepth, frames);
+    const char* pRow = pText + pos;
+    switch (entry.format)
+    {
+      case FrameFormat::RGB565:
+        for (uint16_t x = 0; x < entry.width; ++x, pRow += 4)
+        {
+          frame.data16[i++] = (uint16_t)((HexToInt(pRow[0]) << 12) | (HexToInt(pRow[1]) << 8) |
+                                         (HexToInt(pRow[2]) << 4) | HexToInt(pRow[3]));
+        }
+        break;
+      case FrameFormat::RGB888:
+        for (size_t x = 0; x < (size_t)entry.width * 3; ++x, pRow += 2)
+        {
+          frame.data[i++] = (uint8_t)((HexToInt(pRow[0]) << 4) | HexToInt(pRow[1]));
+        }
+        break;
+      default:
+        for (uint16_t x = 0; x < entry.width; ++x)
+        {
+          frame.data[i++] = ScaleIndex((uint8_t)HexToInt(pRow[x]), entry.inDepth, m_outDepth);
+        }
+        break;
+    }
+
+    const void* pEnd = memchr(pText + pos, '\n', m_size - pos);
+    pos = pEnd ? (size_t)(static_cast<const char*>(pEnd) - pText) + 1 : m_size;
   }
+}
 
-  mz_zip_reader_end(&zip);
-  return ok;
+bool DumpFrameSource::Decode(size_t index, Frame& frame)
+{
+  if (index >= m_entries.size()) return false;
+
+  const FrameEntry& entry = m_entries[index];
+  static_cast<FrameInfo&>(frame) = entry;
+  frame.data.clear();
+  frame.data16.clear();
+
+  switch (m_format)
+  {
+    case InputFormat::Raw:
+      memcpy(m_pUpdate.get(), m_pData + entry.offset, sizeof(DMDUtil::DMD::Update));
+      return ConvertUpdateToIndexed(*m_pUpdate, m_outDepth, frame);
+    case InputFormat::FrameDump:
+      return m_reader.Read((uint32_t)entry.offset, m_dumpFrame) && FillUpdateFromFrameDump() &&
+             ConvertUpdateToIndexed(*m_pUpdate, m_outDepth, frame);
+    default:
+      DecodeText(entry, frame);
+      return true;
+  }
+}
+
+// Decodes the next frames on a worker thread while the current one is played.
+class FramePrefetcher
+{
+ public:
+  FramePrefetcher(DumpFrameSource& source, size_t window);
+  ~FramePrefetcher() { Stop(); }
+
+  // Returns the frames in order, false once all are taken or if the frame can't be decoded.
+  bool Next(Frame& frame);
+  // Stops the worker, the source may be used directly afterwards.
+  void Stop();
+
+ private:
+  struct Slot
+  {
+    bool decoded = false;
+    Frame frame;
+  };
+
+  void Run();
+
+  DumpFrameSource& m_source;
+  const size_t m_window;
+  const size_t m_count;
+  size_t m_next = 0;
+  size_t m_taken = 0;
+  std::deque<Slot> m_ready;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::thread m_thread;
+};
+
+FramePrefetcher::FramePrefetcher(DumpFrameSource& source, size_t window)
+    : m_source(source), m_window(window), m_count(source.GetEntries().size())
+{
+  m_thread = std::thread(&FramePrefetcher::Run, this);
+}
+
+void FramePrefetcher::Run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_cv.wait(lock, [this]() { return m_stop || (m_next < m_count && m_ready.size() < m_window); });
+    if (m_stop) return;
+
+    const size_t index = m_next++;
+    lock.unlock();
+    Slot slot;
+    slot.decoded = m_source.Decode(index, slot.frame);
+    lock.lock();
+    m_ready.push_back(std::move(slot));
+    m_cv.notify_all();
+  }
+}
+
+bool FramePrefetcher::Next(Frame& frame)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_stop || m_taken >= m_count) return false;
+
+  m_cv.wait(lock, [this]() { return !m_ready.empty(); });
+  Slot slot = std::move(m_ready.front());
+  m_ready.pop_front();
+  ++m_taken;
+  m_cv.notify_all();
+  lock.unlock();
+
+  frame = std::move(slot.frame);
+  return slot.decoded;
+}
+
+void FramePrefetcher::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  if (m_thread.joinable()) m_thread.join();
 }
 
 static bool ParseServer(const std::string& value, std::string& host, int& port)
@@ -1724,7 +1834,7 @@ static bool WriteFilteredTextDump(const std::string& outputPath, const std::vect
   return true;
 }
 
-static uint64_t ComputePlannedSleepMsForFrame(const Frame& frame, bool delaySet, uint32_t delayMs)
+static uint64_t ComputePlannedSleepMsForFrame(const FrameInfo& frame, bool delaySet, uint32_t delayMs)
 {
   if (delaySet)
   {
@@ -1738,10 +1848,10 @@ static uint64_t ComputePlannedSleepMsForFrame(const Frame& frame, bool delaySet,
   return frame.durationMs;
 }
 
-static uint64_t ComputeEstimatedPlaybackMs(const std::vector<Frame>& frames, bool delaySet, uint32_t delayMs)
+static uint64_t ComputeEstimatedPlaybackMs(const std::vector<FrameEntry>& frames, bool delaySet, uint32_t delayMs)
 {
   uint64_t totalMs = 0;
-  for (const Frame& frame : frames)
+  for (const FrameEntry& frame : frames)
   {
     totalMs += ComputePlannedSleepMsForFrame(frame, delaySet, delayMs);
   }
@@ -1820,7 +1930,7 @@ static bool WaitForDumpersToSettle(DMDUtil::DMD& dmd, std::atomic<bool>& stopReq
   return false;
 }
 
-static void SendStartupWarmupFrame(DMDUtil::DMD& dmd, const Frame& frame, uint8_t indexedDepth)
+static void SendStartupWarmupFrame(DMDUtil::DMD& dmd, const FrameInfo& frame, uint8_t indexedDepth)
 {
   const uint32_t timestampMs = 0;
 
@@ -1925,17 +2035,13 @@ static bool WriteJsonDump(const std::string& sourceDumpPath, const std::string&
                           const std::string& inputPath, const std::string& romName)
 {
   uint8_t depth = 2;
-  std::vector<Frame> frames;
-  std::ifstream source(sourceDumpPath);
-  if (!source)
-  {
-    return false;
-  }
-  if (!LoadRgb565DumpStream(source, depth, frames, false))
+  DumpFrameSource source;
+  if (!source.Open(sourceDumpPath, InputFormat::Rgb565, depth, false))
   {
     return false;
   }
-  FinalizeFrameDurations(frames);
+  FinalizeFrameDurations(source.GetEntries());
+  const std::vector<FrameEntry>& frames = source.GetEntries();
 
   std::ofstream out(outputJsonPath, std::ios::binary | std::ios::trunc);
   if (!out)
@@ -1950,9 +2056,13 @@ static bool WriteJsonDump(const std::string& sourceDumpPath, const std::string&
   out << "  \"sourceDump565\": \"" << sourceDumpPath << "\",\n";
   out << "  \"frameCount\": " << frames.size() << ",\n";
   out << "  \"frames\": [\n";
+  Frame frame;
   for (size_t i = 0; i < frames.size(); ++i)
   {
-    const Frame& frame = frames[i];
+    if (!source.Decode(i, frame))
+    {
+      return false;
+    }
     const uint64_t hash = HashFrameRgb565(frame.data16);
     out << "    {\"index\": " << i << ", \"timestampMs\": " << frame.timestampMs
         << ", \"durationMs\": " << frame.durationMs << ", \"width\": " << frame.width
@@ -1971,7 +2081,7 @@ static struct cag_option options[] = {
      .access_letters = "i",
      .access_name = "input",
      .value_name = "FILE",
-     .description = "Input dump file (.txt, .raw, .565.txt, .888.txt, or .zip)"},
+     .description = "Input dump file (.txt, .raw, .dmdump, .565.txt, .888.txt, or .zip)"},
     {.identifier = 'a',
      .access_letters = "a",
      .access_name = "alt-color-path",
@@ -2316,6 +2426,10 @@ int main(int argc, char* argv[])
   {
     format = InputFormat::Raw;
   }
+  else if (EndsWithCaseInsensitive(inputPath, ".dmdump"))
+  {
+    format = InputFormat::FrameDump;
+  }
   else if (EndsWithCaseInsensitive(inputPath, ".565.txt"))
   {
     format = InputFormat::Rgb565;
@@ -2325,40 +2439,18 @@ int main(int argc, char* argv[])
     format = InputFormat::Rgb888;
   }
 
-  std::vector<Frame> frames;
-  switch (format)
-  {
-    case InputFormat::Raw:
-      if (!LoadRawDump(inputPath, opt_depth, frames)) return 1;
-      break;
-    case InputFormat::Rgb565:
-      if (!LoadRgb565Dump(inputPath, opt_depth, frames)) return 1;
-      break;
-    case InputFormat::Rgb888:
-      if (!LoadRgb888Dump(inputPath, opt_depth, frames)) return 1;
-      break;
-    case InputFormat::Zip:
-      if (!LoadZipDump(inputPath, opt_depth, frames)) return 1;
-      break;
-    case InputFormat::Txt:
-    default:
-      if (!LoadTxtDump(inputPath, opt_depth, frames)) return 1;
-      break;
-  }
+  // Only the frame index is loaded, the frames are decoded while they are played.
+  DumpFrameSource source;
+  if (!source.Open(inputPath, format, opt_depth)) return 1;
+  std::vector<FrameEntry>& frames = source.GetEntries();
   FinalizeFrameDurations(frames);
 
-  std::vector<uint64_t> frameInputSignatures;
-  frameInputSignatures.reserve(frames.size());
   std::vector<uint32_t> playbackOriginalIndices;
   playbackOriginalIndices.reserve(frames.size());
   for (size_t i = 0; i < frames.size(); ++i)
   {
     playbackOriginalIndices.push_back(static_cast<uint32_t>(i));
   }
-  for (const Frame& frame : frames)
-  {
-    frameInputSignatures.push_back(HashFrameInputSignature(frame));
-  }
 
   if (!frames.empty() && (opt_start_frame > 0 || opt_end_frame != std::numeric_limits<uint32_t>::max()))
   {
@@ -2369,16 +2461,12 @@ int main(int argc, char* argv[])
     if (startIndex >= endIndexExclusive)
     {
       frames.clear();
-      frameInputSignatures.clear();
       playbackOriginalIndices.clear();
     }
     else
     {
-      frames = std::vector<Frame>(frames.begin() + static_cast<std::ptrdiff_t>(startIndex),
-                                  frames.begin() + static_cast<std::ptrdiff_t>(endIndexExclusive));
-      frameInputSignatures =
-          std::vector<uint64_t>(frameInputSignatures.begin() + static_cast<std::ptrdiff_t>(startIndex),
-                                frameInputSignatures.begin() + static_cast<std::ptrdiff_t>(endIndexExclusive));
+      frames = std::vector<FrameEntry>(frames.begin() + static_cast<std::ptrdiff_t>(startIndex),
+                                       frames.begin() + static_cast<std::ptrdiff_t>(endIndexExclusive));
       playbackOriginalIndices =
           std::vector<uint32_t>(playbackOriginalIndices.begin() + static_cast<std::ptrdiff_t>(startIndex),
                                 playbackOriginalIndices.begin() + static_cast<std::ptrdiff_t>(endIndexExclusive));
@@ -2413,6 +2501,8 @@ int main(int argc, char* argv[])
   }
 
   DMDUtil::Config* config = DMDUtil::Config::GetInstance();
+  // Every frame of the dump has to reach the displays and dumpers.
+  config->SetQueueOverflowPolicy(DMDUtil_QueueOverflowPolicy_Block);
   if (opt_alt_color_path && opt_alt_color_path[0] != '\0')
   {
     config->SetAltColor(true);
@@ -2492,13 +2582,19 @@ int main(int argc, char* argv[])
             << ", estimated duration=" << FormatDurationMs(estimatedPlaybackMs) << "\n";
   auto lastProgressLog = std::chrono::steady_clock::now();
 
+  FramePrefetcher prefetcher(source, 8);
+  Frame frame;
   for (size_t frameIndex = 0; frameIndex < frames.size(); ++frameIndex)
   {
-    const Frame& frame = frames[frameIndex];
     if (g_stopRequested.load(std::memory_order_acquire))
     {
       break;
     }
+    if (!prefetcher.Next(frame))
+    {
+      std::cerr << "Error: Unable to decode frame " << playbackOriginalIndices[frameIndex] << "\n";
+      break;
+    }
 
     const uint32_t queueTimestamp = frame.originalTimestampMs;
     DMDUtil::DMD::FrameContext frameContext;
@@ -2617,6 +2713,8 @@ int main(int argc, char* argv[])
     }
   }
 
+  prefetcher.Stop();
+
   if (g_stopRequested.load(std::memory_order_acquire))
   {
     uint16_t target = dmd.GetUpdateQueuePosition();
@@ -2627,7 +2725,7 @@ int main(int argc, char* argv[])
       if (current == target) break;
       target = current;
     }
-    dmd.WaitForDumpers(target, 2000);
+    dmd.WaitForDumpers(target, 2000, true);
     std::cout << "Playback interrupted by SIGINT after " << playedFramesCount << "/" << totalFramesToPlay
               << " frames\n";
   }
@@ -2649,6 +2747,8 @@ int main(int argc, char* argv[])
     }
     else
     {
+      // The dumpers hand over their last partial buffers only when asked.
+      dmd.WaitForDumpers(dmd.GetUpdateQueuePosition(), 2000, true);
       std::string latestRgb565DumpPath;
       const std::string dumpDir = (opt_dump_path && opt_dump_path[0] != '\0') ? opt_dump_path : ".";
       if (!FindLatestRgb565Dump(dumpDir, romName, latestRgb565DumpPath))
@@ -2671,18 +2771,19 @@ int main(int argc, char* argv[])
 
   if (opt_coverage_json && opt_coverage_json[0] != '\0')
   {
-    std::vector<Frame> coverageFrames;
+    const size_t coverageCount =
+        (playedFramesCount > 0 && playedFramesCount < frames.size()) ? playedFramesCount : frames.size();
+    std::vector<Frame> coverageFrames(coverageCount);
     std::vector<uint64_t> coverageSignatures;
-    if (playedFramesCount > 0 && playedFramesCount < frames.size())
-    {
-      coverageFrames.assign(frames.begin(), frames.begin() + static_cast<std::ptrdiff_t>(playedFramesCount));
-      coverageSignatures.assign(frameInputSignatures.begin(),
-                                frameInputSignatures.begin() + static_cast<std::ptrdiff_t>(playedFramesCount));
-    }
-    else
+    coverageSignatures.reserve(coverageCount);
+    for (size_t i = 0; i < coverageCount; ++i)
     {
-      coverageFrames = frames;
-      coverageSignatures = frameInputSignatures;
+      if (!source.Decode(i, coverageFrames[i]))
+      {
+        std::cerr << "Error: Unable to decode frame " << playbackOriginalIndices[i] << " for coverage export\n";
+        return 1;
+      }
+      coverageSignatures.push_back(HashFrameInputSignature(coverageFrames[i]));
     }
 
     const std::vector<LiveJsonFrameRecord>* coverageLiveFrames = nullptr;
@@ -158,7 +158,7 @@ int main(int argc, char* argv[])
 
   DMDUtil::DMDServer server(pDmd, !altColorPath.empty(), !pupVideosPath.empty());
 
-  if (!server.Start(pConfig->GetDMDServerAddr(), pConfig->GetDMDServerPort()))
+  if (!server.Start(pConfig->GetDMDServerAddr(), pConfig->GetDMDServerPort(), pConfig->GetDMDServerUnixSocket()))
   {
     return 1;
   }